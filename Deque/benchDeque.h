@@ -0,0 +1,166 @@
+/***********************************************************************
+ * Header:
+ *    BENCH DEQUE
+ * Summary:
+ *    Time the deque with a runtime block size, where every index
+ *    splits with a divide, against a compile-time power of two, where
+ *    it splits with a shift and a mask. Build with optimization and
+ *    BENCHMARK defined to run it from the driver.
+ * Author:
+ *    Jacob Mower
+ *    Thatcher Albinston
+ *    Elroe Woldemichael
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "deque.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+class BenchDeque
+{
+public:
+   BenchDeque(int num = 1 << 16, int numRepeat = 20) :
+      num(num), numRepeat(numRepeat), sink(0) {}
+
+   void run()
+   {
+      std::cout << "Deque of int: " << num << " elements\n";
+      std::cout << std::setw(24) << std::left << "operation"
+                << std::setw(12) << std::right << "dynamic ms"
+                << std::setw(12) << "fixed ms"
+                << std::setw(10) << "speedup" << std::endl;
+
+      // the same 16 cells both ways, so only the arithmetic differs
+      compare<custom::deque<int, 16>>("16 cells");
+
+      // and the default block, about 4KB
+      compare<custom::deque<int>>("1024 cells");
+   }
+
+private:
+   typedef custom::deque<int, custom::dynamic_cells> Dynamic;
+
+   template <class Fixed>
+   void compare(const char * cells)
+   {
+      std::cout << cells << std::endl;
+      report("push_back",
+             time([&] { Dynamic d; return pushBack(d); }),
+             time([&] { Fixed   d; return pushBack(d); }));
+      report("push_front",
+             time([&] { Dynamic d; return pushFront(d); }),
+             time([&] { Fixed   d; return pushFront(d); }));
+
+      Dynamic dDynamic;
+      Fixed   dFixed;
+      pushBack(dDynamic);
+      pushBack(dFixed);
+      report("operator []",
+             time([&] { return subscript(dDynamic); }),
+             time([&] { return subscript(dFixed); }));
+      report("iterate",
+             time([&] { return iterate(dDynamic); }),
+             time([&] { return iterate(dFixed); }));
+      report("segments",
+             time([&] { return segments(dDynamic); }),
+             time([&] { return segments(dFixed); }));
+      report("push_back, pop_front",
+             time([&] { Dynamic d; pushBack(d); return popFront(d); }),
+             time([&] { Fixed   d; pushBack(d); return popFront(d); }));
+   }
+
+   template <class Deque>
+   size_t pushBack(Deque & d)
+   {
+      for (int i = 0; i < num; i++)
+         d.push_back(i);
+      return d.size();
+   }
+
+   template <class Deque>
+   size_t pushFront(Deque & d)
+   {
+      for (int i = 0; i < num; i++)
+         d.push_front(i);
+      return d.size();
+   }
+
+   template <class Deque>
+   size_t subscript(Deque & d)
+   {
+      size_t sum = 0;
+      for (int id = 0; id < num; id++)
+         sum += d[id];
+      return sum;
+   }
+
+   template <class Deque>
+   size_t iterate(Deque & d)
+   {
+      size_t sum = 0;
+      for (auto it = d.begin(); it != d.end(); ++it)
+         sum += *it;
+      return sum;
+   }
+
+   template <class Deque>
+   size_t segments(Deque & d)
+   {
+      size_t sum = 0;
+      for (auto seg : d.segments())
+         for (int value : seg)
+            sum += value;
+      return sum;
+   }
+
+   template <class Deque>
+   size_t popFront(Deque & d)
+   {
+      size_t sum = 0;
+      while (!d.empty())
+      {
+         sum += d.front();
+         d.pop_front();
+      }
+      return sum;
+   }
+
+   // milliseconds for one call, best of numRepeat
+   template <class Operation>
+   double time(Operation operation)
+   {
+      double best = 1e30;
+      for (int i = 0; i < numRepeat; i++)
+      {
+         auto begin = std::chrono::steady_clock::now();
+         sink += operation();
+         auto end = std::chrono::steady_clock::now();
+         double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+         if (ms < best)
+            best = ms;
+      }
+      return best;
+   }
+
+   void report(const char * name, double msDynamic, double msFixed)
+   {
+      std::cout << "   " << std::setw(21) << std::left << name << std::right
+                << std::fixed << std::setprecision(3)
+                << std::setw(12) << msDynamic
+                << std::setw(12) << msFixed
+                << std::setprecision(2)
+                << std::setw(9) << msDynamic / msFixed << "x" << std::endl;
+   }
+
+   int num;
+   int numRepeat;
+   size_t sink;      // keeps the optimizer from dropping the work
+};
+
+#endif // BENCHMARK
@@ -0,0 +1,175 @@
+/***********************************************************************
+ * Header:
+ *    BENCH FORK JOIN POOL
+ * Summary:
+ *    How the fork-join pool scales from one worker to one per core, on
+ *    two shapes of work: summing a binary tree by spawning a task per
+ *    subtree, and summing a vector in chunks with parallel_for. Build
+ *    with optimization and BENCHMARK defined to run it from the driver.
+ * Author:
+ *    Jacob Mower
+ *    Thatcher Albinston
+ *    Elroe Woldemichael
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "fork_join_pool.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+class BenchForkJoinPool
+{
+public:
+   BenchForkJoinPool(int depth = 22, size_t num = (size_t)1 << 25, int numRepeat = 5) :
+      depth(depth), num(num), numRepeat(numRepeat), sink(0) {}
+
+   void run()
+   {
+      size_t numCores = custom::fork_join_pool::defaultThreads();
+      std::cout << "Thread pool: tree of depth " << depth << ", "
+                << num << " element vector, 1 to " << numCores << " workers\n";
+      std::cout << std::setw(10) << std::left << "workers" << std::right
+                << std::setw(12) << "tree ms"
+                << std::setw(10) << "speedup"
+                << std::setw(12) << "vector ms"
+                << std::setw(10) << "speedup" << std::endl;
+
+      Node * pRoot = build(depth, 0);
+      std::vector<uint64_t> v(num);
+      for (size_t i = 0; i < num; i++)
+         v[i] = i;
+
+      double msTreeOne = 0.0;
+      double msVectorOne = 0.0;
+      for (size_t numWorkers = 1; numWorkers <= numCores; numWorkers++)
+      {
+         custom::fork_join_pool pool(numWorkers);
+         double msTree = time([&] { return sumTree(pool, pRoot); });
+         double msVector = time([&] { return sumVector(pool, v); });
+         if (numWorkers == 1)
+         {
+            msTreeOne = msTree;
+            msVectorOne = msVector;
+         }
+         report(numWorkers, msTree, msTreeOne / msTree,
+                msVector, msVectorOne / msVector);
+      }
+      destroy(pRoot);
+   }
+
+private:
+   struct Node
+   {
+      Node * pLeft;
+      Node * pRight;
+      uint64_t value;
+   };
+
+   // below this depth a subtree is summed in the task that reached it
+   static const int serialDepth = 10;
+
+   static Node * build(int levels, uint64_t value)
+   {
+      if (levels == 0)
+         return nullptr;
+      return new Node { build(levels - 1, value * 2 + 1),
+                        build(levels - 1, value * 2 + 2), value };
+   }
+
+   static void destroy(Node * pNode)
+   {
+      if (pNode)
+      {
+         destroy(pNode->pLeft);
+         destroy(pNode->pRight);
+         delete pNode;
+      }
+   }
+
+   static uint64_t sumSerial(const Node * pNode)
+   {
+      return pNode ? pNode->value + sumSerial(pNode->pLeft) + sumSerial(pNode->pRight) : 0;
+   }
+
+   // spawn the left subtree, walk the right, join
+   static uint64_t sumParallel(custom::fork_join_pool & pool, const Node * pNode, int level)
+   {
+      if (!pNode)
+         return 0;
+      if (level >= serialDepth)
+         return sumSerial(pNode);
+      uint64_t left = 0;
+      custom::task_group group(pool);
+      group.spawn([&] { left = sumParallel(pool, pNode->pLeft, level + 1); });
+      uint64_t right = sumParallel(pool, pNode->pRight, level + 1);
+      group.join();
+      return pNode->value + left + right;
+   }
+
+   static uint64_t sumTree(custom::fork_join_pool & pool, const Node * pRoot)
+   {
+      uint64_t sum = 0;
+      custom::task_group group(pool);
+      group.spawn([&] { sum = sumParallel(pool, pRoot, 0); });
+      group.join();
+      return sum;
+   }
+
+   static uint64_t sumVector(custom::fork_join_pool & pool, const std::vector<uint64_t> & v)
+   {
+      std::atomic<uint64_t> sum(0);
+      custom::parallel_for(pool, 0, v.size(), [&](size_t begin, size_t end)
+      {
+         uint64_t part = 0;
+         for (size_t i = begin; i < end; i++)
+            part += v[i];
+         sum.fetch_add(part, std::memory_order_relaxed);
+      });
+      return sum.load();
+   }
+
+   // milliseconds for one call, best of numRepeat
+   template <class Operation>
+   double time(Operation operation)
+   {
+      double best = 1e30;
+      for (int i = 0; i < numRepeat; i++)
+      {
+         auto begin = std::chrono::steady_clock::now();
+         sink += operation();
+         auto end = std::chrono::steady_clock::now();
+         double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+         if (ms < best)
+            best = ms;
+      }
+      return best;
+   }
+
+   void report(size_t numWorkers, double msTree, double speedupTree,
+               double msVector, double speedupVector)
+   {
+      std::cout << std::setw(10) << std::left << numWorkers << std::right
+                << std::fixed << std::setprecision(3)
+                << std::setw(12) << msTree
+                << std::setprecision(2)
+                << std::setw(9) << speedupTree << "x"
+                << std::setprecision(3)
+                << std::setw(12) << msVector
+                << std::setprecision(2)
+                << std::setw(9) << speedupVector << "x" << std::endl;
+   }
+
+   int depth;
+   size_t num;
+   int numRepeat;
+   uint64_t sink;    // keeps the optimizer from dropping the work
+};
+
+#endif // BENCHMARK
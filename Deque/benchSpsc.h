@@ -0,0 +1,297 @@
+/***********************************************************************
+ * Header:
+ *    BENCH SPSC
+ * Summary:
+ *    Hand integers from one thread to another through a mutex and a
+ *    deque, through spsc_ring, and through spsc_queue, one at a time
+ *    and in batches. Throughput is messages per second one way;
+ *    latency is half a ping-pong round trip. The two threads are
+ *    pinned to different cores where the platform allows. Build with
+ *    optimization and BENCHMARK defined to run it from the driver.
+ * Author:
+ *    Jacob Mower
+ *    Thatcher Albinston
+ *    Elroe Woldemichael
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "spsc_queue.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+class BenchSpsc
+{
+public:
+   BenchSpsc(size_t num = (size_t)1 << 22, size_t numTrips = (size_t)1 << 16) :
+      num(num), numTrips(numTrips), sink(0) {}
+
+   void run()
+   {
+      std::cout << "SPSC: " << num << " messages, "
+                << numTrips << " round trips\n";
+      std::cout << std::setw(24) << std::left << "channel"
+                << std::setw(14) << std::right << "Mmsg/s"
+                << std::setw(14) << "latency ns" << std::endl;
+
+      report("mutex + deque", throughputMutex(), latencyMutex());
+      report("spsc_ring", throughputRing(1), latencyRing());
+      report("spsc_ring batch 64", throughputRing(64), 0.0);
+      report("spsc_queue", throughputQueue(1), latencyQueue());
+      report("spsc_queue batch 64", throughputQueue(64), 0.0);
+   }
+
+private:
+   typedef std::chrono::steady_clock Clock;
+
+   // keep this thread on one core
+   static void pin(unsigned int cpu)
+   {
+#ifdef __linux__
+      unsigned int numCpu = std::thread::hardware_concurrency();
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(numCpu ? cpu % numCpu : 0, &set);
+      pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+      (void)cpu;
+#endif
+   }
+
+   // run produce on a second thread and consume on this one, in seconds
+   template <class Produce, class Consume>
+   double time(Produce produce, Consume consume)
+   {
+      pin(0);
+      auto begin = Clock::now();
+      std::thread producer([&] { pin(1); produce(); });
+      consume();
+      producer.join();
+      return std::chrono::duration<double>(Clock::now() - begin).count();
+   }
+
+   /***************************************
+    * THROUGHPUT
+    ***************************************/
+
+   double throughputMutex()
+   {
+      std::mutex m;
+      custom::deque<uint64_t> d;
+      double seconds = time([&]
+      {
+         for (uint64_t i = 0; i < num; i++)
+         {
+            std::lock_guard<std::mutex> lock(m);
+            d.push_back(i);
+         }
+      },
+      [&]
+      {
+         for (size_t numPopped = 0; numPopped < num; )
+         {
+            bool got = false;
+            {
+               std::lock_guard<std::mutex> lock(m);
+               if (!d.empty())
+               {
+                  sink += d.front();
+                  d.pop_front();
+                  got = true;
+               }
+            }
+            if (got)
+               numPopped++;
+            else
+               std::this_thread::yield();
+         }
+      });
+      return num / seconds / 1e6;
+   }
+
+   double throughputRing(size_t numBatch)
+   {
+      custom::spsc_ring<uint64_t> r(4096);
+      double seconds = time([&]
+      {
+         uint64_t batch[64];
+         for (uint64_t i = 0; i < num; )
+         {
+            size_t numWant = num - i < numBatch ? num - i : numBatch;
+            for (size_t j = 0; j < numWant; j++)
+               batch[j] = i + j;
+            size_t numPushed = r.push_batch(batch, numWant);
+            if (numPushed == 0)
+               std::this_thread::yield();
+            i += numPushed;
+         }
+      },
+      [&]
+      {
+         uint64_t batch[64];
+         for (size_t numPopped = 0; numPopped < num; )
+         {
+            size_t numGot = r.pop_batch(batch, numBatch);
+            if (numGot == 0)
+               std::this_thread::yield();
+            for (size_t j = 0; j < numGot; j++)
+               sink += batch[j];
+            numPopped += numGot;
+         }
+      });
+      return num / seconds / 1e6;
+   }
+
+   double throughputQueue(size_t numBatch)
+   {
+      custom::spsc_queue<uint64_t> q;
+      double seconds = time([&]
+      {
+         uint64_t batch[64];
+         for (uint64_t i = 0; i < num; i += numBatch)
+         {
+            size_t numWant = num - i < numBatch ? num - i : numBatch;
+            for (size_t j = 0; j < numWant; j++)
+               batch[j] = i + j;
+            q.push_batch(batch, numWant);
+         }
+      },
+      [&]
+      {
+         uint64_t batch[64];
+         for (size_t numPopped = 0; numPopped < num; )
+         {
+            size_t numGot = q.pop_batch(batch, numBatch);
+            if (numGot == 0)
+               std::this_thread::yield();
+            for (size_t j = 0; j < numGot; j++)
+               sink += batch[j];
+            numPopped += numGot;
+         }
+      });
+      return num / seconds / 1e6;
+   }
+
+   /***************************************
+    * LATENCY
+    * The consumer sends each message straight back
+    * on a second channel, and the producer waits for
+    * it before sending the next.
+    ***************************************/
+
+   double latencyMutex()
+   {
+      std::mutex m;
+      custom::deque<uint64_t> dPing;
+      custom::deque<uint64_t> dPong;
+      auto receive = [&](custom::deque<uint64_t> & d)
+      {
+         for (;;)
+         {
+            {
+               std::lock_guard<std::mutex> lock(m);
+               if (!d.empty())
+               {
+                  uint64_t value = d.front();
+                  d.pop_front();
+                  return value;
+               }
+            }
+            std::this_thread::yield();
+         }
+      };
+      double seconds = time([&]
+      {
+         for (uint64_t i = 0; i < numTrips; i++)
+         {
+            {
+               std::lock_guard<std::mutex> lock(m);
+               dPing.push_back(i);
+            }
+            sink += receive(dPong);
+         }
+      },
+      [&]
+      {
+         for (size_t i = 0; i < numTrips; i++)
+         {
+            uint64_t value = receive(dPing);
+            std::lock_guard<std::mutex> lock(m);
+            dPong.push_back(value);
+         }
+      });
+      return seconds / numTrips / 2.0 * 1e9;
+   }
+
+   double latencyRing()
+   {
+      custom::spsc_ring<uint64_t> rPing(64);
+      custom::spsc_ring<uint64_t> rPong(64);
+      return latency(rPing, rPong, [](custom::spsc_ring<uint64_t> & r, uint64_t value)
+      {
+         r.try_push(value);
+      });
+   }
+
+   double latencyQueue()
+   {
+      custom::spsc_queue<uint64_t> qPing;
+      custom::spsc_queue<uint64_t> qPong;
+      return latency(qPing, qPong, [](custom::spsc_queue<uint64_t> & q, uint64_t value)
+      {
+         q.push(value);
+      });
+   }
+
+   template <class Channel, class Send>
+   double latency(Channel & ping, Channel & pong, Send send)
+   {
+      auto receive = [](Channel & c)
+      {
+         uint64_t value;
+         while (!c.try_pop(value))
+            std::this_thread::yield();
+         return value;
+      };
+      double seconds = time([&]
+      {
+         for (uint64_t i = 0; i < numTrips; i++)
+         {
+            send(ping, i);
+            sink += receive(pong);
+         }
+      },
+      [&]
+      {
+         for (size_t i = 0; i < numTrips; i++)
+            send(pong, receive(ping));
+      });
+      return seconds / numTrips / 2.0 * 1e9;
+   }
+
+   void report(const char * name, double mmsgPerSecond, double nsLatency)
+   {
+      std::cout << std::setw(24) << std::left << name << std::right
+                << std::fixed << std::setprecision(2)
+                << std::setw(14) << mmsgPerSecond;
+      if (nsLatency > 0.0)
+         std::cout << std::setw(14) << std::setprecision(0) << nsLatency;
+      std::cout << std::endl;
+   }
+
+   size_t num;
+   size_t numTrips;
+   uint64_t sink;    // keeps the optimizer from dropping the work
+};
+
+#endif // BENCHMARK
@@ -12,7 +12,10 @@
  *
  *    This will contain the class definition of:
  *        deque                 : A class that represents a deque
- *        deque::iterator       : An iterator through a deque
+ *        deque::iterator       : A random-access iterator through a deque
+ *        deque_cells           : How many cells are in a block
+ *        deque_segment         : The elements of one block, contiguous
+ *        deque::segment_range  : The segments of a deque, in order
  * Author
  *    Jacob Mower
  *    Thatcher Albinston
@@ -24,19 +27,118 @@
 // Debug stuff
 #include <cassert>
 #include <memory>   // for std::allocator
+#include <iterator> // for std::random_access_iterator_tag
+#include <algorithm> // for std::move_backward
+#include <type_traits> // for std::enable_if
 
 class TestDeque;    // forward declaration for TestDeque unit test class
 
 namespace custom
 {
 
+/******************************************************
+ * DYNAMIC CELLS
+ * Pass this as the block size to choose it at runtime,
+ * the way std::dynamic_extent works for std::span
+ *****************************************************/
+const size_t dynamic_cells = 0;
+
+/******************************************************
+ * DEQUE BLOCK CELLS
+ * The default block size: the largest power of two
+ * cells that fits in about 4KB, and at least one
+ *****************************************************/
+constexpr size_t dequeBlockCells(size_t size, size_t cells = 1)
+{
+   return cells * 2 * size > 4096 ? cells : dequeBlockCells(size, cells * 2);
+}
+
+constexpr size_t log2Cells(size_t cells)
+{
+   return cells <= 1 ? 0 : 1 + log2Cells(cells / 2);
+}
+
+/******************************************************
+ * DEQUE CELLS
+ * How big a block is, and how an array index splits
+ * into a block and a cell. With a compile-time power
+ * of two that is a shift and a mask.
+ *****************************************************/
+template <size_t N>
+struct deque_cells
+{
+   static_assert(N > 0 && (N & (N - 1)) == 0,
+                 "deque blocks must hold a power of two elements");
+   static constexpr size_t numCells = N;
+   static constexpr size_t cellShift = log2Cells(N);
+
+   // id + iaFront is never past two laps, so one subtract wraps it
+   static size_t wrap(size_t ia, size_t numSlots) { return ia < numSlots ? ia : ia - numSlots; }
+   static size_t blockOf(size_t ia)               { return ia >> cellShift; }
+   static size_t cellOf(size_t ia)                { return ia & (N - 1);    }
+};
+template <size_t N>
+constexpr size_t deque_cells <N> ::numCells;
+
+/******************************************************
+ * DEQUE CELLS : DYNAMIC
+ * The block size is a member and can be anything,
+ * so every split is a division
+ *****************************************************/
+template <>
+struct deque_cells <dynamic_cells>
+{
+   deque_cells() : numCells(16) {}
+   size_t numCells;
+
+   size_t wrap(size_t ia, size_t numSlots) const { return ia % numSlots;       }
+   size_t blockOf(size_t ia)               const { return ia / numCells;       }
+   size_t cellOf(size_t ia)                const { return ia % numCells;       }
+};
+
+/******************************************************
+ * DEQUE SEGMENT
+ * A pointer and a length: the run of elements a deque
+ * keeps contiguous in one block. Bulk work (a SIMD
+ * kernel, a memcpy, a worker thread) can take a whole
+ * segment at a time.
+ *****************************************************/
+template <typename T>
+class deque_segment
+{
+public:
+   deque_segment()                  : p(nullptr), num(0)   {  }
+   deque_segment(T * p, size_t num) : p(p),       num(num) {  }
+   template <typename U>
+   deque_segment(const deque_segment<U> & rhs) : p(rhs.data()), num(rhs.size()) {  }
+
+   T * begin()   const { return p;         }
+   T * end()     const { return p + num;   }
+   T * data()    const { return p;         }
+   size_t size() const { return num;       }
+   bool empty()  const { return num == 0;  }
+   T & operator [] (size_t index) const { return p[index]; }
+
+private:
+   T * p;
+   size_t num;
+};
+
 /******************************************************
  * DEQUE
+ * Elements live in blocks of numCells. By default that
+ * is fixed when the deque is compiled; pass
+ * dynamic_cells to set it at runtime instead.
  *****************************************************/
-template <typename T, typename A = std::allocator<T>>
-class deque
+template <typename T, size_t N = dequeBlockCells(sizeof(T)),
+          typename A = std::allocator<T>>
+class deque : private deque_cells<N>
 {
    friend class ::TestDeque; // give unit tests access to the privates
+   using deque_cells<N>::numCells;
+   using deque_cells<N>::wrap;
+   using deque_cells<N>::blockOf;
+   using deque_cells<N>::cellOf;
 public:
 
    // 
@@ -47,13 +149,18 @@ public:
       data = nullptr;
       numElements = 0;
       numBlocks = 0; 
-      numCells = 16; 
       iaFront = 0;
+      spares = nullptr;
+      numSpares = 0;
+      maxSpares = defaultSpares;
+      shrinkPercent = defaultShrinkPercent;
    }
    deque(deque & rhs);
    ~deque()
    {
       clear();
+      set_max_spare_blocks(0);
+      delete [] data;
    }
 
    //
@@ -74,6 +181,42 @@ public:
       return iterator(numElements, this);
    }
 
+   //
+   // Segments
+   //
+   typedef deque_segment<T>       segment;
+   typedef deque_segment<const T> const_segment;
+   template <typename D, typename S>
+   class segment_range;
+   segment_range<deque, segment> segments()
+   {
+      return segment_range<deque, segment>(this);
+   }
+   segment_range<const deque, const_segment> segments() const
+   {
+      return segment_range<const deque, const_segment>(this);
+   }
+   template <class F>
+   void for_each_segment(F f)
+   {
+      for (size_t id = 0; id < numElements; )
+      {
+         segment seg = segmentAt(id);
+         f(seg);
+         id += seg.size();
+      }
+   }
+   template <class F>
+   void for_each_segment(F f) const
+   {
+      for (size_t id = 0; id < numElements; )
+      {
+         const_segment seg = segmentAt(id);
+         f(seg);
+         id += seg.size();
+      }
+   }
+
    // 
    // Access
    //
@@ -93,15 +236,15 @@ public:
    {
       return data[ibFromID(numElements - 1)][icFromID(numElements - 1)];
    }
-   T & operator[](int id)
+   T & operator[](size_t id)
    {
-      assert(0 <= id < numElements);
+      assert(id < numElements);
       assert(nullptr != data[ibFromID(id)]);
       return data[ibFromID(id)][icFromID(id)];
    }
-   const T & operator[](int id) const
+   const T & operator[](size_t id) const
    {
-      assert(0 <= id < numElements);
+      assert(id < numElements);
       assert(nullptr != data[ibFromID(id)]);
       return data[ibFromID(id)][icFromID(id)];
    }
@@ -113,6 +256,14 @@ public:
    void push_back(T && t);
    void push_front(const T& t);
    void push_front(T&& t);
+   iterator insert(iterator pos, const T & t)
+   {
+      return insert(pos, T(t));
+   }
+   iterator insert(iterator pos, T && t);
+   template <class Iterator,
+             class = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
+   iterator insert(iterator pos, Iterator first, Iterator last);
 
    //
    // Remove
@@ -120,39 +271,63 @@ public:
    void pop_front();
    void pop_back();
    void clear();
+   void shrink_to_fit();
+   iterator erase(iterator pos)
+   {
+      return erase(pos, pos + 1);
+   }
+   iterator erase(iterator first, iterator last);
 
    //
    // Status
    //
    size_t size()  const { return numElements; }
    bool   empty() const { return numElements == 0; }
+
+   //
+   // Spare blocks
+   //
+   size_t spare_blocks()     const { return numSpares; }
+   size_t max_spare_blocks() const { return maxSpares; }
+   void set_max_spare_blocks(size_t num);
+
+   //
+   // Shrink policy
+   //
+   size_t shrink_threshold() const { return shrinkPercent; }
+   void set_shrink_threshold(size_t percent);
    
 private:
+   // put [first, last) at id: counted up front, or read once
+   template <class Iterator>
+   iterator insertRange(size_t id, Iterator first, Iterator last, std::forward_iterator_tag);
+   template <class Iterator>
+   iterator insertRange(size_t id, Iterator first, Iterator last, std::input_iterator_tag);
+
    // array index from deque index
-   int iaFromID(int id) const
+   size_t iaFromID(size_t id) const
    {
-      assert(id >= 0);
       //if (numElements > 0)
          //assert(id < numElements);
-      assert(0 <= iaFront && iaFront < (numCells * numBlocks));
-      int ia = (id + iaFront) % (numCells * numBlocks);
-      assert(0 <= ia && ia < (numCells * numBlocks));
+      assert(iaFront < (numCells * numBlocks));
+      size_t ia = wrap(id + iaFront, numCells * numBlocks);
+      assert(ia < (numCells * numBlocks));
       return ia;
    }
 
    // block index from deque index
-   int ibFromID(int id) const
+   size_t ibFromID(size_t id) const
    {
-      int ib = iaFromID(id) / numCells;
-      assert(0 <= ib && ib < numBlocks);
+      size_t ib = blockOf(iaFromID(id));
+      assert(ib < numBlocks);
       return ib;
    }
 
    // cell index from deque index
-   int icFromID(int id) const
+   size_t icFromID(size_t id) const
    {
-      int ic = iaFromID(id) % numCells;
-      assert(0 <= ic && ic < numCells);
+      size_t ic = cellOf(iaFromID(id));
+      assert(ic < numCells);
       return ic;
    }
    
@@ -166,43 +341,103 @@ private:
       return true;
    }
 
+   // the elements from id to the end of its block, or to the back
+   segment segmentAt(size_t id) const
+   {
+      size_t ic = icFromID(id);
+      size_t num = numCells - ic;
+      if (num > numElements - id)
+         num = numElements - id;
+      return segment(data[ibFromID(id)] + ic, num);
+   }
+
+   // how many blocks the elements span, counting the front
+   // block twice when the back has wrapped around into it
+   size_t numBlocksUsed() const
+   {
+      return numElements == 0 ? 0 : blockOf(cellOf(iaFront) + numElements - 1) + 1;
+   }
+
+   // does a push into array index ia need a bigger block table? Only if
+   // the block there is taken, so we rarely have to look at them all
+   bool isFullAt(size_t ia) const
+   {
+      return numBlocks == 0 || (nullptr != data[blockOf(ia)] && isAllBlocksFilled());
+   }
+
    // reallocate
-   void reallocate(int numBlocksNew);
+   void reallocate(size_t numBlocksNew);
+   void shrinkIfSparse();
+
+   // a block for a push, from the spares if there is one
+   T * allocateBlock()
+   {
+      if (numSpares > 0)
+         return spares[--numSpares];
+      return alloc.allocate(numCells);
+   }
+
+   // an emptied block goes to the spares unless they are full
+   void freeBlock(T * pBlock)
+   {
+      if (numSpares < maxSpares)
+      {
+         if (spares == nullptr)
+            spares = new T*[maxSpares];
+         spares[numSpares++] = pBlock;
+      }
+      else
+         alloc.deallocate(pBlock, numCells);
+   }
+
+   static const size_t defaultSpares = 4;
+   static const size_t defaultShrinkPercent = 25;
+   static const size_t minShrinkBlocks = 8;
 
    A    alloc;                // use alloacator for memory allocation
-   size_t numCells;           // number of cells in a block
    size_t numBlocks;          // number of blocks in the data array
+                              // (numCells, the cells in a block, is in deque_cells)
    size_t numElements;        // number of elements in the deque
-   int iaFront;               // array-centered index of the front of the deque
+   size_t iaFront;            // array-centered index of the front of the deque
    T ** data;                 // array of arrays
+   T ** spares;               // empty blocks kept for the next push
+   size_t numSpares;          // number of blocks in spares
+   size_t maxSpares;          // how many empty blocks we are willing to hold
+   size_t shrinkPercent;      // shrink the map when less of it than this is in use
 };
 
 /**************************************************
  * DEQUE ITERATOR
- * An iterator through deque.  You only need to
- * support the following:
- *   1. Constructors (default and copy)
- *   2. Not equals operator
- *   3. Increment (prefix and postfix)
- *   4. Dereference
- * This particular iterator is a bi-directional meaning
- * that ++ and -- both work.  Not all iterators are that way.
+ * A random-access iterator through a deque. The
+ * position is the deque index id. Alongside it we
+ * cache a pointer to the current cell and the bounds
+ * of its block, so stepping or jumping within a block
+ * is a pointer bump. Crossing into another block
+ * drops the cache; the next dereference looks the
+ * block up again.
  *************************************************/
-template <typename T, typename A>
-class deque <T, A> ::iterator
+template <typename T, size_t N, typename A>
+class deque <T, N, A> ::iterator
 {
    friend class ::TestDeque; // give unit tests access to the privates
 public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
    // 
    // Construct
    //
-   iterator() : d(nullptr), id(0)
+   iterator() : d(nullptr), id(0), pCell(nullptr), pBegin(nullptr), pEnd(nullptr)
    {
    }
-   iterator(int id, deque* d) : d(d), id(id)
+   iterator(size_t id, deque* d) : d(d), id(id), pCell(nullptr), pBegin(nullptr), pEnd(nullptr)
    {
    }
-   iterator(const iterator& rhs) : d(rhs.d), id(rhs.id)
+   iterator(const iterator& rhs) : d(rhs.d), id(rhs.id),
+      pCell(rhs.pCell), pBegin(rhs.pBegin), pEnd(rhs.pEnd)
    { 
    }
 
@@ -213,6 +448,9 @@ public:
    {
       this->d = rhs.d;
       this->id = rhs.id;
+      this->pCell = rhs.pCell;
+      this->pBegin = rhs.pBegin;
+      this->pEnd = rhs.pEnd;
       return *this;
    }
 
@@ -221,53 +459,154 @@ public:
    //
    bool operator != (const iterator& rhs) const { return this->d == rhs.d && this->id != rhs.id; }
    bool operator == (const iterator& rhs) const { return this->d == rhs.d && this->id == rhs.id; }
+   bool operator <  (const iterator& rhs) const { return id <  rhs.id; }
+   bool operator >  (const iterator& rhs) const { return id >  rhs.id; }
+   bool operator <= (const iterator& rhs) const { return id <= rhs.id; }
+   bool operator >= (const iterator& rhs) const { return id >= rhs.id; }
 
    // 
    // Access
    //
-   T& operator * ()
+   T& operator * () const
+   {
+      if (nullptr == pCell)
+         load();
+      return *pCell;
+   }
+   T* operator -> () const
+   {
+      return &**this;
+   }
+   T& operator [] (difference_type offset) const
    {
-      return (*d)[id];
+      return *(*this + offset);
    }
 
    // 
    // Arithmetic
    //
-   int operator - (iterator it) const
+   difference_type operator - (const iterator & it) const
    {
-      return id - it.id;
+      return (difference_type)id - (difference_type)it.id;
    }
-   iterator& operator += (int offset)
+   iterator& operator += (difference_type offset)
    {
       id += offset;
+      if (nullptr != pCell && offset < pEnd - pCell && offset >= pBegin - pCell)
+         pCell += offset;
+      else
+         pCell = nullptr;
       return *this;
    }
+   iterator& operator -= (difference_type offset)
+   {
+      return *this += -offset;
+   }
+   iterator operator + (difference_type offset) const
+   {
+      iterator it = *this;
+      return it += offset;
+   }
+   iterator operator - (difference_type offset) const
+   {
+      iterator it = *this;
+      return it += -offset;
+   }
+   friend iterator operator + (difference_type offset, const iterator & it)
+   {
+      return it + offset;
+   }
    iterator& operator ++ ()
    {
       ++id;
+      if (nullptr != pCell && ++pCell == pEnd)
+         pCell = nullptr;
       return *this;
    }
    iterator operator ++ (int postfix)
    {
       iterator temp = *this;
-      ++id;
+      ++*this;
       return temp;
    }
    iterator& operator -- ()
    {
       --id;
+      if (nullptr != pCell)
+         pCell = (pCell == pBegin) ? nullptr : pCell - 1;
       return *this;
    }
    iterator operator -- (int postfix)
    {
       iterator temp = *this;
-      --id;
+      --*this;
       return temp;
    }
 
 private:
-   int id;
+   // find the block holding id and remember its bounds
+   void load() const
+   {
+      pBegin = d->data[d->ibFromID(id)];
+      pEnd = pBegin + d->numCells;
+      pCell = pBegin + d->icFromID(id);
+   }
+
+   size_t id;
    deque* d;
+   mutable T* pCell;          // the cell at id, or nullptr when not looked up yet
+   mutable T* pBegin;         // the first cell of that block
+   mutable T* pEnd;           // one past the last cell of that block
+};
+
+/**************************************************
+ * DEQUE SEGMENT RANGE
+ * What segments() returns: something to walk with a
+ * range-based for loop, one block's worth at a time.
+ * Each step jumps by the size of the segment it just
+ * handed out.
+ *************************************************/
+template <typename T, size_t N, typename A>
+template <typename D, typename S>
+class deque <T, N, A> ::segment_range
+{
+public:
+   class iterator
+   {
+   public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef S                         value_type;
+      typedef std::ptrdiff_t            difference_type;
+      typedef const S *                 pointer;
+      typedef S                         reference;
+
+      iterator(D * d, size_t id) : d(d), id(id) {  }
+      bool operator != (const iterator & rhs) const { return id != rhs.id; }
+      bool operator == (const iterator & rhs) const { return id == rhs.id; }
+      S operator * () const { return S(d->segmentAt(id)); }
+      iterator & operator ++ ()
+      {
+         id += d->segmentAt(id).size();
+         return *this;
+      }
+      iterator operator ++ (int postfix)
+      {
+         iterator temp = *this;
+         ++*this;
+         return temp;
+      }
+
+   private:
+      D * d;
+      size_t id;
+   };
+
+   segment_range(D * d) : d(d) {  }
+   iterator begin() const { return iterator(d, 0);              }
+   iterator end()   const { return iterator(d, d->numElements); }
+
+private:
+   D * d;
 };
 
 /*****************************************
@@ -275,9 +614,10 @@ private:
  * Allocate the space for the elements and
  * call the copy constructor on each element
  ****************************************/
-template <typename T, typename A>
-deque <T, A> ::deque(deque& rhs) : data(nullptr), numElements(0),
-numCells(16), numBlocks(0), iaFront(0)
+template <typename T, size_t N, typename A>
+deque <T, N, A> ::deque(deque& rhs) : data(nullptr), numElements(0),
+numBlocks(0), iaFront(0), spares(nullptr), numSpares(0),
+maxSpares(defaultSpares), shrinkPercent(defaultShrinkPercent)
 {
    *this = rhs;
 }
@@ -287,8 +627,8 @@ numCells(16), numBlocks(0), iaFront(0)
  * Allocate the space for the elements and
  * call the copy constructor on each element
  ****************************************/
-template <typename T, typename A>
-deque <T, A> & deque <T, A> :: operator = (deque & rhs)
+template <typename T, size_t N, typename A>
+deque <T, N, A> & deque <T, N, A> :: operator = (deque & rhs)
 {
    iterator itLHS = begin();
    iterator itRHS = rhs.begin();
@@ -319,18 +659,18 @@ deque <T, A> & deque <T, A> :: operator = (deque & rhs)
  * DEQUE :: PUSH_BACK
  * add an element to the back of the deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::push_back(const T& t)
+template <typename T, size_t N, typename A>
+void deque <T, N, A> ::push_back(const T& t)
 {
    //Reallocate the array of blocks as needed
-   int icTail = (numElements == 0) ? numCells - 1 : icFromID(numElements - 1);
-   if (isAllBlocksFilled() && icTail == numCells - 1)
+   size_t icTail = (numElements == 0) ? numCells - 1 : icFromID(numElements - 1);
+   if (icTail == numCells - 1 && isFullAt(numBlocks ? iaFromID(numElements) : 0))
       reallocate(numBlocks == 0 ? 1 : numBlocks * 2);
   
    //Allocate a new block as needed
-   int ib = ibFromID(numElements);
+   size_t ib = ibFromID(numElements);
    if (data[ib] == nullptr)
-      data[ib] = alloc.allocate(numCells);
+      data[ib] = allocateBlock();
 
    //Assign the value into the block
    new((void*)(&(data[ib][icFromID(numElements)]))) T(t);
@@ -341,18 +681,18 @@ void deque <T, A> ::push_back(const T& t)
  * DEQUE :: PUSH_BACK - move
  * add an element to the back of the deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::push_back(T && t)
+template <typename T, size_t N, typename A>
+void deque <T, N, A> ::push_back(T && t)
 {
    //Reallocate the array of blocks as needed
-   int icTail = (numElements == 0) ? numCells - 1 : icFromID(numElements - 1);
-   if (isAllBlocksFilled() && icTail == numCells - 1)
+   size_t icTail = (numElements == 0) ? numCells - 1 : icFromID(numElements - 1);
+   if (icTail == numCells - 1 && isFullAt(numBlocks ? iaFromID(numElements) : 0))
       reallocate(numBlocks == 0 ? 1 : numBlocks * 2);
   
    //Allocate a new block as needed
-   int ib = ibFromID(numElements);
+   size_t ib = ibFromID(numElements);
    if (data[ib] == nullptr)
-      data[ib] = alloc.allocate(numCells);
+      data[ib] = allocateBlock();
 
    //Assign the value into the block
    new((void*)(&(data[ib][icFromID(numElements)]))) T(std::move(t));
@@ -363,12 +703,12 @@ void deque <T, A> ::push_back(T && t)
  * DEQUE :: PUSH_FRONT
  * add an element to the front of the deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::push_front(const T& t)
+template <typename T, size_t N, typename A>
+void deque <T, N, A> ::push_front(const T& t)
 {
    //Reallocate the array of blocks as needed
-   int icHead = (numElements == 0) ? 0 : icFromID(0);
-   if (isAllBlocksFilled() && icHead == 0)
+   size_t icHead = (numElements == 0) ? 0 : icFromID(0);
+   if (icHead == 0 && isFullAt((iaFront ? iaFront : numCells * numBlocks) - 1))
       reallocate(numBlocks == 0 ? 1 : numBlocks * 2);
    
    if (iaFront != 0)
@@ -377,9 +717,9 @@ void deque <T, A> ::push_front(const T& t)
       iaFront = numBlocks * numCells - 1;
    
    //Allocate a new block as needed
-   int ib = ibFromID(0);
+   size_t ib = ibFromID(0);
    if (data[ib] == nullptr)
-      data[ib] = alloc.allocate(numCells);
+      data[ib] = allocateBlock();
    
    //Assign the value into the block
    new((void*)(&(data[ib][icFromID(0)]))) T(t);
@@ -390,13 +730,13 @@ void deque <T, A> ::push_front(const T& t)
  * DEQUE :: PUSH_FRONT - move
  * add an element to the front of the deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::push_front(T&& t)
+template <typename T, size_t N, typename A>
+void deque <T, N, A> ::push_front(T&& t)
 {
    
    //Reallocate the array of blocks as needed
-   int icHead = (numElements == 0) ? 0 : icFromID(0);
-   if (isAllBlocksFilled() && icHead == 0)
+   size_t icHead = (numElements == 0) ? 0 : icFromID(0);
+   if (icHead == 0 && isFullAt((iaFront ? iaFront : numCells * numBlocks) - 1))
       reallocate(numBlocks == 0 ? 1 : numBlocks * 2);
    
    if (iaFront != 0)
@@ -405,29 +745,195 @@ void deque <T, A> ::push_front(T&& t)
       iaFront = numBlocks * numCells - 1;
    
    //Allocate a new block as needed
-   int ib = ibFromID(0);
+   size_t ib = ibFromID(0);
    if (data[ib] == nullptr)
-      data[ib] = alloc.allocate(numCells);
+      data[ib] = allocateBlock();
    
    //Assign the value into the block
    new((void*)(&(data[ib][icFromID(0)]))) T(std::move(t));
    numElements++;
 }
 
+/*****************************************
+ * DEQUE :: INSERT
+ * Put t in front of pos. Whichever side of pos
+ * is shorter makes room: one element is pushed
+ * on that end and the rest slide over by one.
+ * The slide walks the blocks with the iterator,
+ * so it is a pointer bump within each block.
+ *     INPUT  : pos  where t goes
+ *              t    the new element
+ *     OUTPUT : an iterator to t in the deque
+ ****************************************/
+template <typename T, size_t N, typename A>
+typename deque <T, N, A> ::iterator deque <T, N, A> ::insert(iterator pos, T && t)
+{
+   size_t id = (size_t)(pos - begin());
+   assert(id <= numElements);
+
+   if (id < numElements - id)
+   {
+      // the front is shorter: everything before pos moves down one
+      if (id == 0)
+      {
+         push_front(std::move(t));
+         return begin();
+      }
+      push_front(std::move(front()));
+      std::move(begin() + 2, begin() + (id + 1), begin() + 1);
+   }
+   else
+   {
+      // the back is shorter: pos and everything after moves up one
+      if (id == numElements)
+      {
+         push_back(std::move(t));
+         return iterator(id, this);
+      }
+      push_back(std::move(back()));
+      std::move_backward(begin() + id, begin() + (numElements - 2), begin() + (numElements - 1));
+   }
+   (*this)[id] = std::move(t);
+   return iterator(id, this);
+}
+
+/*****************************************
+ * DEQUE :: INSERT - range
+ * Put copies of [first, last) in front of pos.
+ * Integers are not iterators: insert(pos, 3, 5)
+ * is not a range.
+ *     INPUT  : pos          where the range goes
+ *              first, last  what to copy
+ *     OUTPUT : an iterator to the first new element
+ ****************************************/
+template <typename T, size_t N, typename A>
+template <class Iterator, class>
+typename deque <T, N, A> ::iterator deque <T, N, A> ::insert(iterator pos, Iterator first, Iterator last)
+{
+   return insertRange((size_t)(pos - begin()), first, last,
+                      typename std::iterator_traits<Iterator>::iterator_category());
+}
+
+/*****************************************
+ * DEQUE :: INSERT RANGE - forward
+ * Make room for [first, last) on the shorter side.
+ * Elements that end up past that end are moved
+ * there; any slot still short is filled with a copy
+ * of *first so it can simply be assigned over
+ * afterwards. That walks the range more than once.
+ *     INPUT  : id           where the range goes
+ *              first, last  what to copy, a forward range
+ *     OUTPUT : an iterator to the first new element
+ ****************************************/
+template <typename T, size_t N, typename A>
+template <class Iterator>
+typename deque <T, N, A> ::iterator deque <T, N, A> ::insertRange(size_t id, Iterator first, Iterator last, std::forward_iterator_tag)
+{
+   size_t numInsert = (size_t)std::distance(first, last);
+   assert(id <= numElements);
+   if (numInsert == 0)
+      return iterator(id, this);
+
+   if (id < numElements - id)
+   {
+      // the front is shorter. Grow the front by numInsert; the
+      // element pushed on step j belongs at numInsert - 1 - j.
+      for (size_t j = 0; j < numInsert; j++)
+         if (numInsert - 1 - j >= id)
+            push_front(*first);
+         else
+            push_front(std::move((*this)[numInsert - 1]));
+
+      // slide the rest of the front down
+      if (id > numInsert)
+         std::move(begin() + 2 * numInsert, begin() + (id + numInsert), begin() + numInsert);
+   }
+   else
+   {
+      // the back is shorter. Grow the back by numInsert; the
+      // element pushed on step j belongs at numElementsOld + j.
+      size_t numElementsOld = numElements;
+      for (size_t j = 0; j < numInsert; j++)
+         if (numElementsOld + j < id + numInsert)
+            push_back(*first);
+         else
+            push_back(std::move((*this)[numElementsOld + j - numInsert]));
+
+      // slide the rest of the back up
+      if (numElementsOld - id > numInsert)
+         std::move_backward(begin() + id, begin() + (numElementsOld - numInsert),
+                            begin() + numElementsOld);
+   }
+   std::copy(first, last, begin() + id);
+   return iterator(id, this);
+}
+
+/*****************************************
+ * DEQUE :: INSERT RANGE - input
+ * An input iterator (a stream, say) can only be
+ * read once, so the elements are collected in a
+ * scratch deque and inserted from there.
+ *     INPUT  : id           where the range goes
+ *              first, last  what to copy, a single-pass range
+ *     OUTPUT : an iterator to the first new element
+ ****************************************/
+template <typename T, size_t N, typename A>
+template <class Iterator>
+typename deque <T, N, A> ::iterator deque <T, N, A> ::insertRange(size_t id, Iterator first, Iterator last, std::input_iterator_tag)
+{
+   deque scratch;
+   for (; first != last; ++first)
+      scratch.push_back(*first);
+   return insertRange(id, scratch.begin(), scratch.end(), std::forward_iterator_tag());
+}
+
+/*****************************************
+ * DEQUE :: ERASE
+ * Remove [first, last). The shorter side slides
+ * over the gap and that many elements are popped
+ * off its end, which frees any block emptied.
+ *     INPUT  : first, last  what to remove
+ *     OUTPUT : an iterator to the element after them
+ ****************************************/
+template <typename T, size_t N, typename A>
+typename deque <T, N, A> ::iterator deque <T, N, A> ::erase(iterator first, iterator last)
+{
+   size_t idFirst = (size_t)(first - begin());
+   size_t idLast = (size_t)(last - begin());
+   assert(idFirst <= idLast && idLast <= numElements);
+   size_t numErase = idLast - idFirst;
+   if (numErase == 0)
+      return iterator(idFirst, this);
+
+   if (idFirst < numElements - idLast)
+   {
+      std::move_backward(begin(), begin() + idFirst, begin() + idLast);
+      for (size_t i = 0; i < numErase; i++)
+         pop_front();
+   }
+   else
+   {
+      std::move(begin() + idLast, end(), begin() + idFirst);
+      for (size_t i = 0; i < numErase; i++)
+         pop_back();
+   }
+   return iterator(idFirst, this);
+}
+
 /*****************************************
  * DEQUE :: CLEAR
  * Remove all the elements from a deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::clear()
+template <typename T, size_t N, typename A>
+void deque <T, N, A> ::clear()
 {
-   for (int id = 0; id < numElements; id++)
+   for (size_t id = 0; id < numElements; id++)
       alloc.destroy(&data[ibFromID(id)][icFromID(id)]);
    
-   for (int ib = 0; ib < numBlocks; ib++) {
+   for (size_t ib = 0; ib < numBlocks; ib++) {
       if (data[ib] != nullptr)
       {
-         alloc.deallocate(data[ib], numCells);
+         freeBlock(data[ib]);
          data[ib] = nullptr;
       }
    }
@@ -438,89 +944,174 @@ void deque <T, A> ::clear()
  * DEQUE :: POP FRONT
  * Remove the front element from a deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> :: pop_front()
+template <typename T, size_t N, typename A>
+void deque <T, N, A> :: pop_front()
 {
-   int idRemove = 0;
-   int ibRemove = ibFromID(idRemove);
+   size_t idRemove = 0;
+   size_t ibRemove = ibFromID(idRemove);
+   size_t ibBack = ibFromID(numElements - 1);
    alloc.destroy(&data[ibRemove][icFromID(idRemove)]);
    iaFront++;
    if (iaFront == (numCells * numBlocks))
       iaFront = 0;
    
+   // the block is empty once the front moves off its last cell,
+   // unless the back has wrapped around into the same block
    if (numElements == 1 ||
-       (icFromID(iaFront) == 0 && ibRemove != ibFromID(iaFront)))
+       (cellOf(iaFront) == 0 && ibRemove != ibBack))
    {
-      alloc.deallocate(data[ibRemove],numCells);
+      freeBlock(data[ibRemove]);
       data[ibRemove] = nullptr;
+      numElements--;
+      shrinkIfSparse();
    }
-   numElements--;
+   else
+      numElements--;
 }
 
 /*****************************************
  * DEQUE :: POP BACK
  * Remove the back element from a deque
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> ::pop_back()
+template <typename T, size_t N, typename A>
+void deque <T, N, A> ::pop_back()
 {
-   int idRemove = numElements - 1;
+   size_t idRemove = numElements - 1;
    alloc.destroy(&data[ibFromID(idRemove)][icFromID(idRemove)]);
    if (numElements == 1 || 
        (icFromID(idRemove) == 0 && ibFromID(idRemove) != ibFromID(0)))
    {
-      alloc.deallocate(data[ibFromID(idRemove)],numCells);
+      freeBlock(data[ibFromID(idRemove)]);
       data[ibFromID(idRemove)] = nullptr;
+      numElements--;
+      shrinkIfSparse();
    }
-   numElements--;
+   else
+      numElements--;
+}
+
+/*****************************************
+ * DEQUE :: SET MAX SPARE BLOCKS
+ * How many emptied blocks to hold on to. A queue
+ * that keeps crossing a block boundary then
+ * reuses the same blocks instead of going back
+ * to the allocator. Spares over the new limit
+ * are freed; zero frees them all.
+ *     INPUT  : num  the high-water mark
+ *     OUTPUT :
+ ****************************************/
+template <typename T, size_t N, typename A>
+void deque <T, N, A> :: set_max_spare_blocks(size_t num)
+{
+   while (numSpares > num)
+      alloc.deallocate(spares[--numSpares], numCells);
+
+   T ** sparesNew = num ? new T*[num] : nullptr;
+   for (size_t i = 0; i < numSpares; i++)
+      sparesNew[i] = spares[i];
+   delete [] spares;
+   spares = sparesNew;
+   maxSpares = num;
+}
+
+/*****************************************
+ * DEQUE :: SHRINK TO FIT
+ * Give back everything not holding an element:
+ * the spare blocks, and the slots in the block
+ * map past the blocks in use. An empty deque
+ * ends up with no map at all.
+ ****************************************/
+template <typename T, size_t N, typename A>
+void deque <T, N, A> :: shrink_to_fit()
+{
+   while (numSpares > 0)
+      alloc.deallocate(spares[--numSpares], numCells);
+
+   size_t numUsed = numBlocksUsed();
+   if (numUsed < numBlocks)
+      reallocate(numUsed);
+}
+
+/*****************************************
+ * DEQUE :: SET SHRINK THRESHOLD
+ * When a pop empties a block and fewer than this
+ * percent of the map holds blocks in use, the map
+ * is cut to twice the blocks in use and the spares
+ * are freed. The factor of two keeps a deque that
+ * hovers near the threshold from shrinking and
+ * growing over and over. Zero turns this off.
+ *     INPUT  : percent  occupancy to shrink below
+ *     OUTPUT :
+ ****************************************/
+template <typename T, size_t N, typename A>
+void deque <T, N, A> :: set_shrink_threshold(size_t percent)
+{
+   assert(percent < 50);
+   shrinkPercent = percent;
+}
+
+/*****************************************
+ * DEQUE :: SHRINK IF SPARSE
+ * Called after a pop frees a block: apply the
+ * shrink threshold. Small maps are left alone.
+ ****************************************/
+template <typename T, size_t N, typename A>
+void deque <T, N, A> :: shrinkIfSparse()
+{
+   size_t numUsed = numBlocksUsed();
+   if (numBlocks < minShrinkBlocks || numUsed * 100 >= numBlocks * shrinkPercent)
+      return;
+
+   while (numSpares > 0)
+      alloc.deallocate(spares[--numSpares], numCells);
+   size_t numBlocksNew = numUsed * 2;
+   if (numBlocksNew < minShrinkBlocks / 2)
+      numBlocksNew = minShrinkBlocks / 2;
+   reallocate(numBlocksNew);
 }
 
 /*****************************************
  * DEQUE :: REALLOCATE
- * Remove all the elements from a deque
+ * Move the block pointers into a new map of
+ * numBlocksNew slots, front block first. The
+ * blocks themselves stay where they are, except
+ * when the back has wrapped around into the front
+ * block: that block is split and the back part
+ * moved into a block of its own.
+ *     INPUT  : numBlocksNew  at least numBlocksUsed()
+ *     OUTPUT :
  ****************************************/
-template <typename T, typename A>
-void deque <T, A> :: reallocate(int numBlocksNew)
+template <typename T, size_t N, typename A>
+void deque <T, N, A> :: reallocate(size_t numBlocksNew)
 {
-   T** dataNew = new T*[numBlocksNew];
-   int ibNew = 0;
-   for (int idOld = 0; idOld < numElements; idOld += numCells)
-   {
-      dataNew[ibNew] = data[ibFromID(idOld)];
-      ibNew++;
-   }
+   size_t numUsed = numBlocksUsed();
+   assert(numBlocksNew >= numUsed);
+   T** dataNew = numBlocksNew ? new T*[numBlocksNew] : nullptr;
+   size_t ibFront = numBlocks ? blockOf(iaFront) : 0;
+
+   size_t ibNew = 0;
+   for (; ibNew < numUsed && ibNew < numBlocks; ibNew++)
+      dataNew[ibNew] = data[wrap(ibFront + ibNew, numBlocks)];
+   for (size_t ib = ibNew; ib < numBlocksNew; ib++)
+      dataNew[ib] = nullptr;
    
-   while (ibNew < numBlocksNew)
+   if (numUsed > numBlocks)
    {
-      dataNew[ibNew] = nullptr;
-      ibNew++;
-   }
-   
-   if (numElements > 0 && ibFromID(0) == ibFromID(numElements - 1) &&
-       icFromID(0) > icFromID(numElements - 1))
-   {
-      int ibFrontOld = ibFromID(0);
-      int ibBackOld = ibFromID(numElements - 1);
-      int ibBackNew = numElements / numCells;
-      dataNew[ibBackNew] = alloc.allocate(numCells);
-      
-      for (int ic = 0; ic < icFromID(numElements - 1); ic++) 
+      // the cells before iaFront in the front block belong at the back
+      size_t icBack = icFromID(numElements - 1);
+      T * pBlockBack = allocateBlock();
+      for (size_t ic = 0; ic <= icBack; ic++)
       {
-         new((void*)(&(dataNew[ibBackNew][ic]))
-             ) T(std::move(data[ibBackOld][ic]));
+         new((void*)(&pBlockBack[ic])) T(std::move(data[ibFront][ic]));
+         alloc.destroy(&data[ibFront][ic]);
       }
+      dataNew[numUsed - 1] = pBlockBack;
    }
    
-   if (data)
-      delete data;
-   
+   delete [] data;
    data = dataNew;
    numBlocks = numBlocksNew;
-   iaFront = iaFront % numCells;
-   
+   iaFront = numBlocks ? cellOf(iaFront) : 0;
 }
 
-
-
-
 } // namespace custom
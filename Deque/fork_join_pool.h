@@ -0,0 +1,476 @@
+/***********************************************************************
+ * Header:
+ *    FORK JOIN POOL
+ * Summary:
+ *    A small fork-join thread pool. Every worker owns a
+ *    work_stealing_deque of tasks: what a worker spawns it pushes onto
+ *    its own bottom and pops back off, newest first, while idle workers
+ *    steal the oldest (and usually biggest) tasks from the top of
+ *    someone else's. Threads outside the pool hand tasks in through a
+ *    locked deque. A worker waiting for its children to finish runs
+ *    other tasks meanwhile instead of blocking. This is not the
+ *    vector lab's thread_pool, which splits one flat loop over a
+ *    shared queue; the two can be used in the same program.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        fork_join_pool         : The workers and their deques
+ *        task_group             : Tasks spawned together and joined together
+ *        parallel_for           : Split a range into chunks run on the pool
+ * Author
+ *    Jacob Mower
+ *    Thatcher Albinston
+ *    Elroe Woldemichael
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>             // because I am paranoid
+#include <atomic>              // for std::atomic
+#include <chrono>              // for the idle timeout
+#include <condition_variable>  // for sleeping workers and outside joins
+#include <exception>           // for std::exception_ptr
+#include <mutex>               // for the outside queue
+#include <thread>              // for std::thread
+#include <type_traits>         // for std::decay
+#include <utility>             // for std::forward
+#include <vector>              // for the workers
+#include "deque.h"             // for the outside queue
+#include "work_stealing_deque.h"
+
+class TestForkJoinPool;        // forward declaration for unit tests
+
+namespace custom
+{
+
+class task_group;
+
+/******************************************************
+ * FORK JOIN POOL
+ * numThreads workers, each with its own deque. A worker
+ * with nothing to do tries its own deque, then the
+ * outside queue, then steals from the others starting
+ * at a random one. After spinning a while it sleeps;
+ * a spawn wakes one sleeper, and the sleep has a short
+ * timeout so a wakeup lost to that race only costs a
+ * millisecond.
+ *
+ * The pool must outlive every task_group on it.
+ *****************************************************/
+class fork_join_pool
+{
+   friend class ::TestForkJoinPool; // give unit tests access to the privates
+   friend class task_group;
+
+   // a unit of work, freed once it has run
+   struct Task
+   {
+      Task(task_group * pGroup) : pGroup(pGroup) {}
+      virtual ~Task() {}
+      virtual void execute() = 0;
+      task_group * pGroup;
+   };
+
+   template <typename F>
+   struct TaskOf : Task
+   {
+      TaskOf(task_group * pGroup, F && f) : Task(pGroup), f(std::forward<F>(f)) {}
+      void execute() { f(); }
+      typename std::decay<F>::type f;
+   };
+
+   struct Worker
+   {
+      Worker(fork_join_pool * pPool, size_t index) :
+         pPool(pPool), index(index), seed((unsigned int)index * 2654435761u + 1) {}
+      fork_join_pool * pPool;
+      size_t index;
+      unsigned int seed;        // for picking a victim
+      work_stealing_deque<Task *> tasks;
+   };
+
+public:
+   explicit fork_join_pool(size_t numThreads = defaultThreads());
+   fork_join_pool(const fork_join_pool &) = delete;
+   fork_join_pool & operator = (const fork_join_pool &) = delete;
+  ~fork_join_pool();
+
+   size_t size() const { return workers.size(); }
+
+   static size_t defaultThreads()
+   {
+      size_t num = std::thread::hardware_concurrency();
+      return num ? num : 1;
+   }
+
+private:
+   // queue a task from whatever thread is calling
+   void submit(Task * pTask);
+
+   // the next task for this worker, or nullptr
+   Task * find(Worker * pWorker);
+
+   // run one task and tell its group
+   void execute(Task * pTask);
+
+   // a worker's life
+   void loop(Worker * pWorker);
+
+   // the worker the calling thread is, if it is one of ours
+   Worker * self() const
+   {
+      Worker * pWorker = current();
+      return pWorker && pWorker->pPool == this ? pWorker : nullptr;
+   }
+
+   static Worker *& current()
+   {
+      static thread_local Worker * pWorker = nullptr;
+      return pWorker;
+   }
+
+   std::vector<Worker *> workers;
+   std::vector<std::thread> threads;
+
+   // tasks from threads outside the pool
+   std::mutex mutexOutside;
+   custom::deque<Task *> outside;
+   std::atomic<size_t> numOutside;
+
+   // sleeping workers, and threads outside waiting on a join
+   std::mutex mutexSleep;
+   std::condition_variable cvSleep;
+   std::condition_variable cvJoin;
+   std::atomic<size_t> numSleeping;
+   std::atomic<bool> stopping;
+};
+
+/******************************************************
+ * TASK GROUP
+ * Tasks spawned on a pool and waited for together. A
+ * spawned task may spawn more into the same group, so
+ * a recursive algorithm needs only one group per level
+ * or even one in total. join returns once all of them
+ * have run, and rethrows the first exception any threw.
+ *****************************************************/
+class task_group
+{
+   friend class ::TestForkJoinPool; // give unit tests access to the privates
+   friend class fork_join_pool;
+public:
+   explicit task_group(fork_join_pool & pool) : pool(pool), numPending(0) {}
+   task_group(const task_group &) = delete;
+   task_group & operator = (const task_group &) = delete;
+  ~task_group() { wait(); }
+
+   template <typename F>
+   void spawn(F && f);
+   void join();
+
+private:
+   // until numPending is zero, helping if the caller is a worker
+   void wait();
+
+   // a task of this group has run
+   void done(std::exception_ptr error);
+
+   fork_join_pool & pool;
+   std::atomic<size_t> numPending;
+   std::mutex mutexError;
+   std::exception_ptr error;   // the first one thrown
+};
+
+/*****************************************
+ * FORK JOIN POOL :: CONSTRUCTOR
+ * Build every worker before starting any, so
+ * a thief never looks at a half-made one
+ ****************************************/
+inline fork_join_pool::fork_join_pool(size_t numThreads) :
+   numOutside(0), numSleeping(0), stopping(false)
+{
+   assert(numThreads > 0);
+   for (size_t i = 0; i < numThreads; i++)
+      workers.push_back(new Worker(this, i));
+   for (size_t i = 0; i < numThreads; i++)
+      threads.emplace_back(&fork_join_pool::loop, this, workers[i]);
+}
+
+/*****************************************
+ * FORK JOIN POOL :: DESTRUCTOR
+ * Wake everyone, wait for them to leave, and
+ * free the workers. Every group must be joined.
+ ****************************************/
+inline fork_join_pool::~fork_join_pool()
+{
+   {
+      std::lock_guard<std::mutex> lock(mutexSleep);
+      stopping.store(true, std::memory_order_release);
+   }
+   cvSleep.notify_all();
+   for (auto & thread : threads)
+      thread.join();
+   for (auto pWorker : workers)
+      delete pWorker;
+}
+
+/*****************************************
+ * FORK JOIN POOL :: SUBMIT
+ * A worker pushes onto its own deque; anyone
+ * else goes through the locked outside queue.
+ * Either way, wake a sleeper if there is one.
+ ****************************************/
+inline void fork_join_pool::submit(Task * pTask)
+{
+   Worker * pWorker = self();
+   if (pWorker)
+      pWorker->tasks.push(pTask);
+   else
+   {
+      std::lock_guard<std::mutex> lock(mutexOutside);
+      outside.push_back(pTask);
+      numOutside.fetch_add(1, std::memory_order_release);
+   }
+
+   if (numSleeping.load(std::memory_order_acquire))
+      cvSleep.notify_one();
+}
+
+/*****************************************
+ * FORK JOIN POOL :: FIND
+ * Own deque first, newest task first, since
+ * its data is likely still in cache. Then the
+ * outside queue, then the oldest task of each
+ * other worker in turn from a random start.
+ *     INPUT  : pWorker  who is looking
+ *     OUTPUT : the task, or nullptr
+ ****************************************/
+inline fork_join_pool::Task * fork_join_pool::find(Worker * pWorker)
+{
+   Task * pTask = nullptr;
+   if (pWorker->tasks.pop(pTask))
+      return pTask;
+
+   if (numOutside.load(std::memory_order_acquire))
+   {
+      std::lock_guard<std::mutex> lock(mutexOutside);
+      if (!outside.empty())
+      {
+         pTask = outside.front();
+         outside.pop_front();
+         numOutside.fetch_sub(1, std::memory_order_relaxed);
+         return pTask;
+      }
+   }
+
+   size_t num = workers.size();
+   pWorker->seed = pWorker->seed * 1103515245u + 12345u;
+   size_t start = (pWorker->seed >> 16) % num;
+   for (size_t i = 0; i < num; i++)
+   {
+      Worker * pVictim = workers[(start + i) % num];
+      if (pVictim != pWorker && pVictim->tasks.steal(pTask))
+         return pTask;
+   }
+   return nullptr;
+}
+
+/*****************************************
+ * FORK JOIN POOL :: EXECUTE
+ * Run the task, catching anything it throws
+ * for its group, then free it
+ ****************************************/
+inline void fork_join_pool::execute(Task * pTask)
+{
+   std::exception_ptr error;
+   try
+   {
+      pTask->execute();
+   }
+   catch (...)
+   {
+      error = std::current_exception();
+   }
+   task_group * pGroup = pTask->pGroup;
+   delete pTask;
+   pGroup->done(error);
+}
+
+/*****************************************
+ * FORK JOIN POOL :: LOOP
+ * Run tasks until the pool is destroyed,
+ * spinning a little before going to sleep
+ ****************************************/
+inline void fork_join_pool::loop(Worker * pWorker)
+{
+   const int numSpins = 64;
+   current() = pWorker;
+   int spins = 0;
+   while (!stopping.load(std::memory_order_acquire))
+   {
+      Task * pTask = find(pWorker);
+      if (pTask)
+      {
+         execute(pTask);
+         spins = 0;
+      }
+      else if (++spins < numSpins)
+         std::this_thread::yield();
+      else
+      {
+         std::unique_lock<std::mutex> lock(mutexSleep);
+         numSleeping.fetch_add(1, std::memory_order_acq_rel);
+         cvSleep.wait_for(lock, std::chrono::milliseconds(1), [&]
+         {
+            return stopping.load(std::memory_order_acquire) ||
+                   numOutside.load(std::memory_order_acquire) != 0;
+         });
+         numSleeping.fetch_sub(1, std::memory_order_acq_rel);
+         spins = 0;
+      }
+   }
+   current() = nullptr;
+}
+
+/*****************************************
+ * TASK GROUP :: SPAWN
+ * Count the task before it can run, so the
+ * group cannot look finished in between
+ *     INPUT  : f  what to run, taking no arguments
+ *     OUTPUT :
+ ****************************************/
+template <typename F>
+void task_group::spawn(F && f)
+{
+   numPending.fetch_add(1, std::memory_order_relaxed);
+   pool.submit(new fork_join_pool::TaskOf<F>(this, std::forward<F>(f)));
+}
+
+/*****************************************
+ * TASK GROUP :: JOIN
+ * Wait for every task spawned so far, and for
+ * what they spawned, then rethrow the first
+ * exception any of them threw
+ ****************************************/
+inline void task_group::join()
+{
+   wait();
+   std::exception_ptr thrown;
+   {
+      std::lock_guard<std::mutex> lock(mutexError);
+      std::swap(thrown, error);
+   }
+   if (thrown)
+      std::rethrow_exception(thrown);
+}
+
+/*****************************************
+ * TASK GROUP :: WAIT
+ * A worker keeps running tasks, any tasks,
+ * while it waits, so a pool of one can still
+ * join. A thread from outside sleeps until the
+ * last task of the group wakes it.
+ ****************************************/
+inline void task_group::wait()
+{
+   fork_join_pool::Worker * pWorker = pool.self();
+   if (pWorker)
+   {
+      while (numPending.load(std::memory_order_acquire) != 0)
+      {
+         fork_join_pool::Task * pTask = pool.find(pWorker);
+         if (pTask)
+            pool.execute(pTask);
+         else
+            std::this_thread::yield();
+      }
+   }
+   else
+   {
+      std::unique_lock<std::mutex> lock(pool.mutexSleep);
+      pool.cvJoin.wait(lock, [&]
+      {
+         return numPending.load(std::memory_order_acquire) == 0;
+      });
+   }
+}
+
+/*****************************************
+ * TASK GROUP :: DONE
+ * Record the error, if any, before the count
+ * drops: once it reaches zero the group may be
+ * destroyed, so the last task only touches the
+ * pool afterwards, to wake an outside join.
+ ****************************************/
+inline void task_group::done(std::exception_ptr thrown)
+{
+   if (thrown)
+   {
+      std::lock_guard<std::mutex> lock(mutexError);
+      if (!error)
+         error = thrown;
+   }
+
+   fork_join_pool & poolSaved = pool;
+   if (numPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+   {
+      std::lock_guard<std::mutex> lock(poolSaved.mutexSleep);
+      poolSaved.cvJoin.notify_all();
+   }
+}
+
+/*****************************************
+ * PARALLEL FOR
+ * Split [first, last) in halves, spawning the
+ * upper half each time, until a piece is no
+ * bigger than grain, then call f(begin, end) on
+ * it. The halves that are stolen are the big
+ * ones near the top of the deque, so a thief
+ * takes a lot of work per steal. A grain of 0
+ * picks one that gives each thread about eight
+ * pieces.
+ *     INPUT  : pool         where to run
+ *              first, last  the range of indexes
+ *              f            called as f(begin, end) on each piece
+ *              grain        the largest piece not split further
+ *     OUTPUT :
+ ****************************************/
+template <typename F>
+void parallel_for_split(task_group & group, size_t first, size_t last,
+                        size_t grain, const F & f)
+{
+   while (last - first > grain)
+   {
+      size_t mid = first + (last - first) / 2;
+      group.spawn([&group, mid, last, grain, &f]
+      {
+         parallel_for_split(group, mid, last, grain, f);
+      });
+      last = mid;
+   }
+   if (first != last)
+      f(first, last);
+}
+
+template <typename F>
+void parallel_for(fork_join_pool & pool, size_t first, size_t last,
+                  const F & f, size_t grain = 0)
+{
+   if (first >= last)
+      return;
+   if (grain == 0)
+   {
+      grain = (last - first) / (pool.size() * 8);
+      if (grain == 0)
+         grain = 1;
+   }
+   task_group group(pool);
+   parallel_for_split(group, first, last, grain, f);
+   group.join();
+}
+
+} // namespace custom
@@ -0,0 +1,517 @@
+/***********************************************************************
+ * Header:
+ *    SPSC QUEUE
+ * Summary:
+ *    Lock-free queues for handing elements from exactly one producer
+ *    thread to exactly one consumer thread. The producer owns the tail
+ *    and the consumer owns the head; each only reads the other's index,
+ *    with acquire/release ordering, so there is no lock and no
+ *    read-modify-write on the fast path.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        spsc_ring              : A bounded ring of a power of two slots
+ *        spsc_queue             : An unbounded chain of deque-sized blocks
+ * Author
+ *    Jacob Mower
+ *    Thatcher Albinston
+ *    Elroe Woldemichael
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // because I am paranoid
+#include <atomic>      // for std::atomic
+#include <new>         // for placement new
+#include <utility>     // for std::move
+#include "deque.h"     // for the block size and the index split
+
+class TestSpscQueue;   // forward declaration for unit tests
+
+namespace custom
+{
+
+/******************************************************
+ * CACHE LINE
+ * The producer and consumer indexes each get a line of
+ * their own, so one thread writing its index does not
+ * keep stealing the line the other is reading.
+ *****************************************************/
+const size_t cacheLine = 64;
+
+/******************************************************
+ * SPSC RING
+ * A bounded ring buffer. The capacity is rounded up to
+ * a power of two so a position splits with a mask. head
+ * and tail count every element ever popped and pushed;
+ * they only grow, so tail - head is the size even after
+ * they wrap the ring. Each side also keeps a private copy
+ * of the other's index and only reloads it when the copy
+ * says the ring is full (or empty).
+ *
+ * try_push and push_batch may only be called from one
+ * thread, and try_pop and pop_batch from one other.
+ *****************************************************/
+template <typename T>
+class spsc_ring
+{
+   friend class ::TestSpscQueue; // give unit tests access to the privates
+public:
+   explicit spsc_ring(size_t capacity);
+   spsc_ring(const spsc_ring &) = delete;
+   spsc_ring & operator = (const spsc_ring &) = delete;
+  ~spsc_ring();
+
+   //
+   // Producer
+   //
+   bool try_push(const T & t) { return emplace(t);            }
+   bool try_push(T && t)      { return emplace(std::move(t)); }
+   size_t push_batch(const T * p, size_t num);
+
+   //
+   // Consumer
+   //
+   bool try_pop(T & t);
+   size_t pop_batch(T * p, size_t num);
+
+   //
+   // Status. From any thread these are a snapshot.
+   //
+   size_t capacity() const { return mask + 1; }
+   size_t size() const
+   {
+      // head first: tail only grows, so it cannot come out behind
+      size_t headNow = head.load(std::memory_order_acquire);
+      return tail.load(std::memory_order_acquire) - headNow;
+   }
+   bool empty() const { return size() == 0; }
+
+private:
+   template <typename U>
+   bool emplace(U && u);
+
+   // round up to a power of two, at least two
+   static size_t roundUp(size_t num)
+   {
+      size_t cap = 2;
+      while (cap < num)
+         cap *= 2;
+      return cap;
+   }
+
+   // shared, set once
+   T * slots;
+   size_t mask;
+
+   // written by the consumer
+   alignas(cacheLine) std::atomic<size_t> head;
+   size_t tailCached;         // the consumer's last look at tail
+
+   // written by the producer
+   alignas(cacheLine) std::atomic<size_t> tail;
+   size_t headCached;         // the producer's last look at head
+
+   char pad[cacheLine - sizeof(size_t) * 2];
+};
+
+/******************************************************
+ * SPSC QUEUE
+ * An unbounded queue that never copies an element after
+ * it is pushed. Elements live in blocks of numCells laid
+ * out like a deque's, but the blocks are chained through
+ * a next pointer instead of a map, so the producer can
+ * add a block without the consumer noticing. The
+ * consumer hands an emptied block back through a
+ * one-block spare slot, so a queue in steady state does
+ * not touch the allocator.
+ *
+ * push, emplace and push_batch may only be called from
+ * one thread, and try_pop and pop_batch from one other.
+ *****************************************************/
+template <typename T, size_t N = dequeBlockCells(sizeof(T))>
+class spsc_queue : private deque_cells<N>
+{
+   friend class ::TestSpscQueue; // give unit tests access to the privates
+   using deque_cells<N>::numCells;
+   using deque_cells<N>::cellOf;
+
+   struct Block
+   {
+#ifdef DEBUG
+      Block() : next(nullptr) { numLive++; }
+     ~Block()                 { numLive--; }
+      static std::atomic<long> numLive;   // blocks not yet freed, for the unit tests
+#else // !DEBUG
+      Block() : next(nullptr) {}
+#endif // !DEBUG
+      T * cells() { return reinterpret_cast<T *>(storage); }
+
+      // set by the producer before it publishes the first element of
+      // the next block, so the consumer's acquire of tail covers it
+      Block * next;
+      alignas(T) unsigned char storage[N * sizeof(T)];
+   };
+
+public:
+   spsc_queue();
+   spsc_queue(const spsc_queue &) = delete;
+   spsc_queue & operator = (const spsc_queue &) = delete;
+  ~spsc_queue();
+
+   //
+   // Producer
+   //
+   void push(const T & t) { emplace(t);            }
+   void push(T && t)      { emplace(std::move(t)); }
+   template <typename ... Args>
+   void emplace(Args && ... args);
+   void push_batch(const T * p, size_t num);
+
+   //
+   // Consumer
+   //
+   bool try_pop(T & t);
+   size_t pop_batch(T * p, size_t num);
+
+   //
+   // Status. From any thread these are a snapshot.
+   //
+   size_t size() const
+   {
+      // head first: tail only grows, so it cannot come out behind
+      size_t headNow = head.load(std::memory_order_acquire);
+      return tail.load(std::memory_order_acquire) - headNow;
+   }
+   bool empty() const { return size() == 0; }
+
+private:
+   // the producer's raw cell for element pos, chaining a block when
+   // pos starts one
+   T * slotAt(size_t pos);
+
+   // the consumer's cell for element pos, stepping to the next block
+   // when pos starts one
+   T & cellAt(size_t pos);
+
+   // written by the consumer
+   alignas(cacheLine) std::atomic<size_t> head;
+   size_t tailCached;         // the consumer's last look at tail
+   Block * pHead;             // the block the consumer last popped from
+
+   // written by the producer
+   alignas(cacheLine) std::atomic<size_t> tail;
+   Block * pTail;             // the block holding tail
+
+   // handed from the consumer back to the producer
+   alignas(cacheLine) std::atomic<Block *> spare;
+   char pad[cacheLine - sizeof(Block *)];
+
+   static_assert(N != dynamic_cells, "spsc_queue needs a fixed block size");
+};
+
+#ifdef DEBUG
+template <typename T, size_t N>
+std::atomic<long> spsc_queue <T, N> ::Block::numLive(0);
+#endif // DEBUG
+
+/*****************************************
+ * SPSC RING :: CONSTRUCTOR
+ * Allocate the slots. None are constructed
+ * until something is pushed into them.
+ ****************************************/
+template <typename T>
+spsc_ring <T> ::spsc_ring(size_t capacity) :
+   slots(nullptr), mask(roundUp(capacity) - 1),
+   head(0), tailCached(0), tail(0), headCached(0)
+{
+   slots = std::allocator<T>().allocate(mask + 1);
+}
+
+/*****************************************
+ * SPSC RING :: DESTRUCTOR
+ * Destroy whatever was never popped. Both
+ * threads must be finished with the ring.
+ ****************************************/
+template <typename T>
+spsc_ring <T> ::~spsc_ring()
+{
+   size_t tailNow = tail.load(std::memory_order_relaxed);
+   for (size_t pos = head.load(std::memory_order_relaxed); pos != tailNow; pos++)
+      slots[pos & mask].~T();
+   std::allocator<T>().deallocate(slots, mask + 1);
+}
+
+/*****************************************
+ * SPSC RING :: EMPLACE
+ * Build the element in the next slot, then
+ * publish it with a release store of tail.
+ *     INPUT  : u  the element
+ *     OUTPUT : false if the ring was full
+ ****************************************/
+template <typename T>
+template <typename U>
+bool spsc_ring <T> ::emplace(U && u)
+{
+   size_t pos = tail.load(std::memory_order_relaxed);
+   if (pos - headCached > mask)
+   {
+      headCached = head.load(std::memory_order_acquire);
+      if (pos - headCached > mask)
+         return false;
+   }
+   new ((void *)&slots[pos & mask]) T(std::forward<U>(u));
+   tail.store(pos + 1, std::memory_order_release);
+   return true;
+}
+
+/*****************************************
+ * SPSC RING :: PUSH BATCH
+ * Copy as many as fit, with one release store
+ * for the lot
+ *     INPUT  : p    the elements
+ *              num  how many of them
+ *     OUTPUT : how many were pushed
+ ****************************************/
+template <typename T>
+size_t spsc_ring <T> ::push_batch(const T * p, size_t num)
+{
+   size_t pos = tail.load(std::memory_order_relaxed);
+   if (capacity() - (pos - headCached) < num)
+      headCached = head.load(std::memory_order_acquire);
+   size_t numFree = capacity() - (pos - headCached);
+   if (num > numFree)
+      num = numFree;
+
+   for (size_t i = 0; i < num; i++)
+      new ((void *)&slots[(pos + i) & mask]) T(p[i]);
+   if (num)
+      tail.store(pos + num, std::memory_order_release);
+   return num;
+}
+
+/*****************************************
+ * SPSC RING :: TRY POP
+ * Move the front element out and free its slot
+ * with a release store of head
+ *     INPUT  : t  where the element goes
+ *     OUTPUT : false if the ring was empty
+ ****************************************/
+template <typename T>
+bool spsc_ring <T> ::try_pop(T & t)
+{
+   size_t pos = head.load(std::memory_order_relaxed);
+   if (pos == tailCached)
+   {
+      tailCached = tail.load(std::memory_order_acquire);
+      if (pos == tailCached)
+         return false;
+   }
+   T & slot = slots[pos & mask];
+   t = std::move(slot);
+   slot.~T();
+   head.store(pos + 1, std::memory_order_release);
+   return true;
+}
+
+/*****************************************
+ * SPSC RING :: POP BATCH
+ * Move out up to num elements, with one release
+ * store for the lot
+ *     INPUT  : p    where the elements go
+ *              num  room at p
+ *     OUTPUT : how many were popped
+ ****************************************/
+template <typename T>
+size_t spsc_ring <T> ::pop_batch(T * p, size_t num)
+{
+   size_t pos = head.load(std::memory_order_relaxed);
+   if (tailCached - pos < num)
+      tailCached = tail.load(std::memory_order_acquire);
+   if (num > tailCached - pos)
+      num = tailCached - pos;
+
+   for (size_t i = 0; i < num; i++)
+   {
+      T & slot = slots[(pos + i) & mask];
+      p[i] = std::move(slot);
+      slot.~T();
+   }
+   if (num)
+      head.store(pos + num, std::memory_order_release);
+   return num;
+}
+
+/*****************************************
+ * SPSC QUEUE :: CONSTRUCTOR
+ * Start with one empty block shared by both ends
+ ****************************************/
+template <typename T, size_t N>
+spsc_queue <T, N> ::spsc_queue() :
+   head(0), tailCached(0), pHead(nullptr), tail(0), pTail(nullptr), spare(nullptr)
+{
+   pHead = pTail = new Block;
+}
+
+/*****************************************
+ * SPSC QUEUE :: DESTRUCTOR
+ * Destroy whatever was never popped and free
+ * the chain. Both threads must be finished.
+ ****************************************/
+template <typename T, size_t N>
+spsc_queue <T, N> ::~spsc_queue()
+{
+   size_t tailNow = tail.load(std::memory_order_relaxed);
+   for (size_t pos = head.load(std::memory_order_relaxed); pos != tailNow; pos++)
+   {
+      if (pos != 0 && cellOf(pos) == 0)
+      {
+         Block * pOld = pHead;
+         pHead = pHead->next;
+         delete pOld;
+      }
+      pHead->cells()[cellOf(pos)].~T();
+   }
+   while (pHead)
+   {
+      Block * pNext = pHead->next;
+      delete pHead;
+      pHead = pNext;
+   }
+   delete spare.load(std::memory_order_relaxed);
+}
+
+/*****************************************
+ * SPSC QUEUE :: SLOT AT
+ * The raw cell for element pos. When pos starts
+ * a new block, take the spare if the consumer
+ * left one, otherwise allocate, and link it on.
+ ****************************************/
+template <typename T, size_t N>
+T * spsc_queue <T, N> ::slotAt(size_t pos)
+{
+   if (pos != 0 && cellOf(pos) == 0)
+   {
+      Block * pBlock = spare.exchange(nullptr, std::memory_order_acquire);
+      if (pBlock)
+         pBlock->next = nullptr;
+      else
+         pBlock = new Block;
+      pTail->next = pBlock;
+      pTail = pBlock;
+   }
+   return pTail->cells() + cellOf(pos);
+}
+
+/*****************************************
+ * SPSC QUEUE :: EMPLACE
+ * Build the element in place, then publish it
+ *     INPUT  : args  for T's constructor
+ *     OUTPUT :
+ ****************************************/
+template <typename T, size_t N>
+template <typename ... Args>
+void spsc_queue <T, N> ::emplace(Args && ... args)
+{
+   size_t pos = tail.load(std::memory_order_relaxed);
+   new ((void *)slotAt(pos)) T(std::forward<Args>(args)...);
+   tail.store(pos + 1, std::memory_order_release);
+}
+
+/*****************************************
+ * SPSC QUEUE :: PUSH BATCH
+ * Copy num elements in, block by block, and
+ * publish them with one release store
+ *     INPUT  : p    the elements
+ *              num  how many of them
+ *     OUTPUT :
+ ****************************************/
+template <typename T, size_t N>
+void spsc_queue <T, N> ::push_batch(const T * p, size_t num)
+{
+   size_t pos = tail.load(std::memory_order_relaxed);
+   for (size_t i = 0; i < num; i++)
+      new ((void *)slotAt(pos + i)) T(p[i]);
+   tail.store(pos + num, std::memory_order_release);
+}
+
+/*****************************************
+ * SPSC QUEUE :: CELL AT
+ * The consumer's cell for element pos. Stepping
+ * into a new block offers the old one back to the
+ * producer; if it has not taken the last one yet,
+ * the old one is freed instead.
+ ****************************************/
+template <typename T, size_t N>
+T & spsc_queue <T, N> ::cellAt(size_t pos)
+{
+   if (pos != 0 && cellOf(pos) == 0)
+   {
+      Block * pOld = pHead;
+      pHead = pHead->next;
+      Block * pEmpty = nullptr;
+      if (!spare.compare_exchange_strong(pEmpty, pOld, std::memory_order_release,
+                                         std::memory_order_relaxed))
+         delete pOld;
+   }
+   return pHead->cells()[cellOf(pos)];
+}
+
+/*****************************************
+ * SPSC QUEUE :: TRY POP
+ * Move the front element out and free its cell
+ * with a release store of head
+ *     INPUT  : t  where the element goes
+ *     OUTPUT : false if the queue was empty
+ ****************************************/
+template <typename T, size_t N>
+bool spsc_queue <T, N> ::try_pop(T & t)
+{
+   size_t pos = head.load(std::memory_order_relaxed);
+   if (pos == tailCached)
+   {
+      tailCached = tail.load(std::memory_order_acquire);
+      if (pos == tailCached)
+         return false;
+   }
+   T & cell = cellAt(pos);
+   t = std::move(cell);
+   cell.~T();
+   head.store(pos + 1, std::memory_order_release);
+   return true;
+}
+
+/*****************************************
+ * SPSC QUEUE :: POP BATCH
+ * Move out up to num elements, with one release
+ * store for the lot
+ *     INPUT  : p    where the elements go
+ *              num  room at p
+ *     OUTPUT : how many were popped
+ ****************************************/
+template <typename T, size_t N>
+size_t spsc_queue <T, N> ::pop_batch(T * p, size_t num)
+{
+   size_t pos = head.load(std::memory_order_relaxed);
+   if (tailCached - pos < num)
+      tailCached = tail.load(std::memory_order_acquire);
+   if (num > tailCached - pos)
+      num = tailCached - pos;
+
+   for (size_t i = 0; i < num; i++)
+   {
+      T & cell = cellAt(pos + i);
+      p[i] = std::move(cell);
+      cell.~T();
+   }
+   if (num)
+      head.store(pos + num, std::memory_order_release);
+   return num;
+}
+
+} // namespace custom
@@ -11,9 +11,16 @@
 #define DEBUG   
 #endif
  //#undef DEBUG  // Remove this comment to disable unit tests
+//#define BENCHMARK  // Remove this comment to time the containers and the pool
+//#define STRESS     // Remove this comment to run the 2^31 element stress test
 
 #include "testDeque.h"       // for the deque unit tests
+#include "testSpscQueue.h"   // for the lock-free queue unit tests
+#include "testForkJoinPool.h"  // for the work-stealing pool unit tests
 #include "testSpy.h"         // for the spy unit tests
+#include "benchDeque.h"      // for the deque benchmark
+#include "benchSpsc.h"       // for the lock-free queue benchmark
+#include "benchForkJoinPool.h" // for the work-stealing pool benchmark
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -26,7 +33,15 @@ int main()
    // unit tests
    TestSpy().run();
    TestDeque().run();
+   TestSpscQueue().run();
+   TestForkJoinPool().run();
 #endif // DEBUG
+
+#ifdef BENCHMARK
+   BenchDeque().run();
+   BenchSpsc().run();
+   BenchForkJoinPool().run();
+#endif // BENCHMARK
    
    return 0;
 }
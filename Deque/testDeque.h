@@ -20,6 +20,28 @@
 #include "spy.h"
 
 #include <deque>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+
+/***************************************
+ * COUNT ALLOCATOR
+ * std::allocator that counts the blocks handed out
+ ***************************************/
+template <class T>
+struct CountAllocator : public std::allocator<T>
+{
+   template <class U> struct rebind { typedef CountAllocator<U> other; };
+   T * allocate(size_t n)
+   {
+      numAllocate++;
+      return std::allocator<T>::allocate(n);
+   }
+   static int numAllocate;
+};
+template <class T>
+int CountAllocator<T>::numAllocate = 0;
 
 class TestDeque : public UnitTest
 {
@@ -40,6 +62,9 @@ public:
       test_realloc_shift();
       test_realloc_wrapBetweenBlocks();
       test_realloc_complex();
+      test_cells_default();
+      test_cells_fixedSplit();
+      test_cells_fixedPushPop();
 
       // Construct
       test_construct_default();
@@ -72,6 +97,20 @@ public:
       test_iterator_add_withinBlock();
       test_iterator_add_betweenBlocks();
       test_iterator_difference_standard();
+      test_iterator_increment_cachesCell();
+      test_iterator_increment_crossBlock();
+      test_iterator_decrement_crossBlock();
+      test_iterator_jump_wrapped();
+      test_iterator_compare_standard();
+      test_iterator_sort();
+      test_iterator_lowerBound();
+
+      // Segments
+      test_segments_empty();
+      test_segments_standard();
+      test_segments_wrapped();
+      test_segments_memcpy();
+      test_segments_write();
 
       // Access
       test_back_readStandard();
@@ -115,12 +154,41 @@ public:
       test_popback_lastInBlock();
       test_popback_complex();
 
+      // Insert and erase
+      test_insert_nearFront();
+      test_insert_nearBack();
+      test_insert_ends();
+      test_insert_movesShorterSide();
+      test_insert_rangeLong();
+      test_insert_rangeShort();
+      test_insert_rangeInput();
+      test_erase_single();
+      test_erase_range();
+      test_insertErase_random();
+
+      // Spare blocks
+      test_spare_popKeepsBlock();
+      test_spare_pushReusesBlock();
+      test_spare_queueNoAllocate();
+      test_spare_limit();
+
+      // Shrink
+      test_shrink_empty();
+      test_shrink_keepsElements();
+      test_shrink_reallocSplitsBlock();
+      test_shrink_auto();
+      test_shrink_autoOff();
+
       // Status
       test_size_empty();
       test_size_standard();
       test_empty_empty();
       test_empty_standard();
 
+#ifdef STRESS
+      // Stress
+      test_stress_over2G();
+#endif // STRESS
 
       report("Deque");
    }
@@ -140,7 +208,7 @@ public:
       //        +----+----+----+----+
       //        | 0  | 1  | 2  | 3  |
       //        +----+----+----+----+     
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 4;
       d.numCells = 1;
       d.iaFront = 2;
@@ -169,7 +237,7 @@ public:
       //                      +----+----+----+
       //                      | 0  | 1  | 2  |
       //                      +----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 3;
       d.numCells = 3;
       d.iaFront = 4;
@@ -208,7 +276,7 @@ public:
       //        +----+----+----+----+
       //        | 0  | 1  | 2  | 3  |
       //        +----+----+----+----+     
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 4;
       d.numCells = 1;
       d.iaFront = 2;
@@ -237,7 +305,7 @@ public:
       //                      +----+----+----+
       //                      | 0  | 1  | 2  |
       //                      +----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 3;
       d.numCells = 3;
       d.iaFront = 4;
@@ -276,7 +344,7 @@ public:
       //        +----+----+----+----+
       //        | 0  | 1  | 2  | 3  |
       //        +----+----+----+----+     
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 4;
       d.numCells = 1;
       d.iaFront = 2;
@@ -305,7 +373,7 @@ public:
       //                      +----+----+----+
       //                      | 0  | 1  | 2  |
       //                      +----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 3;
       d.numCells = 3;
       d.iaFront = 4;
@@ -340,7 +408,7 @@ public:
    // no blocks to one
    void test_realloc_emptyToOne()
    {  // setup
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 4;
       Spy::reset();
       // exercise
@@ -380,7 +448,7 @@ public:
       //         +----+
       //         |    |
       //         +----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 3;
       d.numElements = 1;
       d.numBlocks = 1;
@@ -437,7 +505,7 @@ public:
       //    +----+----+
       //    | // |    |
       //    +----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 3;
       d.numElements = 3;
       d.numBlocks = 2;
@@ -504,7 +572,7 @@ public:
       //       +----+----+----+----+
       //       |    | // | // |    |
       //       +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 2;
       d.numElements = 3;
       d.numBlocks = 4;
@@ -577,7 +645,7 @@ public:
       //                      +----+----+----+
       //                      |    |    |    |
       //                      +----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 3;
       d.numElements = 8;
       d.numBlocks = 3;
@@ -651,6 +719,66 @@ public:
       teardownStandardFixture(d);
    }
 
+   // the default block is about 4KB, a power of two, and never empty
+   void test_cells_default()
+   {  // setup
+      // exercise
+      size_t cellsInt  = custom::deque<int>::numCells;
+      size_t cellsChar = custom::deque<char>::numCells;
+      size_t cellsBig  = custom::deque<char[5000]>::numCells;
+      // verify
+      assertUnit(cellsInt  == 1024);
+      assertUnit(cellsChar == 4096);
+      assertUnit(cellsBig  == 1);
+      assertUnit((custom::deque<int, 4>::cellShift == 2));
+   }  // teardown
+
+   // a fixed block size splits an index with a shift and a mask
+   void test_cells_fixedSplit()
+   {  // setup
+      //                         iaFront
+      //   +----+----+----+----+   +----+----+----+----+
+      //   |    |    |    |    |   |    | 26 | 49 | 67 |
+      //   +----+----+----+----+   +----+----+----+----+
+      custom::deque<int, 4> d;
+      d.numBlocks = 2;
+      d.iaFront = 5;
+      // exercise
+      int ia0 = d.iaFromID(0);
+      int ia3 = d.iaFromID(3);
+      int ia4 = d.iaFromID(4);
+      // verify
+      assertUnit(ia0 == 5);
+      assertUnit(ia3 == 0);
+      assertUnit(ia4 == 1);
+      assertUnit(d.ibFromID(0) == 1);
+      assertUnit(d.icFromID(0) == 1);
+      assertUnit(d.ibFromID(4) == 0);
+      assertUnit(d.icFromID(4) == 1);
+      // teardown
+      d.numBlocks = 0;
+      d.iaFront = 0;
+   }
+
+   // pushing and popping at both ends across fixed blocks
+   void test_cells_fixedPushPop()
+   {  // setup
+      custom::deque<int, 4> d;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         d.push_back(i);
+      for (int i = 1; i <= 10; i++)
+         d.push_front(-i);
+      d.pop_front();
+      d.pop_back();
+      // verify
+      assertUnit(d.size() == 18);
+      assertUnit(d.front() == -9);
+      assertUnit(d.back() == 8);
+      for (int id = 0; id < 18; id++)
+         assertUnit(d[id] == id - 9);
+   }  // teardown
+
    /***************************************
     * CONSTRUCTORS
     ***************************************/
@@ -658,8 +786,8 @@ public:
    // default constructor, no allocations
    void test_construct_default()
    {  // setup
-      std::allocator<custom::deque<Spy>> alloc;
-      custom::deque<Spy> d;
+      std::allocator<custom::deque<Spy, custom::dynamic_cells>> alloc;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.iaFront = 66;
       d.numCells = 77;
       d.numBlocks = 88;
@@ -688,7 +816,7 @@ public:
     // size of empty deque
    void test_size_empty()
    {  // setup
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       Spy::reset();
       // exercise
       size_t s = d.size();
@@ -717,7 +845,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -741,7 +869,7 @@ public:
    // whether an empty deque is empty
    void test_empty_empty()
    {  // setup
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       Spy::reset();
       // exercise
       bool f = d.empty();
@@ -770,7 +898,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -799,10 +927,10 @@ public:
    // copy an empty deque
    void test_constructCopy_empty() 
    {  // setup
-      custom::deque<Spy> dSrc;
+      custom::deque<Spy, custom::dynamic_cells> dSrc;
       Spy::reset();
       // exercise
-      custom::deque<Spy> dDes(dSrc);
+      custom::deque<Spy, custom::dynamic_cells> dDes(dSrc);
       // verify
       assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numAlloc() == 0);
@@ -828,11 +956,11 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> dSrc;
+      custom::deque<Spy, custom::dynamic_cells> dSrc;
       setupStandardFixture(dSrc);
       Spy::reset();
       // exercise
-      custom::deque<Spy> dDes(dSrc);
+      custom::deque<Spy, custom::dynamic_cells> dDes(dSrc);
       // verify
       assertUnit(Spy::numCopy() == 4);    // copy [31, 49, 55, 67]
       assertUnit(Spy::numAlloc() == 4);   // allocate [31, 49, 55, 67]
@@ -879,7 +1007,7 @@ public:
       //   +----+----+----+----+----+----+----+
       //   |    | // | // | // | // | // |    |
       //   +----+----+----+----+----+----+----+
-      custom::deque<Spy> dSrc;
+      custom::deque<Spy, custom::dynamic_cells> dSrc;
       dSrc.numCells = 3;
       dSrc.numElements = 3;
       dSrc.numBlocks = 7;
@@ -897,7 +1025,7 @@ public:
       dSrc.iaFront = 20;
       Spy::reset();
       // exercise
-      custom::deque<Spy> dDes(dSrc);
+      custom::deque<Spy, custom::dynamic_cells> dDes(dSrc);
       // verify
       assertUnit(Spy::numCopy() == 3);    // copy [59, 67, 79]
       assertUnit(Spy::numAlloc() == 3);   // allocate [59, 67, 79]
@@ -939,7 +1067,7 @@ public:
    void test_destruct_default()
    {  // setup
       {
-         custom::deque <Spy> d;
+         custom::deque <Spy, custom::dynamic_cells> d;
          d.iaFront = 0;
          d.numBlocks = 0;
          d.numCells = 16;
@@ -971,7 +1099,7 @@ public:
       //          +----+
       {
          std::allocator<Spy> alloc;
-         custom::deque <Spy> d;
+         custom::deque <Spy, custom::dynamic_cells> d;
          d.iaFront = 0;
          d.numBlocks = 1;
          d.numCells = 7;
@@ -1004,7 +1132,7 @@ public:
       //          +----+
       {
          std::allocator<Spy> alloc;
-         custom::deque <Spy> d;
+         custom::deque <Spy, custom::dynamic_cells> d;
          d.iaFront = 0;
          d.numBlocks = 1;
          d.numCells = 7;
@@ -1044,7 +1172,7 @@ public:
       //          +----+
       {
          std::allocator<Spy> alloc;
-         custom::deque <Spy> d;
+         custom::deque <Spy, custom::dynamic_cells> d;
          d.iaFront = 2;
          d.numBlocks = 1;
          d.numCells = 7;
@@ -1080,7 +1208,7 @@ public:
       //          +----+----+----+----+
       {
          std::allocator<Spy> alloc;
-         custom::deque <Spy> d;
+         custom::deque <Spy, custom::dynamic_cells> d;
          d.iaFront = 3;
          d.numBlocks = 4;
          d.numCells = 3;
@@ -1121,7 +1249,7 @@ public:
       //          | // |    |    | // |
       //          +----+----+----+----+
       {
-         custom::deque<Spy> d;
+         custom::deque<Spy, custom::dynamic_cells> d;
          setupStandardFixture(d);
          Spy::reset();
       }  // exercise
@@ -1143,8 +1271,8 @@ public:
    // assignment when there is nothing to copy
    void test_assign_emptyToEmpty()
    {  // setup
-      custom::deque <Spy> dSrc;
-      custom::deque <Spy> dDes;
+      custom::deque <Spy, custom::dynamic_cells> dSrc;
+      custom::deque <Spy, custom::dynamic_cells> dDes;
       Spy::reset();
       // exercise
       dDes = dSrc;
@@ -1173,9 +1301,9 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> dSrc;
+      custom::deque<Spy, custom::dynamic_cells> dSrc;
       setupStandardFixture(dSrc);
-      custom::deque<Spy> dDes;
+      custom::deque<Spy, custom::dynamic_cells> dDes;
       setupStandardFixture(dDes);
       Spy::reset();
       // exercise
@@ -1208,9 +1336,9 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> dSrc;
+      custom::deque<Spy, custom::dynamic_cells> dSrc;
       setupStandardFixture(dSrc);
-      custom::deque<Spy> dDes;
+      custom::deque<Spy, custom::dynamic_cells> dDes;
       Spy::reset();
       // exercise
       dDes = dSrc;
@@ -1252,7 +1380,7 @@ public:
    // assignment when the destination is bigger than the source
    void test_assign_emptyToStandard()
    {  // setup
-      custom::deque<Spy> dSrc;
+      custom::deque<Spy, custom::dynamic_cells> dSrc;
       //      0     1    2       0    1    2
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -1261,7 +1389,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> dDes;
+      custom::deque<Spy, custom::dynamic_cells> dDes;
       setupStandardFixture(dDes);
       Spy::reset();
       // exercise
@@ -1297,7 +1425,7 @@ public:
       //   +----+----+----+----+----+----+----+
       //   |    | // | // | // | // | // |    |
       //   +----+----+----+----+----+----+----+
-      custom::deque<Spy> dSrc;
+      custom::deque<Spy, custom::dynamic_cells> dSrc;
       dSrc.numCells = 3;
       dSrc.numElements = 3;
       dSrc.numBlocks = 7;
@@ -1313,7 +1441,7 @@ public:
       dSrc.alloc.construct(&dSrc.data[0][0], Spy(67));
       dSrc.alloc.construct(&dSrc.data[0][1], Spy(79));
       dSrc.iaFront = 20;
-      custom::deque<Spy> dDes;
+      custom::deque<Spy, custom::dynamic_cells> dDes;
       Spy::reset();
       // exercise
       dDes = dSrc;
@@ -1358,7 +1486,7 @@ public:
    // clear an empty collection
    void test_clear_empty()
    {  // setup
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       Spy::reset();
       // exercise
       d.clear();
@@ -1386,7 +1514,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -1427,7 +1555,7 @@ public:
    // add an element when the deque is empty
    void test_pushback_empty()
    {  // setup
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 5;
       Spy s(99);
       Spy::reset();
@@ -1473,7 +1601,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -1525,7 +1653,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       new((void*)(&(d.data[2][2]))) Spy(79);
       d.numElements++;
@@ -1589,7 +1717,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 4;
       d.numElements = 2;
       d.numBlocks = 1;
@@ -1653,7 +1781,7 @@ public:
       //                      +----+----+----+
       //                      |    |    |    |
       //                      +----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 3;
       d.numElements = 8;
       d.numBlocks = 3;
@@ -1739,7 +1867,7 @@ public:
     // add an element when the deque is empty
    void test_pushfront_empty()
    {  // setup
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 5;
       Spy s(99);
       Spy::reset();
@@ -1786,7 +1914,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -1841,7 +1969,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       new((void*)(&(d.data[1][0]))) Spy(28);
       d.iaFront--;
@@ -1910,7 +2038,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 4;
       d.numElements = 2;
       d.numBlocks = 1;
@@ -1977,7 +2105,7 @@ public:
       //                      +----+----+----+
       //                      |    |    |    |
       //                      +----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 3;
       d.numElements = 8;
       d.numBlocks = 3;
@@ -2068,7 +2196,7 @@ public:
       //   +----+----+----+----+----+----+----+
       //   |    | // | // | // | // | // | // |
       //   +----+----+----+----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 3;
       d.numElements = 2;
       d.numBlocks = 7;
@@ -2151,7 +2279,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -2205,7 +2333,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 4;
       d.numElements = 3;
       d.numBlocks = 1;
@@ -2267,7 +2395,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 4;
       d.numElements = 1;
       d.numBlocks = 1;
@@ -2314,7 +2442,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       d.alloc.destroy(&d.data[1][1]);
       d.iaFront++;
@@ -2373,7 +2501,7 @@ public:
       //   +----+----+----+----+----+----+----+
       //   |    | // | // | // | // | // |    |
       //   +----+----+----+----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 3;
       d.numElements = 3;
       d.numBlocks = 7;
@@ -2451,7 +2579,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -2503,7 +2631,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 4;
       d.numElements = 2;
       d.numBlocks = 1;
@@ -2563,7 +2691,7 @@ public:
       //            +----+
       //            |    |
       //            +----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 4;
       d.numElements = 1;
       d.numBlocks = 1;
@@ -2610,7 +2738,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       d.alloc.destroy(&d.data[2][1]);
       d.numElements--;
@@ -2668,7 +2796,7 @@ public:
       //   +----+----+----+----+----+----+----+
       //   |    | // | // | // | // | // |    |
       //   +----+----+----+----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numCells = 3;
       d.numElements = 3;
       d.numBlocks = 7;
@@ -2732,6 +2860,311 @@ public:
    }
 
 
+   /***************************************
+    * INSERT AND ERASE
+    ***************************************/
+
+   // inserting near the front moves the front, and the back stays put
+   void test_insert_nearFront()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 10; i++)
+         d.push_back(i);
+      int * pBack = &d[9];
+      // exercise
+      custom::deque<int, 4>::iterator it = d.insert(d.begin() + 2, 99);
+      // verify
+      assertUnit(it - d.begin() == 2);
+      assertUnit(*it == 99);
+      assertUnit(d.size() == 11);
+      assertUnit(&d[10] == pBack);
+      assertUnit(d[0] == 0);
+      assertUnit(d[1] == 1);
+      assertUnit(d[2] == 99);
+      assertUnit(d[3] == 2);
+      assertUnit(d[10] == 9);
+   }  // teardown
+
+   // inserting near the back moves the back, and the front stays put
+   void test_insert_nearBack()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 10; i++)
+         d.push_back(i);
+      int * pFront = &d[0];
+      // exercise
+      custom::deque<int, 4>::iterator it = d.insert(d.begin() + 7, 99);
+      // verify
+      assertUnit(*it == 99);
+      assertUnit(d.size() == 11);
+      assertUnit(&d[0] == pFront);
+      assertUnit(d[6] == 6);
+      assertUnit(d[7] == 99);
+      assertUnit(d[8] == 7);
+      assertUnit(d[10] == 9);
+   }  // teardown
+
+   // inserting at either end is a push
+   void test_insert_ends()
+   {  // setup
+      custom::deque<int, 4> d;
+      // exercise
+      d.insert(d.begin(), 2);
+      d.insert(d.end(), 3);
+      d.insert(d.begin(), 1);
+      d.insert(d.end(), 4);
+      // verify
+      assertUnit(d.size() == 4);
+      assertUnit(d[0] == 1);
+      assertUnit(d[1] == 2);
+      assertUnit(d[2] == 3);
+      assertUnit(d[3] == 4);
+   }  // teardown
+
+   // only the shorter side is moved, and by moving, not copying
+   void test_insert_movesShorterSide()
+   {  // setup
+      custom::deque<Spy, 4> d;
+      for (int i = 0; i < 10; i++)
+         d.push_back(Spy(i));
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      d.insert(d.begin() + 2, std::move(s));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 1);     // push 0 on the front
+      assertUnit(Spy::numAssignMove() == 2);   // slide 1 down, 99 into place
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(d[2] == Spy(99));
+      assertUnit(d[3] == Spy(2));
+   }  // teardown
+
+   // a range longer than the side it is pushed into
+   void test_insert_rangeLong()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 10; i++)
+         d.push_back(i);
+      int values[] = { 90, 91, 92, 93, 94, 95, 96 };
+      // exercise
+      custom::deque<int, 4>::iterator it = d.insert(d.begin() + 3, values, values + 7);
+      // verify
+      assertUnit(it - d.begin() == 3);
+      assertUnit(d.size() == 17);
+      assertUnit(d[2] == 2);
+      assertUnit(d[3] == 90);
+      assertUnit(d[9] == 96);
+      assertUnit(d[10] == 3);
+      assertUnit(d[16] == 9);
+   }  // teardown
+
+   // a range shorter than the side it is pushed into
+   void test_insert_rangeShort()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 20; i++)
+         d.push_back(i);
+      int values[] = { 90, 91 };
+      // exercise
+      d.insert(d.begin() + 15, values, values + 2);
+      // verify
+      assertUnit(d.size() == 22);
+      assertUnit(d[14] == 14);
+      assertUnit(d[15] == 90);
+      assertUnit(d[16] == 91);
+      assertUnit(d[17] == 15);
+      assertUnit(d[21] == 19);
+   }  // teardown
+
+   // a single-pass range is read once
+   void test_insert_rangeInput()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 5; i++)
+         d.push_back(i);
+      std::istringstream in("7 8 9");
+      // exercise
+      custom::deque<int, 4>::iterator it = d.insert(d.begin() + 2,
+         std::istream_iterator<int>(in), std::istream_iterator<int>());
+      // verify
+      assertUnit(it - d.begin() == 2);
+      assertUnit(d.size() == 8);
+      assertUnit(d[1] == 1);
+      assertUnit(d[2] == 7);
+      assertUnit(d[3] == 8);
+      assertUnit(d[4] == 9);
+      assertUnit(d[5] == 2);
+      assertUnit(d[7] == 4);
+   }  // teardown
+
+   // erase one element from each half
+   void test_erase_single()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 10; i++)
+         d.push_back(i);
+      int * pBack = &d[9];
+      int * pFront = &d[0];
+      // exercise
+      custom::deque<int, 4>::iterator it = d.erase(d.begin() + 2);
+      // verify
+      assertUnit(*it == 3);
+      assertUnit(&d[8] == pBack);
+      // exercise
+      it = d.erase(d.begin() + 6);
+      // verify
+      assertUnit(*it == 8);
+      assertUnit(&d[0] == pFront + 1);
+      assertUnit(d.size() == 8);
+      assertUnit(d[1] == 1);
+      assertUnit(d[2] == 3);
+      assertUnit(d[5] == 6);
+      assertUnit(d[6] == 8);
+   }  // teardown
+
+   // erase a run that spans blocks, and then everything
+   void test_erase_range()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 20; i++)
+         d.push_back(i);
+      // exercise
+      custom::deque<int, 4>::iterator it = d.erase(d.begin() + 3, d.begin() + 11);
+      // verify
+      assertUnit(it - d.begin() == 3);
+      assertUnit(*it == 11);
+      assertUnit(d.size() == 12);
+      assertUnit(d[2] == 2);
+      assertUnit(d[11] == 19);
+      // exercise
+      it = d.erase(d.begin(), d.end());
+      // verify
+      assertUnit(d.empty());
+      assertUnit(it == d.end());
+   }  // teardown
+
+   // a long random run of edits matches std::deque
+   void test_insertErase_random()
+   {  // setup
+      custom::deque<int, 4> d;
+      std::deque<int> dStd;
+      unsigned int seed = 26;
+      bool same = true;
+      // exercise
+      for (int i = 0; i < 2000 && same; i++)
+      {
+         seed = seed * 1103515245 + 12345;
+         size_t id = (seed >> 8) % (dStd.size() + 1);
+         size_t num = (seed >> 20) % 6;
+         if ((seed >> 16) % 3 != 0)
+         {
+            int values[5] = { i, i + 1, i + 2, i + 3, i + 4 };
+            if (num == 0)
+            {
+               d.insert(d.begin() + id, i);
+               dStd.insert(dStd.begin() + id, i);
+            }
+            else
+            {
+               d.insert(d.begin() + id, values, values + num - 1);
+               dStd.insert(dStd.begin() + id, values, values + num - 1);
+            }
+         }
+         else
+         {
+            if (num > dStd.size() - id)
+               num = dStd.size() - id;
+            d.erase(d.begin() + id, d.begin() + (id + num));
+            dStd.erase(dStd.begin() + id, dStd.begin() + (id + num));
+         }
+         same = d.size() == dStd.size() && std::equal(dStd.begin(), dStd.end(), d.begin());
+      }
+      // verify
+      assertUnit(same);
+      assertUnit(d.size() == dStd.size());
+   }  // teardown
+
+   /***************************************
+    * SPARE BLOCKS
+    ***************************************/
+
+   // popping the last element of a block keeps the block as a spare
+   void test_spare_popKeepsBlock()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 5; i++)
+         d.push_back(i);
+      int * pFirstBlock = d.data[0];
+      // exercise
+      for (int i = 0; i < 4; i++)
+         d.pop_front();
+      // verify
+      assertUnit(d.size() == 1);
+      assertUnit(d.data[0] == nullptr);
+      assertUnit(d.spare_blocks() == 1);
+      assertUnit(d.spares[0] == pFirstBlock);
+      assertUnit(d.front() == 4);
+   }  // teardown
+
+   // the next push that needs a block takes the spare
+   void test_spare_pushReusesBlock()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 5; i++)
+         d.push_back(i);
+      int * pBackBlock = d.data[1];
+      d.pop_back();
+      assertUnit(d.spare_blocks() == 1);
+      // exercise
+      d.push_back(99);
+      // verify
+      assertUnit(d.spare_blocks() == 0);
+      assertUnit(d.data[1] == pBackBlock);
+      assertUnit(d.back() == 99);
+   }  // teardown
+
+   // a queue in steady state does not go back to the allocator
+   void test_spare_queueNoAllocate()
+   {  // setup
+      custom::deque<int, 4, CountAllocator<int>> d;
+      for (int i = 0; i < 6; i++)
+         d.push_back(i);
+      for (int i = 0; i < 10; i++)
+      {
+         d.push_back(i);
+         d.pop_front();
+      }
+      CountAllocator<int>::numAllocate = 0;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         d.push_back(i);
+         d.pop_front();
+      }
+      // verify
+      assertUnit(CountAllocator<int>::numAllocate == 0);
+      assertUnit(d.size() == 6);
+      assertUnit(d.back() == 999);
+   }  // teardown
+
+   // the high-water mark caps the spares and frees the rest
+   void test_spare_limit()
+   {  // setup
+      custom::deque<int, 4> d;
+      d.set_max_spare_blocks(2);
+      for (int i = 0; i < 20; i++)
+         d.push_back(i);
+      // exercise
+      d.clear();
+      // verify
+      assertUnit(d.max_spare_blocks() == 2);
+      assertUnit(d.spare_blocks() == 2);
+      d.set_max_spare_blocks(0);
+      assertUnit(d.spare_blocks() == 0);
+      assertUnit(d.spares == nullptr);
+   }  // teardown
+
    /***************************************
     * BACK
     ***************************************/
@@ -2747,7 +3180,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -2780,7 +3213,7 @@ public:
       //          +----+----+----+----+
       //          |    | // | // |    |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 4;
       d.numCells = 3;
       d.numElements = 4;
@@ -2854,7 +3287,7 @@ public:
       //   +----+
       //   |    |
       //   +----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 1;
       d.numCells = 16;
       d.numElements = 3;
@@ -2864,7 +3297,7 @@ public:
       d.alloc.construct(&d.data[0][0], Spy(59));
       d.alloc.construct(&d.data[0][1], Spy(67));
       d.alloc.construct(&d.data[0][2], Spy(89));
-      const custom::deque<Spy> d2(d); // need the copy constructor. There is no other way
+      const custom::deque<Spy, custom::dynamic_cells> d2(d); // need the copy constructor. There is no other way
       Spy s(99);
       Spy::reset();
       // exercise
@@ -2918,7 +3351,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -2968,7 +3401,7 @@ public:
       //          +----+----+----+----+
       //          |    | // | // |    |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 4;
       d.numCells = 3;
       d.numElements = 4;
@@ -3047,7 +3480,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -3080,7 +3513,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy s(99);
       Spy::reset();
@@ -3129,7 +3562,7 @@ public:
       //   +----+
       //   |    |
       //   +----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 1;
       d.numCells = 16;
       d.numElements = 3;
@@ -3139,7 +3572,7 @@ public:
       d.alloc.construct(&d.data[0][0], Spy(59));
       d.alloc.construct(&d.data[0][1], Spy(67));
       d.alloc.construct(&d.data[0][2], Spy(89));
-      const custom::deque<Spy> d2(d); // need the copy constructor. There is no other way
+      const custom::deque<Spy, custom::dynamic_cells> d2(d); // need the copy constructor. There is no other way
       Spy s(99);
       Spy::reset();
       // exercise
@@ -3197,7 +3630,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy s0(99);
       Spy s1(99);
@@ -3246,7 +3679,7 @@ public:
       //          +----+----+----+----+
       //          |    | // | // |    |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 4;
       d.numCells = 3;
       d.numElements = 4;
@@ -3325,7 +3758,7 @@ public:
       //   +----+
       //   |    |
       //   +----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 1;
       d.numCells = 16;
       d.numElements = 3;
@@ -3335,7 +3768,7 @@ public:
       d.alloc.construct(&d.data[0][0], Spy(59));
       d.alloc.construct(&d.data[0][1], Spy(67));
       d.alloc.construct(&d.data[0][2], Spy(89));
-      const custom::deque<Spy> d2(d); // need the copy constructor. There is no other way
+      const custom::deque<Spy, custom::dynamic_cells> d2(d); // need the copy constructor. There is no other way
       Spy s(99);
       Spy::reset();
       // exercise
@@ -3388,7 +3821,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy s0(10);
       Spy s1(11);
@@ -3454,7 +3887,7 @@ public:
       //          +----+----+----+----+
       //          |    | // | // |    |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       d.numBlocks = 4;
       d.numCells = 3;
       d.numElements = 4;
@@ -3531,8 +3964,8 @@ public:
    // test the iterator accessing the beginning of an empty deque
    void test_iterator_begin_empty()
    {  // setup
-      custom::deque<Spy> d;
-      custom::deque<Spy>::iterator it;
+      custom::deque<Spy, custom::dynamic_cells> d;
+      custom::deque<Spy, custom::dynamic_cells>::iterator it;
       Spy::reset();
       // exercise
       it = d.begin();
@@ -3557,7 +3990,7 @@ public:
    // test the iterator at the beginning of the standard fixture
    void test_iterator_begin_standard()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque<Spy, custom::dynamic_cells>::iterator it;
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
       //    +----+----+----+  +----+----+----+
@@ -3565,7 +3998,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -3600,7 +4033,7 @@ public:
    // test the iterator at the end of the standard fixture
    void test_iterator_end_standard()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque<Spy, custom::dynamic_cells>::iterator it;
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
       //    +----+----+----+  +----+----+----+
@@ -3608,7 +4041,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       Spy::reset();
       // exercise
@@ -3643,7 +4076,7 @@ public:
    // test the iterator to increment from the middle of the standard fixture
    void test_iterator_increment_standardMiddle()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque<Spy, custom::dynamic_cells>::iterator it;
       //                it
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -3652,7 +4085,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       it.d = &d;
       it.id = 1;
@@ -3689,7 +4122,7 @@ public:
    // the the iterator's dereference operator to access an item from the list
    void test_iterator_dereference_read()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque<Spy, custom::dynamic_cells>::iterator it;
       //                it
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -3698,7 +4131,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       it.d = &d;
       it.id = 1;
@@ -3737,7 +4170,7 @@ public:
    // the the iterator's dereference operator to update an item from the list
    void test_iterator_dereference_update()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque<Spy, custom::dynamic_cells>::iterator it;
       //                it
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -3746,7 +4179,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       it.d = &d;
       it.id = 1;
@@ -3794,7 +4227,7 @@ public:
    // the the iterator's dereference operator to update an item from the list
    void test_iterator_add_withinBlock()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque<Spy, custom::dynamic_cells>::iterator it;
       //           it
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -3803,7 +4236,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       it.d = &d;
       it.id = 0;
@@ -3841,7 +4274,7 @@ public:
    // the the iterator's dereference operator to update an item from the list
    void test_iterator_add_betweenBlocks()
    {  // setup
-      custom::deque<Spy>::iterator it;
+      custom::deque<Spy, custom::dynamic_cells>::iterator it;
       //           it
       //    +----+----+----+  +----+----+----+
       //    |    | 31 | 49 |  | 55 | 67 |    |
@@ -3850,7 +4283,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       it.d = &d;
       it.id = 0;
@@ -3888,8 +4321,8 @@ public:
    // the the iterator's dereference operator to update an item from the list
    void test_iterator_difference_standard()
    {  // setup
-      custom::deque<Spy>::iterator it1;
-      custom::deque<Spy>::iterator it2;
+      custom::deque<Spy, custom::dynamic_cells>::iterator it1;
+      custom::deque<Spy, custom::dynamic_cells>::iterator it2;
       //           it1          it2
       // id        0    1       2     3
       //    +----+----+----+  +----+----+----+
@@ -3899,7 +4332,7 @@ public:
       //          +----+----+----+----+
       //          | // |    |    | // |
       //          +----+----+----+----+
-      custom::deque<Spy> d;
+      custom::deque<Spy, custom::dynamic_cells> d;
       setupStandardFixture(d);
       it1.d = &d;
       it1.id = 0;
@@ -3926,6 +4359,406 @@ public:
       teardownStandardFixture(d);
    }
 
+   // stepping within a block only moves the cached cell
+   void test_iterator_increment_cachesCell()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 8; i++)
+         d.push_back(i);
+      custom::deque<int, 4>::iterator it = d.begin();
+      assertUnit(*it == 0);
+      int * pFirst = it.pCell;
+      // exercise
+      ++it;
+      // verify
+      assertUnit(it.id == 1);
+      assertUnit(it.pCell == pFirst + 1);
+      assertUnit(it.pBegin == d.data[0]);
+      assertUnit(*it == 1);
+   }  // teardown
+
+   // stepping off the end of a block finds the next one
+   void test_iterator_increment_crossBlock()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 8; i++)
+         d.push_back(i);
+      custom::deque<int, 4>::iterator it = d.begin();
+      it += 3;
+      assertUnit(*it == 3);
+      // exercise
+      ++it;
+      // verify
+      assertUnit(it.pCell == nullptr);
+      assertUnit(*it == 4);
+      assertUnit(it.pBegin == d.data[1]);
+   }  // teardown
+
+   // stepping back off the front of a block finds the one before
+   void test_iterator_decrement_crossBlock()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 8; i++)
+         d.push_back(i);
+      custom::deque<int, 4>::iterator it = d.end();
+      int sum = 0;
+      // exercise
+      for (int i = 0; i < 8; i++)
+         sum += *--it;
+      // verify
+      assertUnit(sum == 28);
+      assertUnit(it == d.begin());
+      assertUnit(*it == 0);
+   }  // teardown
+
+   // +, -, and [] when the front has wrapped around the block table
+   void test_iterator_jump_wrapped()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 6; i++)
+         d.push_back(i);
+      for (int i = 1; i <= 6; i++)
+         d.push_front(-i);
+      custom::deque<int, 4>::iterator it = d.begin();
+      // exercise
+      custom::deque<int, 4>::iterator itMiddle = it + 6;
+      custom::deque<int, 4>::iterator itBack = 11 + it;
+      // verify
+      assertUnit(*it == -6);
+      assertUnit(*itMiddle == 0);
+      assertUnit(*itBack == 5);
+      assertUnit(it[3] == -3);
+      assertUnit(itBack[-2] == 3);
+      assertUnit(*(itBack - 7) == -2);
+      assertUnit(itBack - it == 11);
+      assertUnit(d.end() - d.begin() == 12);
+   }  // teardown
+
+   // ordering follows the deque index
+   void test_iterator_compare_standard()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 8; i++)
+         d.push_back(i);
+      // exercise
+      custom::deque<int, 4>::iterator it1 = d.begin() + 2;
+      custom::deque<int, 4>::iterator it2 = d.begin() + 5;
+      // verify
+      assertUnit(it1 < it2);
+      assertUnit(it2 > it1);
+      assertUnit(it1 <= it1);
+      assertUnit(it2 >= it1);
+      assertUnit(!(it2 < it1));
+   }  // teardown
+
+   // std::sort needs a full random-access iterator
+   void test_iterator_sort()
+   {  // setup
+      custom::deque<int, 4> d;
+      int values[] = { 89, 11, 67, 99, 26, 88, 49, 33, 77, 55 };
+      for (int value : values)
+         d.push_front(value);
+      // exercise
+      std::sort(d.begin(), d.end());
+      // verify
+      assertUnit(d[0] == 11);
+      assertUnit(d[4] == 55);
+      assertUnit(d[5] == 67);
+      assertUnit(d[9] == 99);
+      assertUnit(std::is_sorted(d.begin(), d.end()));
+   }  // teardown
+
+   // binary search over several blocks
+   void test_iterator_lowerBound()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 20; i++)
+         d.push_back(i * 2);
+      // exercise
+      custom::deque<int, 4>::iterator it = std::lower_bound(d.begin(), d.end(), 27);
+      // verify
+      assertUnit(it - d.begin() == 14);
+      assertUnit(*it == 28);
+      assertUnit(std::lower_bound(d.begin(), d.end(), 99) == d.end());
+   }  // teardown
+
+
+   /***************************************
+    * SHRINK
+    ***************************************/
+
+   // an empty deque gives back its map and its spares
+   void test_shrink_empty()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 100; i++)
+         d.push_back(i);
+      d.clear();
+      // exercise
+      d.shrink_to_fit();
+      // verify
+      assertUnit(d.numBlocks == 0);
+      assertUnit(d.data == nullptr);
+      assertUnit(d.spare_blocks() == 0);
+      d.push_back(26);
+      assertUnit(d.size() == 1);
+      assertUnit(d.front() == 26);
+   }  // teardown
+
+   // the map is cut to the blocks in use, front block first
+   void test_shrink_keepsElements()
+   {  // setup
+      custom::deque<int, 4> d;
+      d.set_shrink_threshold(0);
+      for (int i = 0; i < 100; i++)
+         d.push_back(i);
+      for (int i = 0; i < 90; i++)
+         d.pop_front();
+      assertUnit(d.numBlocks == 32);
+      // exercise
+      d.shrink_to_fit();
+      // verify
+      assertUnit(d.numBlocks == 3);
+      assertUnit(d.iaFront == 2);
+      assertUnit(d.spare_blocks() == 0);
+      assertUnit(d.size() == 10);
+      for (int id = 0; id < 10; id++)
+         assertUnit(d[id] == 90 + id);
+   }  // teardown
+
+   // the back wrapped into the front block gets its own block
+   void test_shrink_reallocSplitsBlock()
+   {  // setup
+      //       iaFront
+      //   +----+----+----+   +----+----+----+
+      //   | 67 |    | 11 |   | 28 | 31 | 49 |
+      //   +----+----+----+   +----+----+----+
+      custom::deque<Spy, custom::dynamic_cells> d;
+      d.numCells = 3;
+      d.numElements = 5;
+      d.numBlocks = 2;
+      d.iaFront = 2;
+      d.data = new Spy * [2];
+      d.data[0] = d.alloc.allocate(d.numCells);
+      d.data[1] = d.alloc.allocate(d.numCells);
+      d.alloc.construct(&d.data[0][2], Spy(11));
+      d.alloc.construct(&d.data[1][0], Spy(28));
+      d.alloc.construct(&d.data[1][1], Spy(31));
+      d.alloc.construct(&d.data[1][2], Spy(49));
+      d.alloc.construct(&d.data[0][0], Spy(67));
+      Spy* pFrontBlock = d.data[0];
+      Spy::reset();
+      // exercise
+      d.reallocate(4);
+      // verify
+      assertUnit(Spy::numCopyMove() == 1);      // move 67
+      assertUnit(Spy::numDestructor() == 1);    // destroy the old 67
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      //            iaFront
+      //   +----+----+----+   +----+----+----+   +----+----+----+
+      //   |    |    | 11 |   | 28 | 31 | 49 |   | 67 |    |    |
+      //   +----+----+----+   +----+----+----+   +----+----+----+
+      assertUnit(d.numBlocks == 4);
+      assertUnit(d.iaFront == 2);
+      assertUnit(d.data[0] == pFrontBlock);
+      assertUnit(d.data[2] != nullptr);
+      assertUnit(d.data[3] == nullptr);
+      assertUnit(d[0] == Spy(11));
+      assertUnit(d[3] == Spy(49));
+      assertUnit(d[4] == Spy(67));
+      // teardown
+      teardownStandardFixture(d);
+   }
+
+   // draining most of a big deque shrinks the map on its own
+   void test_shrink_auto()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 400; i++)
+         d.push_back(i);
+      assertUnit(d.numBlocks == 128);
+      // exercise
+      for (int i = 0; i < 390; i++)
+         d.pop_front();
+      // verify
+      assertUnit(d.numBlocks < 16);
+      assertUnit(d.spare_blocks() == 0);
+      assertUnit(d.size() == 10);
+      assertUnit(d.front() == 390);
+      assertUnit(d.back() == 399);
+      d.push_front(26);
+      d.push_back(27);
+      assertUnit(d.front() == 26);
+      assertUnit(d.back() == 27);
+   }  // teardown
+
+   // a zero threshold leaves the map alone
+   void test_shrink_autoOff()
+   {  // setup
+      custom::deque<int, 4> d;
+      d.set_shrink_threshold(0);
+      for (int i = 0; i < 400; i++)
+         d.push_back(i);
+      // exercise
+      for (int i = 0; i < 390; i++)
+         d.pop_back();
+      // verify
+      assertUnit(d.shrink_threshold() == 0);
+      assertUnit(d.numBlocks == 128);
+      assertUnit(d.size() == 10);
+      assertUnit(d.back() == 9);
+   }  // teardown
+
+   /***************************************
+    * SEGMENTS
+    ***************************************/
+
+   // no elements, no segments
+   void test_segments_empty()
+   {  // setup
+      custom::deque<int, 4> d;
+      size_t numVisited = 0;
+      // exercise
+      for (custom::deque<int, 4>::segment seg : d.segments())
+         numVisited += 1 + seg.size();
+      d.for_each_segment([&](custom::deque<int, 4>::segment seg) { numVisited += 1 + seg.size(); });
+      // verify
+      assertUnit(numVisited == 0);
+   }  // teardown
+
+   // the standard fixture is two segments, one per block
+   void test_segments_standard()
+   {  // setup
+      //    +----+----+----+  +----+----+----+
+      //    |    | 31 | 49 |  | 55 | 67 |    |
+      //    +----+----+----+  +----+----+----+
+      custom::deque<Spy, custom::dynamic_cells> d;
+      setupStandardFixture(d);
+      custom::deque<Spy, custom::dynamic_cells>::segment segs[3];
+      int numSegments = 0;
+      Spy::reset();
+      // exercise
+      d.for_each_segment([&](custom::deque<Spy, custom::dynamic_cells>::segment seg)
+      {
+         segs[numSegments++] = seg;
+      });
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(numSegments == 2);
+      assertUnit(segs[0].data() == d.data[1] + 1);
+      assertUnit(segs[0].size() == 2);
+      assertUnit(segs[1].data() == d.data[2]);
+      assertUnit(segs[1].size() == 2);
+      assertUnit(segs[0][1] == Spy(49));
+      assertUnit(segs[1][0] == Spy(55));
+      assertStandardFixture(d);
+      // teardown
+      teardownStandardFixture(d);
+   }
+
+   // segments come in deque order even when the front has wrapped
+   void test_segments_wrapped()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 10; i++)
+         d.push_back(i);
+      for (int i = 1; i <= 3; i++)
+         d.push_front(-i);
+      size_t sizes[5] = {};
+      int numSegments = 0;
+      int expected = -3;
+      bool inOrder = true;
+      // exercise
+      for (custom::deque<int, 4>::segment seg : d.segments())
+      {
+         sizes[numSegments++] = seg.size();
+         for (int value : seg)
+            inOrder = inOrder && (value == expected++);
+      }
+      // verify
+      assertUnit(numSegments == 4);
+      assertUnit(sizes[0] == 3);
+      assertUnit(sizes[1] == 4);
+      assertUnit(sizes[2] == 4);
+      assertUnit(sizes[3] == 2);
+      assertUnit(inOrder);
+      assertUnit(expected == 10);
+   }  // teardown
+
+   // a whole block at a time with memcpy
+   void test_segments_memcpy()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 13; i++)
+         d.push_front(i);
+      const custom::deque<int, 4> & dConst = d;
+      int buffer[13] = {};
+      size_t numCopied = 0;
+      // exercise
+      dConst.for_each_segment([&](custom::deque<int, 4>::const_segment seg)
+      {
+         std::memcpy(buffer + numCopied, seg.data(), seg.size() * sizeof(int));
+         numCopied += seg.size();
+      });
+      // verify
+      assertUnit(numCopied == 13);
+      assertUnit(buffer[0] == 12);
+      assertUnit(buffer[6] == 6);
+      assertUnit(buffer[12] == 0);
+   }  // teardown
+
+   // writing through a segment changes the deque
+   void test_segments_write()
+   {  // setup
+      custom::deque<int, 4> d;
+      for (int i = 0; i < 9; i++)
+         d.push_back(i);
+      // exercise
+      for (custom::deque<int, 4>::segment seg : d.segments())
+         for (int & value : seg)
+            value *= 10;
+      // verify
+      assertUnit(d[0] == 0);
+      assertUnit(d[4] == 40);
+      assertUnit(d[8] == 80);
+   }  // teardown
+
+   /***************************************
+    * STRESS
+    ***************************************/
+
+   // more than 2^31 one-byte elements: every index, block number,
+   // and iterator distance past here would overflow an int
+   void test_stress_over2G()
+   {  // setup
+      const size_t numBig = ((size_t)1 << 31) + 4096 * 3 + 5;
+      custom::deque<char> d;
+      // exercise
+      for (size_t i = 0; i < numBig; i++)
+         d.push_back((char)(i & 0x7f));
+      d.push_front('x');
+      // verify
+      assertUnit(d.size() == numBig + 1);
+      assertUnit(d.front() == 'x');
+      assertUnit(d.back() == (char)((numBig - 1) & 0x7f));
+      assertUnit(d[(size_t)1 << 31] == (char)((((size_t)1 << 31) - 1) & 0x7f));
+      assertUnit(d[numBig] == (char)((numBig - 1) & 0x7f));
+      custom::deque<char>::iterator it = d.begin() + ((size_t)1 << 31) + 7;
+      assertUnit(it - d.begin() == ((std::ptrdiff_t)1 << 31) + 7);
+      assertUnit(*it == (char)((((size_t)1 << 31) + 6) & 0x7f));
+      assertUnit(d.end() - it == (std::ptrdiff_t)(numBig + 1 - ((size_t)1 << 31) - 7));
+      // pop across many blocks from both ends
+      for (size_t i = 0; i < 4096 * 3; i++)
+      {
+         d.pop_front();
+         d.pop_back();
+      }
+      assertUnit(d.size() == numBig + 1 - 2 * 4096 * 3);
+      assertUnit(d.front() == (char)((4096 * 3 - 1) & 0x7f));
+      assertUnit(d.back() == (char)((numBig - 1 - 4096 * 3) & 0x7f));
+   }  // teardown
 
    /*************************************************************
     * SETUP STANDARD FIXTURE
@@ -3944,7 +4777,7 @@ public:
     *    numCell     = 3
     *    numBlock    = 4
     *************************************************************/
-   void setupStandardFixture(custom::deque<Spy>& d)
+   void setupStandardFixture(custom::deque<Spy, custom::dynamic_cells>& d)
    {
       d.numBlocks   = 4;
       d.numCells    = 3;
@@ -3966,7 +4799,7 @@ public:
    /*************************************************************
     * VERIFY EMPTY FIXTURE
     *************************************************************/
-   void assertEmptyFixtureParameters(const custom::deque<Spy>& d, int line, const char* function)
+   void assertEmptyFixtureParameters(const custom::deque<Spy, custom::dynamic_cells>& d, int line, const char* function)
    {
       assertIndirect(d.numBlocks == 0);
       assertIndirect(d.numCells == 16);
@@ -3992,7 +4825,7 @@ public:
     *    numCell     = 3
     *    numBlock    = 4
     *************************************************************/
-   void assertStandardFixtureParameters(const custom::deque<Spy>& d, int line, const char* function)
+   void assertStandardFixtureParameters(const custom::deque<Spy, custom::dynamic_cells>& d, int line, const char* function)
    {
       assertIndirect(d.numBlocks == 4);
       assertIndirect(d.numCells == 3);
@@ -4026,7 +4859,7 @@ public:
     *    |    |    |    |    |
     *    +----+----+----+----+
     *************************************************************/
-   void teardownStandardFixture(custom::deque<Spy>& d)
+   void teardownStandardFixture(custom::deque<Spy, custom::dynamic_cells>& d)
    {
       if (d.data)
       {
@@ -4051,6 +4884,7 @@ public:
 
          delete [] d.data;
       }
+      d.set_max_spare_blocks(0);
       d.data = nullptr;
       d.numBlocks = 0;
       d.numElements = 0;
@@ -0,0 +1,304 @@
+/***********************************************************************
+ * Header:
+ *    TEST FORK JOIN POOL
+ * Summary:
+ *    Unit tests for work_stealing_deque, fork_join_pool and parallel_for
+ * Author:
+ *    Jacob Mower
+ *    Thatcher Albinston
+ *    Elroe Woldemichael
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "fork_join_pool.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class TestForkJoinPool : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Work stealing deque
+      test_stealing_ownerLifo();
+      test_stealing_thiefFifo();
+      test_stealing_lastOne();
+      test_stealing_grow();
+      test_stealing_threads();
+
+      // Pool
+      test_pool_spawnJoin();
+      test_pool_recursive();
+      test_pool_joinRethrows();
+      test_pool_forEveryIndex();
+      test_pool_forEmpty();
+      test_pool_forFromWorker();
+
+      report("ForkJoinPool");
+   }
+
+   /***************************************
+    * WORK STEALING DEQUE
+    ***************************************/
+
+   // the owner gets back the newest first
+   void test_stealing_ownerLifo()
+   {  // setup
+      custom::work_stealing_deque<int> d;
+      int value = 0;
+      // exercise
+      d.push(26);
+      d.push(49);
+      d.push(67);
+      // verify
+      assertUnit(d.size() == 3);
+      assertUnit(d.pop(value) && value == 67);
+      assertUnit(d.pop(value) && value == 49);
+      assertUnit(d.pop(value) && value == 26);
+      assertUnit(!d.pop(value));
+      assertUnit(d.empty());
+      assertUnit(d.bottom == d.top);
+   }  // teardown
+
+   // a thief gets the oldest, and the owner still gets the newest
+   void test_stealing_thiefFifo()
+   {  // setup
+      custom::work_stealing_deque<int> d;
+      d.push(26);
+      d.push(49);
+      d.push(67);
+      int value = 0;
+      // exercise
+      bool stole = d.steal(value);
+      // verify
+      assertUnit(stole && value == 26);
+      assertUnit(d.pop(value) && value == 67);
+      assertUnit(d.steal(value) && value == 49);
+      assertUnit(!d.steal(value));
+      assertUnit(!d.pop(value));
+      assertUnit(d.empty());
+   }  // teardown
+
+   // once the last one is stolen the owner finds nothing
+   void test_stealing_lastOne()
+   {  // setup
+      custom::work_stealing_deque<int> d;
+      d.push(99);
+      int value = 0;
+      // exercise
+      bool stole = d.steal(value);
+      bool popped = d.pop(value);
+      // verify
+      assertUnit(stole);
+      assertUnit(!popped);
+      assertUnit(value == 99);
+      assertUnit(d.top == 1);
+      assertUnit(d.bottom == 1);
+   }  // teardown
+
+   // a full ring doubles and keeps the elements, and the old ring is kept
+   void test_stealing_grow()
+   {  // setup
+      custom::work_stealing_deque<int> d(4);
+      int value = 0;
+      d.push(-1);
+      d.steal(value);
+      bool inOrder = true;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         d.push(i);
+      // verify
+      assertUnit(d.capacity() == 16);
+      assertUnit(d.ring.load()->pOld != nullptr);
+      assertUnit(d.ring.load()->pOld->capacity() == 8);
+      assertUnit(d.size() == 10);
+      for (int i = 0; i < 10; i++)
+         inOrder = inOrder && d.steal(value) && value == i;
+      assertUnit(inOrder);
+      assertUnit(d.empty());
+   }  // teardown
+
+   // the owner pushes and pops while thieves steal; every value comes
+   // out exactly once
+   void test_stealing_threads()
+   {  // setup
+      custom::work_stealing_deque<int> d(8);
+      const int num = 50000;
+      std::vector<std::atomic<int>> seen(num);
+      for (auto & count : seen)
+         count.store(0);
+      std::atomic<bool> done(false);
+      auto thief = [&]
+      {
+         int value;
+         while (!done.load())
+            if (d.steal(value))
+               seen[value]++;
+            else
+               std::this_thread::yield();
+      };
+      // exercise
+      std::thread thief1(thief);
+      std::thread thief2(thief);
+      int value;
+      for (int i = 0; i < num; i++)
+      {
+         d.push(i);
+         if (i % 3 == 0 && d.pop(value))
+            seen[value]++;
+      }
+      while (d.pop(value))
+         seen[value]++;
+      done.store(true);
+      thief1.join();
+      thief2.join();
+      // verify
+      bool once = true;
+      for (auto & count : seen)
+         once = once && count.load() == 1;
+      assertUnit(once);
+      assertUnit(d.empty());
+   }  // teardown
+
+   /***************************************
+    * POOL
+    ***************************************/
+
+   // every spawned task runs before join returns
+   void test_pool_spawnJoin()
+   {  // setup
+      custom::fork_join_pool pool(2);
+      std::atomic<int> count(0);
+      custom::task_group group(pool);
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         group.spawn([&count] { count++; });
+      group.join();
+      // verify
+      assertUnit(count.load() == 1000);
+      assertUnit(group.numPending.load() == 0);
+   }  // teardown
+
+   // tasks spawn tasks and join them, on a pool of one
+   void test_pool_recursive()
+   {  // setup
+      custom::fork_join_pool pool(1);
+      int result = 0;
+      // exercise
+      custom::task_group group(pool);
+      group.spawn([&] { result = fib(pool, 20); });
+      group.join();
+      // verify
+      assertUnit(result == 6765);
+   }  // teardown
+
+   // an exception thrown by a task comes out of join, after the rest ran
+   void test_pool_joinRethrows()
+   {  // setup
+      custom::fork_join_pool pool(2);
+      std::atomic<int> count(0);
+      custom::task_group group(pool);
+      bool caught = false;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         group.spawn([&count, i]
+         {
+            count++;
+            if (i == 5)
+               throw std::runtime_error("five");
+         });
+      try
+      {
+         group.join();
+      }
+      catch (const std::runtime_error &)
+      {
+         caught = true;
+      }
+      // verify
+      assertUnit(caught);
+      assertUnit(count.load() == 10);
+   }  // teardown
+
+   // the pieces cover the range exactly once
+   void test_pool_forEveryIndex()
+   {  // setup
+      custom::fork_join_pool pool(3);
+      std::vector<int> hits(10007, 0);
+      std::atomic<int> numPieces(0);
+      // exercise
+      custom::parallel_for(pool, 0, hits.size(), [&](size_t begin, size_t end)
+      {
+         numPieces++;
+         for (size_t i = begin; i < end; i++)
+            hits[i]++;
+      }, 100);
+      // verify
+      bool once = true;
+      for (int hit : hits)
+         once = once && hit == 1;
+      assertUnit(once);
+      assertUnit(numPieces.load() >= 101);
+      assertUnit(numPieces.load() <= 128);
+   }  // teardown
+
+   // an empty range calls nothing
+   void test_pool_forEmpty()
+   {  // setup
+      custom::fork_join_pool pool(2);
+      int numCalls = 0;
+      // exercise
+      custom::parallel_for(pool, 5, 5, [&](size_t, size_t) { numCalls++; });
+      // verify
+      assertUnit(numCalls == 0);
+   }  // teardown
+
+   // a parallel_for started from inside a task runs on the workers' deques
+   void test_pool_forFromWorker()
+   {  // setup
+      custom::fork_join_pool pool(2);
+      std::atomic<long long> sum(0);
+      custom::task_group group(pool);
+      // exercise
+      group.spawn([&]
+      {
+         custom::parallel_for(pool, 1, 1001, [&](size_t begin, size_t end)
+         {
+            long long part = 0;
+            for (size_t i = begin; i < end; i++)
+               part += i;
+            sum += part;
+         });
+      });
+      group.join();
+      // verify
+      assertUnit(sum.load() == 500500);
+      assertUnit(pool.numOutside.load() == 0);
+   }  // teardown
+
+private:
+   // the slow, fork-join way
+   static int fib(custom::fork_join_pool & pool, int n)
+   {
+      if (n < 2)
+         return n;
+      int left = 0;
+      custom::task_group group(pool);
+      group.spawn([&] { left = fib(pool, n - 1); });
+      int right = fib(pool, n - 2);
+      group.join();
+      return left + right;
+   }
+};
+
+#endif // DEBUG
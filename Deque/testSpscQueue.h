@@ -0,0 +1,327 @@
+/***********************************************************************
+ * Header:
+ *    TEST SPSC QUEUE
+ * Summary:
+ *    Unit tests for spsc_ring and spsc_queue
+ * Author:
+ *    Jacob Mower
+ *    Thatcher Albinston
+ *    Elroe Woldemichael
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "spsc_queue.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <thread>
+
+class TestSpscQueue : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Ring
+      test_ring_capacityRounds();
+      test_ring_fifo();
+      test_ring_full();
+      test_ring_wrap();
+      test_ring_batch();
+      test_ring_destroysLeftovers();
+      test_ring_twoThreads();
+
+      // Queue
+      test_queue_fifoAcrossBlocks();
+      test_queue_reusesSpare();
+      test_queue_batch();
+      test_queue_destroysLeftovers();
+      test_queue_freesBlocks();
+      test_queue_twoThreads();
+
+      report("SpscQueue");
+   }
+
+   /***************************************
+    * RING
+    ***************************************/
+
+   // capacity is a power of two, at least what was asked for
+   void test_ring_capacityRounds()
+   {  // setup
+      // exercise
+      custom::spsc_ring<int> r5(5);
+      custom::spsc_ring<int> r8(8);
+      custom::spsc_ring<int> r1(1);
+      // verify
+      assertUnit(r5.capacity() == 8);
+      assertUnit(r8.capacity() == 8);
+      assertUnit(r1.capacity() == 2);
+      assertUnit(r5.empty());
+   }  // teardown
+
+   // first in, first out
+   void test_ring_fifo()
+   {  // setup
+      custom::spsc_ring<int> r(4);
+      int value = 0;
+      // exercise
+      r.try_push(26);
+      r.try_push(49);
+      r.try_push(67);
+      // verify
+      assertUnit(r.size() == 3);
+      assertUnit(r.try_pop(value) && value == 26);
+      assertUnit(r.try_pop(value) && value == 49);
+      assertUnit(r.try_pop(value) && value == 67);
+      assertUnit(!r.try_pop(value));
+      assertUnit(r.empty());
+   }  // teardown
+
+   // a full ring turns the push away and leaves the elements alone
+   void test_ring_full()
+   {  // setup
+      custom::spsc_ring<int> r(4);
+      for (int i = 0; i < 4; i++)
+         r.try_push(i);
+      int value = 0;
+      // exercise
+      bool pushed = r.try_push(99);
+      // verify
+      assertUnit(!pushed);
+      assertUnit(r.size() == 4);
+      assertUnit(r.try_pop(value) && value == 0);
+      assertUnit(r.try_push(99));
+      assertUnit(r.size() == 4);
+   }  // teardown
+
+   // the positions keep counting as the slots are reused
+   void test_ring_wrap()
+   {  // setup
+      custom::spsc_ring<int> r(4);
+      int value = 0;
+      bool same = true;
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         r.try_push(i);
+         r.try_push(i + 1000);
+         same = same && r.try_pop(value) && value == i;
+         same = same && r.try_pop(value) && value == i + 1000;
+      }
+      // verify
+      assertUnit(same);
+      assertUnit(r.head == 200);
+      assertUnit(r.tail == 200);
+      assertUnit(r.empty());
+   }  // teardown
+
+   // a batch takes what fits and gives back what is there
+   void test_ring_batch()
+   {  // setup
+      custom::spsc_ring<int> r(8);
+      int in[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+      int out[10] = {};
+      r.try_push(-1);
+      // exercise
+      size_t numPushed = r.push_batch(in, 10);
+      size_t numPopped = r.pop_batch(out, 3);
+      size_t numPoppedRest = r.pop_batch(out + 3, 10);
+      // verify
+      assertUnit(numPushed == 7);
+      assertUnit(numPopped == 3);
+      assertUnit(numPoppedRest == 5);
+      assertUnit(out[0] == -1);
+      assertUnit(out[1] == 0);
+      assertUnit(out[7] == 6);
+      assertUnit(r.empty());
+   }  // teardown
+
+   // elements never popped are destroyed with the ring
+   void test_ring_destroysLeftovers()
+   {  // setup
+      Spy::reset();
+      {
+         custom::spsc_ring<Spy> r(4);
+         r.try_push(Spy(26));
+         r.try_push(Spy(49));
+         Spy::reset();
+      // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 2);
+   }  // teardown
+
+   // one thread pushes, another pops, and nothing is lost or reordered
+   void test_ring_twoThreads()
+   {  // setup
+      custom::spsc_ring<int> r(64);
+      const int num = 100000;
+      bool inOrder = true;
+      // exercise
+      std::thread producer([&]
+      {
+         for (int i = 0; i < num; i++)
+            while (!r.try_push(i))
+               std::this_thread::yield();
+      });
+      for (int i = 0; i < num; i++)
+      {
+         int value;
+         while (!r.try_pop(value))
+            std::this_thread::yield();
+         inOrder = inOrder && value == i;
+      }
+      producer.join();
+      // verify
+      assertUnit(inOrder);
+      assertUnit(r.empty());
+   }  // teardown
+
+   /***************************************
+    * QUEUE
+    ***************************************/
+
+   // elements come out in order as the queue chains blocks
+   void test_queue_fifoAcrossBlocks()
+   {  // setup
+      custom::spsc_queue<int, 4> q;
+      int value = 0;
+      bool inOrder = true;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         q.push(i);
+      // verify
+      assertUnit(q.size() == 10);
+      assertUnit(q.pHead->next != nullptr);
+      assertUnit(q.pHead->next->next == q.pTail);
+      for (int i = 0; i < 10; i++)
+         inOrder = inOrder && q.try_pop(value) && value == i;
+      assertUnit(inOrder);
+      assertUnit(!q.try_pop(value));
+      assertUnit(q.empty());
+   }  // teardown
+
+   // the block the consumer is done with is the next one the producer uses
+   void test_queue_reusesSpare()
+   {  // setup
+      custom::spsc_queue<int, 4> q;
+      int value = 0;
+      for (int i = 0; i < 5; i++)
+         q.push(i);
+      auto * pFirst = q.pHead;
+      for (int i = 0; i < 5; i++)
+         q.try_pop(value);
+      assertUnit(q.spare == pFirst);
+      // exercise
+      for (int i = 0; i < 4; i++)
+         q.push(i);
+      // verify
+      assertUnit(q.spare == nullptr);
+      assertUnit(q.pTail == pFirst);
+      assertUnit(q.try_pop(value) && value == 0);
+   }  // teardown
+
+   // batches in and out across block boundaries
+   void test_queue_batch()
+   {  // setup
+      custom::spsc_queue<int, 4> q;
+      int in[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+      int out[12] = {};
+      // exercise
+      q.push_batch(in, 10);
+      q.push(10);
+      size_t numPopped = q.pop_batch(out, 6);
+      size_t numPoppedRest = q.pop_batch(out + 6, 6);
+      // verify
+      assertUnit(numPopped == 6);
+      assertUnit(numPoppedRest == 5);
+      assertUnit(out[0] == 0);
+      assertUnit(out[5] == 5);
+      assertUnit(out[10] == 10);
+      assertUnit(q.empty());
+   }  // teardown
+
+   // elements never popped are destroyed with the queue
+   void test_queue_destroysLeftovers()
+   {  // setup
+      {
+         custom::spsc_queue<Spy, 4> q;
+         for (int i = 0; i < 7; i++)
+            q.push(Spy(i));
+         Spy s;
+         q.try_pop(s);
+         q.try_pop(s);
+         q.try_pop(s);
+         q.try_pop(s);
+         Spy::reset();
+      // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 4);  // three left, and s
+   }  // teardown
+
+   // every block goes back, whether the consumer passed it, left it
+   // as the spare, or never reached it
+   void test_queue_freesBlocks()
+   {  // setup
+      typedef custom::spsc_queue<Spy, 4> Queue;
+      long numBefore = Queue::Block::numLive;
+      {
+         Queue q;
+         for (int i = 0; i < 14; i++)
+            q.push(Spy(i));
+         Spy s;
+         for (int i = 0; i < 5; i++)
+            q.try_pop(s);
+         assertUnit(Queue::Block::numLive == numBefore + 4);
+         Spy::reset();
+      // exercise
+      }
+      // verify
+      assertUnit(Queue::Block::numLive == numBefore);
+      assertUnit(Spy::numDestructor() == 10);  // nine left, and s
+   }  // teardown
+
+   // one thread pushes, another pops, and nothing is lost or reordered
+   void test_queue_twoThreads()
+   {  // setup
+      custom::spsc_queue<int, 16> q;
+      const int num = 100000;
+      bool inOrder = true;
+      // exercise
+      std::thread producer([&]
+      {
+         int batch[7];
+         for (int i = 0; i < num; i += 7)
+         {
+            int numBatch = num - i < 7 ? num - i : 7;
+            for (int j = 0; j < numBatch; j++)
+               batch[j] = i + j;
+            q.push_batch(batch, numBatch);
+         }
+      });
+      int next = 0;
+      while (next < num)
+      {
+         int out[5];
+         size_t numPopped = q.pop_batch(out, 5);
+         if (numPopped == 0)
+            std::this_thread::yield();
+         for (size_t j = 0; j < numPopped; j++)
+            inOrder = inOrder && out[j] == next++;
+      }
+      producer.join();
+      // verify
+      assertUnit(inOrder);
+      assertUnit(q.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
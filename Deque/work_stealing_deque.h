@@ -0,0 +1,270 @@
+/***********************************************************************
+ * Header:
+ *    WORK STEALING DEQUE
+ * Summary:
+ *    The Chase-Lev deque: a lock-free deque owned by one thread, which
+ *    pushes and pops at the bottom like a stack, while any number of
+ *    other threads steal from the top like a queue. The owner only
+ *    contends with a thief over the very last element, so a busy
+ *    owner almost never pays for an atomic read-modify-write.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        work_stealing_deque    : A growable ring of trivially copyable
+ *                                 elements, usually task pointers
+ * Author
+ *    Jacob Mower
+ *    Thatcher Albinston
+ *    Elroe Woldemichael
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // because I am paranoid
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for std::ptrdiff_t
+#include <type_traits> // for std::is_trivially_copyable
+
+class TestForkJoinPool;  // forward declaration for unit tests
+
+namespace custom
+{
+
+/******************************************************
+ * WORK STEALING DEQUE
+ * top and bottom count every element ever stolen and
+ * pushed, and index a ring of a power of two cells.
+ * They are signed: an owner's pop moves bottom below
+ * top for a moment before it backs off.
+ *
+ * When the ring fills, the owner copies it into one
+ * twice the size. A thief may still be reading the old
+ * ring, so the old ones are kept on a list and only
+ * freed with the deque.
+ *
+ * push and pop may only be called from the owning
+ * thread; steal may be called from any thread.
+ *****************************************************/
+template <typename T>
+class work_stealing_deque
+{
+   friend class ::TestForkJoinPool; // give unit tests access to the privates
+
+   // one ring of cells, chained to the ring it replaced
+   struct Ring
+   {
+      Ring(std::ptrdiff_t capacity, Ring * pOld) :
+         cells(new std::atomic<T>[capacity]), mask(capacity - 1), pOld(pOld) {}
+     ~Ring() { delete [] cells; }
+
+      std::ptrdiff_t capacity() const { return mask + 1; }
+      T get(std::ptrdiff_t pos) const
+      {
+         return cells[pos & mask].load(std::memory_order_relaxed);
+      }
+      void put(std::ptrdiff_t pos, T t)
+      {
+         cells[pos & mask].store(t, std::memory_order_relaxed);
+      }
+
+      std::atomic<T> * cells;
+      std::ptrdiff_t mask;
+      Ring * pOld;
+   };
+
+public:
+   explicit work_stealing_deque(size_t capacity = 64);
+   work_stealing_deque(const work_stealing_deque &) = delete;
+   work_stealing_deque & operator = (const work_stealing_deque &) = delete;
+  ~work_stealing_deque();
+
+   //
+   // Owner
+   //
+   void push(T t);
+   bool pop(T & t);
+
+   //
+   // Thieves
+   //
+   bool steal(T & t);
+
+   //
+   // Status. From any thread but the owner these are a snapshot.
+   //
+   size_t size() const
+   {
+      std::ptrdiff_t topNow = top.load(std::memory_order_acquire);
+      std::ptrdiff_t num = bottom.load(std::memory_order_acquire) - topNow;
+      return num > 0 ? (size_t)num : 0;
+   }
+   bool empty() const { return size() == 0; }
+   size_t capacity() const
+   {
+      return (size_t)ring.load(std::memory_order_acquire)->capacity();
+   }
+
+private:
+   // copy the live elements into a ring twice the size
+   Ring * grow(Ring * pRing, std::ptrdiff_t b, std::ptrdiff_t t);
+
+   // written by thieves, and by the owner taking the last element.
+   // Padded rather than aligned, so a deque can be allocated with new
+   // before C++17.
+   std::atomic<std::ptrdiff_t> top;
+   char pad[64 - sizeof(std::ptrdiff_t)];
+
+   // written by the owner
+   std::atomic<std::ptrdiff_t> bottom;
+   std::atomic<Ring *> ring;
+
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "work_stealing_deque holds trivially copyable elements");
+};
+
+/*****************************************
+ * WORK STEALING DEQUE :: CONSTRUCTOR
+ * Start with a ring of at least two cells,
+ * rounded up to a power of two
+ ****************************************/
+template <typename T>
+work_stealing_deque <T> ::work_stealing_deque(size_t capacity) :
+   top(0), bottom(0), ring(nullptr)
+{
+   std::ptrdiff_t cap = 2;
+   while ((size_t)cap < capacity)
+      cap *= 2;
+   ring.store(new Ring(cap, nullptr), std::memory_order_relaxed);
+}
+
+/*****************************************
+ * WORK STEALING DEQUE :: DESTRUCTOR
+ * Free the ring and every ring it replaced.
+ * No thread may still be stealing.
+ ****************************************/
+template <typename T>
+work_stealing_deque <T> ::~work_stealing_deque()
+{
+   Ring * pRing = ring.load(std::memory_order_relaxed);
+   while (pRing)
+   {
+      Ring * pOld = pRing->pOld;
+      delete pRing;
+      pRing = pOld;
+   }
+}
+
+/*****************************************
+ * WORK STEALING DEQUE :: GROW
+ * Only the owner grows, and only from push, so
+ * no element can leave through the bottom while
+ * the copy is made. One stolen from the top in
+ * the meantime is copied too but never read again.
+ *     INPUT  : pRing  the full ring
+ *              b      bottom
+ *              t      top
+ *     OUTPUT : the new ring, already published
+ ****************************************/
+template <typename T>
+typename work_stealing_deque <T> ::Ring *
+work_stealing_deque <T> ::grow(Ring * pRing, std::ptrdiff_t b, std::ptrdiff_t t)
+{
+   Ring * pBigger = new Ring(pRing->capacity() * 2, pRing);
+   for (std::ptrdiff_t pos = t; pos < b; pos++)
+      pBigger->put(pos, pRing->get(pos));
+   ring.store(pBigger, std::memory_order_release);
+   return pBigger;
+}
+
+/*****************************************
+ * WORK STEALING DEQUE :: PUSH
+ * Write the bottom cell, then publish it with
+ * a release store of bottom
+ *     INPUT  : t  the element
+ *     OUTPUT :
+ ****************************************/
+template <typename T>
+void work_stealing_deque <T> ::push(T t)
+{
+   std::ptrdiff_t b = bottom.load(std::memory_order_relaxed);
+   std::ptrdiff_t tp = top.load(std::memory_order_acquire);
+   Ring * pRing = ring.load(std::memory_order_relaxed);
+   if (b - tp > pRing->mask)
+      pRing = grow(pRing, b, tp);
+   pRing->put(b, t);
+   bottom.store(b + 1, std::memory_order_release);
+}
+
+/*****************************************
+ * WORK STEALING DEQUE :: POP
+ * Claim the bottom cell by moving bottom down
+ * first, then look at top. The store and the
+ * load are both sequentially consistent so a
+ * thief cannot see the old bottom after the
+ * owner has seen the old top. Only when one
+ * element is left do the two race for it, and
+ * then top decides.
+ *     INPUT  : t  where the element goes
+ *     OUTPUT : false if the deque was empty
+ ****************************************/
+template <typename T>
+bool work_stealing_deque <T> ::pop(T & t)
+{
+   std::ptrdiff_t b = bottom.load(std::memory_order_relaxed) - 1;
+   Ring * pRing = ring.load(std::memory_order_relaxed);
+   bottom.store(b, std::memory_order_seq_cst);
+   std::ptrdiff_t tp = top.load(std::memory_order_seq_cst);
+
+   // already empty: put bottom back
+   if (tp > b)
+   {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+   }
+
+   t = pRing->get(b);
+   if (tp == b)
+   {
+      // the last one: win it from the thieves or give it up
+      bool won = top.compare_exchange_strong(tp, tp + 1,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_relaxed);
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+   }
+   return true;
+}
+
+/*****************************************
+ * WORK STEALING DEQUE :: STEAL
+ * Read the top cell, then claim it by moving
+ * top up. Losing the race to the owner or to
+ * another thief reports empty; the caller is
+ * expected to look elsewhere and come back.
+ *     INPUT  : t  where the element goes
+ *     OUTPUT : false if there was nothing to take
+ ****************************************/
+template <typename T>
+bool work_stealing_deque <T> ::steal(T & t)
+{
+   std::ptrdiff_t tp = top.load(std::memory_order_seq_cst);
+   std::ptrdiff_t b = bottom.load(std::memory_order_seq_cst);
+   if (tp >= b)
+      return false;
+
+   Ring * pRing = ring.load(std::memory_order_acquire);
+   T value = pRing->get(tp);
+   if (!top.compare_exchange_strong(tp, tp + 1,
+                                    std::memory_order_seq_cst,
+                                    std::memory_order_relaxed))
+      return false;
+   t = value;
+   return true;
+}
+
+} // namespace custom
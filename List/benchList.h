@@ -0,0 +1,149 @@
+/***********************************************************************
+ * Header:
+ *    BENCH LIST
+ * Summary:
+ *    Churn a list of int, inserting and removing nodes without the
+ *    size changing much, and report millions of operations a second.
+ *    Three setups are compared: every node from new and back to delete
+ *    (the list with its free nodes turned off), the list keeping its
+ *    own freed nodes, and the list on a pool_allocator. std::list is
+ *    there for reference. Build with optimization and BENCHMARK
+ *    defined to run it from the driver.
+ * Author
+ *    Thatcher Albiston
+ *    Elroe Woldemichael
+ *    Jacob Mower
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "list.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <list>
+
+class BenchList
+{
+public:
+   BenchList(int numOps = 1 << 22, int numLive = 1000, int numRepeat = 5) :
+      numOps(numOps), numLive(numLive), numRepeat(numRepeat), sink(0) {}
+
+   void run()
+   {
+      std::cout << "List of int churn: " << numOps << " operations, "
+                << numLive << " live elements, Mops/s\n";
+      std::cout << std::setw(24) << std::left << "operation" << std::right
+                << std::setw(12) << "new/delete"
+                << std::setw(12) << "free nodes"
+                << std::setw(12) << "pool"
+                << std::setw(12) << "std::list" << std::endl;
+
+      compare("push_back, pop_front", [this](auto & l) { return queue(l); });
+      compare("fill, clear",          [this](auto & l) { return fillClear(l); });
+      compare("insert, erase middle", [this](auto & l) { return middle(l); });
+   }
+
+private:
+   typedef custom::list<int> List;
+   typedef custom::list<int, custom::pool_allocator<int>> PoolList;
+
+   template <class Churn>
+   void compare(const char * name, Churn churn)
+   {
+      double mopsNew  = time([&] { List l; l.set_max_free_nodes(0); return churn(l); });
+      double mopsFree = time([&] { List l; return churn(l); });
+      double mopsPool = time([&] { PoolList l; return churn(l); });
+      double mopsStd  = time([&] { std::list<int> l; return churn(l); });
+      report(name, mopsNew, mopsFree, mopsPool, mopsStd);
+   }
+
+   // steady state of a FIFO queue
+   template <class L>
+   size_t queue(L & l)
+   {
+      for (int i = 0; i < numLive; i++)
+         l.push_back(i);
+      size_t sum = 0;
+      for (int i = 0; i < numOps / 2; i++)
+      {
+         l.push_back(i);
+         sum += l.front();
+         l.pop_front();
+      }
+      return sum;
+   }
+
+   // build the list up and throw it away, over and over
+   template <class L>
+   size_t fillClear(L & l)
+   {
+      size_t sum = 0;
+      for (int round = 0; round < numOps / (numLive * 2); round++)
+      {
+         for (int i = 0; i < numLive; i++)
+            l.push_back(i);
+         sum += l.size();
+         l.clear();
+      }
+      return sum;
+   }
+
+   // walk the list, putting a new node in front of each one and
+   // taking the old one out
+   template <class L>
+   size_t middle(L & l)
+   {
+      for (int i = 0; i < numLive; i++)
+         l.push_back(i);
+      size_t sum = 0;
+      auto it = l.begin();
+      for (int i = 0; i < numOps / 2; i++)
+      {
+         if (it == l.end())
+            it = l.begin();
+         l.insert(it, i);
+         sum += *it;
+         it = l.erase(it);
+      }
+      return sum;
+   }
+
+   // millions of operations a second, best of numRepeat
+   template <class Operation>
+   double time(Operation operation)
+   {
+      double best = 1e30;
+      for (int i = 0; i < numRepeat; i++)
+      {
+         auto begin = std::chrono::steady_clock::now();
+         sink += operation();
+         auto end = std::chrono::steady_clock::now();
+         double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+         if (ms < best)
+            best = ms;
+      }
+      return numOps / best / 1e3;
+   }
+
+   void report(const char * name, double mopsNew, double mopsFree,
+               double mopsPool, double mopsStd)
+   {
+      std::cout << std::setw(24) << std::left << name << std::right
+                << std::fixed << std::setprecision(2)
+                << std::setw(12) << mopsNew
+                << std::setw(12) << mopsFree
+                << std::setw(12) << mopsPool
+                << std::setw(12) << mopsStd << std::endl;
+   }
+
+   int numOps;
+   int numLive;
+   int numRepeat;
+   size_t sink;      // keeps the optimizer from dropping the work
+};
+
+#endif // BENCHMARK
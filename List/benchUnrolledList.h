@@ -0,0 +1,200 @@
+/***********************************************************************
+ * Header:
+ *    BENCH UNROLLED LIST
+ * Summary:
+ *    Compare unrolled_list against list and std::list of int: how fast
+ *    each walks its elements in millions a second, both straight after
+ *    push_back and after a sort has scattered the linked lists' nodes
+ *    over the heap, how fast each is built with push_back, and how many
+ *    bytes each asks its allocator for per element. Build with
+ *    optimization and BENCHMARK defined to run it from the driver.
+ * Author
+ *    Thatcher Albiston
+ *    Elroe Woldemichael
+ *    Jacob Mower
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "list.h"
+#include "unrolled_list.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <list>
+#include <memory>
+#include <vector>
+
+class BenchUnrolledList
+{
+public:
+   BenchUnrolledList(int numElements = 1 << 20, int numRepeat = 5) :
+      numElements(numElements), numRepeat(numRepeat), sink(0)
+   {
+      srand(25);
+      for (int i = 0; i < numElements; i++)
+         values.push_back(rand());
+   }
+
+   void run()
+   {
+      std::cout << "List of int walk: " << numElements << " elements, "
+                << "Melements/s, and allocated bytes per element\n";
+      std::cout << std::setw(24) << std::left << "operation" << std::right
+                << std::setw(12) << "list"
+                << std::setw(12) << "unrolled"
+                << std::setw(12) << "std::list" << std::endl;
+
+      walk("walk, pushed back", false);
+      walk("walk, sorted",      true);
+      report("push_back",
+             time([&] { List l;     fill(l); return l.size(); }),
+             time([&] { Unrolled l; fill(l); return l.size(); }),
+             time([&] { StdList l;  fill(l); return l.size(); }));
+      memory();
+   }
+
+private:
+   /**************************************************
+    * COUNTING ALLOCATOR
+    * std::allocator that keeps a running total of the
+    * bytes it has out, shared by every rebound copy
+    **************************************************/
+   template <class T>
+   struct CountingAllocator
+   {
+      typedef T value_type;
+      CountingAllocator(size_t * pBytes = nullptr) : pBytes(pBytes) { }
+      template <class U>
+      CountingAllocator(const CountingAllocator<U> & rhs) : pBytes(rhs.pBytes) { }
+
+      T * allocate(size_t num)
+      {
+         if (pBytes)
+            *pBytes += num * sizeof(T);
+         return std::allocator<T>().allocate(num);
+      }
+      void deallocate(T * p, size_t num)
+      {
+         if (pBytes)
+            *pBytes -= num * sizeof(T);
+         std::allocator<T>().deallocate(p, num);
+      }
+
+      template <class U>
+      bool operator == (const CountingAllocator<U> & rhs) const { return pBytes == rhs.pBytes; }
+      template <class U>
+      bool operator != (const CountingAllocator<U> & rhs) const { return pBytes != rhs.pBytes; }
+
+      size_t * pBytes;
+   };
+
+   typedef custom::list<int>          List;
+   typedef custom::unrolled_list<int> Unrolled;
+   typedef std::list<int>             StdList;
+
+   // the same values, pushed on the back
+   template <class L>
+   void fill(L & l)
+   {
+      for (int value : values)
+         l.push_back(value);
+   }
+
+   // sum every element, once each repeat
+   template <class L>
+   static size_t sum(L & l)
+   {
+      size_t total = 0;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         total += *it;
+      return total;
+   }
+
+   // the linked lists sort by relinking, leaving neighbours far apart
+   // in memory. The unrolled list has no sort, so it is handed the
+   // values already in order.
+   void walk(const char * name, bool sorted)
+   {
+      List l;
+      StdList lStd;
+      fill(l);
+      fill(lStd);
+      Unrolled lUnrolled;
+      if (sorted)
+      {
+         l.sort();
+         lStd.sort();
+         for (int value : l)
+            lUnrolled.push_back(value);
+      }
+      else
+         fill(lUnrolled);
+
+      report(name,
+             time([&] { return sum(l);         }),
+             time([&] { return sum(lUnrolled); }),
+             time([&] { return sum(lStd);      }));
+   }
+
+   // bytes from the allocator for numElements elements
+   void memory()
+   {
+      size_t bytesList = 0;
+      size_t bytesUnrolled = 0;
+      size_t bytesStd = 0;
+      CountingAllocator<int> aList(&bytesList);
+      CountingAllocator<int> aUnrolled(&bytesUnrolled);
+      CountingAllocator<int> aStd(&bytesStd);
+      custom::list<int, CountingAllocator<int>> l(aList);
+      custom::unrolled_list<int, custom::unrolledNodeCells(sizeof(int)), CountingAllocator<int>>
+         lUnrolled(aUnrolled);
+      std::list<int, CountingAllocator<int>> lStd(aStd);
+      fill(l);
+      fill(lUnrolled);
+      fill(lStd);
+
+      std::cout << std::setw(24) << std::left << "bytes per element" << std::right
+                << std::fixed << std::setprecision(2)
+                << std::setw(12) << (double)bytesList     / numElements
+                << std::setw(12) << (double)bytesUnrolled / numElements
+                << std::setw(12) << (double)bytesStd      / numElements << std::endl;
+   }
+
+   // millions of elements a second, best of numRepeat
+   template <class Operation>
+   double time(Operation operation)
+   {
+      double best = 1e30;
+      for (int i = 0; i < numRepeat; i++)
+      {
+         auto begin = std::chrono::steady_clock::now();
+         sink += operation();
+         auto end = std::chrono::steady_clock::now();
+         double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+         if (ms < best)
+            best = ms;
+      }
+      return numElements / best / 1e3;
+   }
+
+   void report(const char * name, double mList, double mUnrolled, double mStd)
+   {
+      std::cout << std::setw(24) << std::left << name << std::right
+                << std::fixed << std::setprecision(2)
+                << std::setw(12) << mList
+                << std::setw(12) << mUnrolled
+                << std::setw(12) << mStd << std::endl;
+   }
+
+   int numElements;
+   int numRepeat;
+   std::vector<int> values;
+   size_t sink;      // keeps the optimizer from dropping the work
+};
+
+#endif // BENCHMARK
@@ -0,0 +1,421 @@
+/***********************************************************************
+ * Header:
+ *    INTRUSIVE LIST
+ * Summary:
+ *    A doubly linked list of objects that carry their own links. The
+ *    user type holds a list_hook, either by inheriting one or as a
+ *    member, and the list threads the hooks together. The list never
+ *    allocates, copies or destroys an element: it only links what the
+ *    caller already owns. An object with several hooks can be on as
+ *    many lists at once.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        list_hook      : The links embedded in an element
+ *        list_base_hook : A hook to inherit, tagged to allow several
+ *        base_hook      : Find the hook in a base class
+ *        member_hook    : Find the hook in a data member
+ *        intrusive_list : A list of elements linked through a hook
+ * Author
+ *    Thatcher Albiston
+ *    Elroe Woldemichael
+ *    Jacob Mower
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for ASSERT
+#include <cstddef>     // for std::ptrdiff_t
+#include <iterator>    // for std::bidirectional_iterator_tag
+#include <utility>     // for std::swap
+
+class TestIntrusiveList; // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * LIST HOOK
+ * The two links. A hook on no list points at itself,
+ * which tells it apart from the only hook of a list,
+ * whose links are both nullptr. Copying an object
+ * does not copy its place on a list: the copy starts
+ * unlinked.
+ **************************************************/
+class list_hook
+{
+   friend class ::TestIntrusiveList; // give unit tests access to the privates
+   template <typename T, typename H>
+   friend class intrusive_list;
+public:
+   list_hook()                   : pNext(this), pPrev(this) { }
+   list_hook(const list_hook &)  : pNext(this), pPrev(this) { }
+   list_hook & operator = (const list_hook &) { return *this; }
+  ~list_hook()
+   {
+      // take an object off every list before it is destroyed
+      assert(!is_linked());
+   }
+
+   bool is_linked() const { return pNext != this; }
+
+private:
+   void unlink() { pNext = pPrev = this; }
+
+   list_hook * pNext;  // the next hook, or nullptr at the tail
+   list_hook * pPrev;  // the previous hook, or nullptr at the head
+};
+
+/**************************************************
+ * LIST BASE HOOK
+ * Inherit from this to put the type on a list. A class
+ * that needs to be on two lists inherits twice, with
+ * two different tags.
+ **************************************************/
+template <typename Tag = void>
+class list_base_hook : public list_hook
+{
+};
+
+/**************************************************
+ * BASE HOOK
+ * How intrusive_list finds the hook of a T that
+ * inherits list_base_hook<Tag>, and the T of a hook
+ **************************************************/
+template <typename Tag = void>
+struct base_hook
+{
+   template <typename T>
+   static list_hook * toHook(T * p)
+   {
+      return static_cast<list_base_hook<Tag> *>(p);
+   }
+   template <typename T>
+   static T * fromHook(list_hook * pHook)
+   {
+      return static_cast<T *>(static_cast<list_base_hook<Tag> *>(pHook));
+   }
+};
+
+/**************************************************
+ * MEMBER HOOK
+ * How intrusive_list finds the hook of a T that holds
+ * it as the data member Member, and the T of a hook,
+ * by backing up over the member's offset
+ **************************************************/
+template <typename T, list_hook T::* Member>
+struct member_hook
+{
+   template <typename U>
+   static list_hook * toHook(U * p)
+   {
+      return &(p->*Member);
+   }
+   template <typename U>
+   static U * fromHook(list_hook * pHook)
+   {
+      return reinterpret_cast<U *>(reinterpret_cast<char *>(pHook) - offset());
+   }
+
+private:
+   // where Member sits in a T, measured on storage that holds no T
+   static std::ptrdiff_t offset()
+   {
+      alignas(T) static char storage[sizeof(T)];
+      T * p = reinterpret_cast<T *>(storage);
+      return reinterpret_cast<char *>(&(p->*Member)) - storage;
+   }
+};
+
+/**************************************************
+ * INTRUSIVE LIST
+ * Like list, but the elements are the caller's
+ * objects, linked in place through hook H. The list
+ * holds references: push and insert take an object,
+ * and erase, pop and clear only unlink it.
+ **************************************************/
+template <typename T, typename H = base_hook<>>
+class intrusive_list
+{
+   friend class ::TestIntrusiveList; // give unit tests access to the privates
+public:
+
+   //
+   // Construct
+   //
+
+   intrusive_list() : pHead(nullptr), pTail(nullptr), numElements(0) { }
+   intrusive_list(const intrusive_list &) = delete;
+   intrusive_list(intrusive_list && rhs) : pHead(nullptr), pTail(nullptr), numElements(0)
+   {
+      swap(rhs);
+   }
+  ~intrusive_list()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+
+   intrusive_list & operator = (const intrusive_list &) = delete;
+   intrusive_list & operator = (intrusive_list && rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(intrusive_list & rhs)
+   {
+      std::swap(pHead, rhs.pHead);
+      std::swap(pTail, rhs.pTail);
+      std::swap(numElements, rhs.numElements);
+   }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin()  { return iterator(pHead);   }
+   iterator rbegin() { return iterator(pTail);   }
+   iterator end()    { return iterator(nullptr); }
+   iterator iterator_to(T & t)
+   {
+      assert(H::toHook(&t)->is_linked());
+      return iterator(H::toHook(&t));
+   }
+
+   //
+   // Access
+   //
+
+   T & front();
+   T & back();
+
+   //
+   // Insert
+   //
+
+   void push_front(T & t) { insert(begin(), t); }
+   void push_back (T & t) { insert(end(),   t); }
+   iterator insert(iterator it, T & t);
+
+   //
+   // Remove
+   //
+
+   void pop_front() { if (pHead) erase(begin());   }
+   void pop_back()  { if (pTail) erase(rbegin());  }
+   void remove(T & t) { erase(iterator_to(t));     }
+   void clear();
+   iterator erase(const iterator & it);
+
+   //
+   // Status
+   //
+
+   bool empty()  const { return numElements == 0; }
+   size_t size() const { return numElements;      }
+
+private:
+   list_hook * pHead;  // the first element's hook
+   list_hook * pTail;  // the last element's hook
+   size_t numElements; // though we could count, it is faster to keep a variable
+};
+
+/*************************************************
+ * INTRUSIVE LIST ITERATOR
+ * Walks the hooks, and hands back the object each
+ * one is in
+ ************************************************/
+template <typename T, typename H>
+class intrusive_list <T, H> :: iterator
+{
+   friend class ::TestIntrusiveList; // give unit tests access to the privates
+   template <typename TT, typename HH>
+   friend class custom::intrusive_list;
+public:
+   typedef std::bidirectional_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
+   // constructors, destructors, and assignment operator
+   iterator()                     : p(nullptr) { }
+   iterator(list_hook * pRHS)     : p(pRHS)    { }
+   iterator(const iterator & rhs) : p(rhs.p)   { }
+
+   iterator & operator = (const iterator & rhs)
+   {
+      this->p = rhs.p;
+      return *this;
+   }
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return this->p == rhs.p; }
+   bool operator != (const iterator & rhs) const { return this->p != rhs.p; }
+
+   // dereference operator, fetch the object holding the hook
+   T & operator * ()  { return *H::template fromHook<T>(p); }
+   T * operator -> () { return  H::template fromHook<T>(p); }
+
+   // postfix increment
+   iterator operator ++ (int postfix)
+   {
+      iterator it = *this;
+      this->p = p->pNext;
+      return it;
+   }
+
+   // prefix increment
+   iterator & operator ++ ()
+   {
+      this->p = p->pNext;
+      return *this;
+   }
+
+   // postfix decrement
+   iterator operator -- (int postfix)
+   {
+      iterator it = *this;
+      this->p = p->pPrev;
+      return it;
+   }
+
+   // prefix decrement
+   iterator & operator -- ()
+   {
+      this->p = p->pPrev;
+      return *this;
+   }
+
+private:
+   list_hook * p;
+};
+
+/*********************************************
+ * INTRUSIVE LIST :: FRONT
+ * the first object in the list
+ *     INPUT  :
+ *     OUTPUT : the object
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename H>
+T & intrusive_list <T, H> :: front()
+{
+   if (pHead)
+      return *H::template fromHook<T>(pHead);
+   throw "ERROR: unable to access data from an empty list";
+}
+
+/*********************************************
+ * INTRUSIVE LIST :: BACK
+ * the last object in the list
+ *     INPUT  :
+ *     OUTPUT : the object
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename H>
+T & intrusive_list <T, H> :: back()
+{
+   if (pTail)
+      return *H::template fromHook<T>(pTail);
+   throw "ERROR: unable to access data from an empty list";
+}
+
+/******************************************
+ * INTRUSIVE LIST :: INSERT
+ * link an object in before it. The object must
+ * not already be on a list through this hook.
+ *     INPUT  : it  where it goes; end() for the back
+ *              t   the object
+ *     OUTPUT : iterator to the object
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename H>
+typename intrusive_list <T, H> :: iterator
+intrusive_list <T, H> :: insert(iterator it, T & t)
+{
+   list_hook * pNew = H::toHook(&t);
+   assert(!pNew->is_linked());
+
+   list_hook * pPrev = it.p ? it.p->pPrev : pTail;
+   pNew->pPrev = pPrev;
+   pNew->pNext = it.p;
+
+   if (pPrev)
+      pPrev->pNext = pNew;
+   else
+      pHead = pNew;
+
+   if (it.p)
+      it.p->pPrev = pNew;
+   else
+      pTail = pNew;
+
+   numElements++;
+   return iterator(pNew);
+}
+
+/******************************************
+ * INTRUSIVE LIST :: ERASE
+ * unlink an object. It is not destroyed.
+ *     INPUT  : it  the object to take out
+ *     OUTPUT : iterator to the one after it
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename H>
+typename intrusive_list <T, H> :: iterator
+intrusive_list <T, H> :: erase(const iterator & it)
+{
+   list_hook * p = it.p;
+   if (!p)
+      return end();
+   list_hook * pNext = p->pNext;
+
+   if (p->pPrev)
+      p->pPrev->pNext = p->pNext;
+   else
+      pHead = p->pNext;
+
+   if (p->pNext)
+      p->pNext->pPrev = p->pPrev;
+   else
+      pTail = p->pPrev;
+
+   p->unlink();
+   numElements--;
+   return iterator(pNext);
+}
+
+/**********************************************
+ * INTRUSIVE LIST :: CLEAR
+ * unlink every object, leaving each free to go
+ * on another list or be destroyed
+ *     INPUT  :
+ *     OUTPUT :
+ *     COST   : O(n) with respect to the number of objects
+ *********************************************/
+template <typename T, typename H>
+void intrusive_list <T, H> :: clear()
+{
+   list_hook * p = pHead;
+   while (p)
+   {
+      list_hook * pNext = p->pNext;
+      p->unlink();
+      p = pNext;
+   }
+   pHead = nullptr;
+   pTail = nullptr;
+   numElements = 0;
+}
+
+}; // namespace custom
@@ -24,6 +24,8 @@
 #include <iostream>    // for nullptr
 #include <new>         // std::bad_alloc
 #include <memory>      // for std::allocator
+#include <utility>     // for std::forward
+#include "node_pool.h" // for custom::pool_allocator
 
 class TestList; // forward declaration for unit tests
 class TestHash; // forward declaration for hash used later
@@ -47,30 +49,33 @@ public:
    // Construct
    //
    
-   list(                  const A& a = A()) : pHead(nullptr), pTail(nullptr), numElements(0), alloc(a) { }
-   list(list <T, A>& rhs, const A& a = A()) : pHead(nullptr), pTail(nullptr), numElements(0), alloc(a)
+   list(                  const A& a = A()) : pHead(nullptr), pTail(nullptr), numElements(0), alloc(a),
+                          pFree(nullptr), numFree(0), maxFree(defaultFreeNodes) { }
+   list(list <T, A>& rhs, const A& a = A()) : pHead(nullptr), pTail(nullptr), numElements(0), alloc(a),
+                          pFree(nullptr), numFree(0), maxFree(defaultFreeNodes)
    {
       // do nothing if there is nothing to do 
       if (!rhs.empty())
          for (auto it = rhs.begin(); it != rhs.end(); it++)
             this->push_back(*it);
    }
-   list(list <T, A>&& rhs,                  const A& a = A());
+   list(list <T, A>&& rhs);
    list(size_t num, const T & t,            const A& a = A());
    list(size_t num,                         const A& a = A());
    list(const std::initializer_list<T>& il, const A& a = A()): 
-      pHead(nullptr), pTail(nullptr), numElements(0), alloc(a)
+      pHead(nullptr), pTail(nullptr), numElements(0), alloc(a),
+      pFree(nullptr), numFree(0), maxFree(defaultFreeNodes)
    {
       for (auto it = il.begin(); it != il.end(); it++)
          this->push_back(*it);
    }
    template <class Iterator>
    list(Iterator first, Iterator last, const A& a = A()): pHead(nullptr), pTail(nullptr), 
-                  numElements(0), alloc(a)
+                  numElements(0), alloc(a), pFree(nullptr), numFree(0), maxFree(defaultFreeNodes)
    {
       for (auto it = first; it != last; it++)
       {
-         Node* pNew = new Node(*it);
+         Node* pNew = newNode(*it);
          pNew->pPrev = pTail;
          if (pTail)
             pTail->pNext = pNew;
@@ -84,6 +89,7 @@ public:
    ~list()
    { 
       clear();
+      set_max_free_nodes(0);
    }
    
    //
@@ -98,6 +104,10 @@ public:
       std::swap(this->pHead, rhs.pHead);
       std::swap(this->pTail, rhs.pTail);
       std::swap(this->numElements, rhs.numElements);
+      std::swap(this->alloc, rhs.alloc);
+      std::swap(this->pFree, rhs.pFree);
+      std::swap(this->numFree, rhs.numFree);
+      std::swap(this->maxFree, rhs.maxFree);
    }
 
    //
@@ -135,6 +145,36 @@ public:
    void pop_front();
    void clear();
    iterator erase(const iterator & it);
+   template <class Predicate>
+   size_t remove_if(Predicate pred);
+   size_t remove(const T & value);
+   template <class BinaryPredicate>
+   size_t unique(BinaryPredicate same);
+   size_t unique()
+   {
+      return unique([](const T & lhs, const T & rhs) { return lhs == rhs; });
+   }
+
+   //
+   // Relink: nodes move, nothing is copied or allocated
+   //
+
+   void splice(iterator pos, list <T, A> & rhs);
+   void splice(iterator pos, list <T, A> & rhs, iterator it);
+   void splice(iterator pos, list <T, A> & rhs, iterator first, iterator last);
+   template <class Compare>
+   void merge(list <T, A> & rhs, Compare less);
+   void merge(list <T, A> & rhs)
+   {
+      merge(rhs, [](const T & lhs, const T & rhs) { return lhs < rhs; });
+   }
+   template <class Compare>
+   void sort(Compare less);
+   void sort()
+   {
+      sort([](const T & lhs, const T & rhs) { return lhs < rhs; });
+   }
+   void reverse();
 
    //
    // Status
@@ -143,15 +183,52 @@ public:
    bool empty()  const { return numElements == 0; }
    size_t size() const { return numElements;      }
 
+   //
+   // Free nodes
+   //
+
+   size_t free_nodes()     const { return numFree; }
+   size_t max_free_nodes() const { return maxFree; }
+   void set_max_free_nodes(size_t num);
+
 private:
    // nested linked list class
    class Node;
 
+   // the allocator, rebound from elements to nodes
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+
+   // how many freed nodes a list keeps for reuse, unless told otherwise
+   static const size_t defaultFreeNodes = 64;
+
+   // a node built from args, reusing a freed one when there is one
+   template <class ... Args>
+   Node * newNode(Args && ... args);
+
+   // destroy the node and keep it for reuse, or give it back
+   void deleteNode(Node * p);
+
+   // take the nodes pFirst through pLast out, leaving them linked
+   // to each other; numElements is the caller's to fix
+   void unlink(Node * pFirst, Node * pLast);
+
+   // put the chain pFirst through pLast in before pPos, or at the
+   // back when pPos is nullptr; numElements is the caller's to fix
+   void linkBefore(Node * pPos, Node * pFirst, Node * pLast);
+
+   // merge two sorted chains joined by pNext alone, taking from pLeft
+   // on a tie so the merge is stable
+   template <class Compare>
+   static Node * mergeChains(Node * pLeft, Node * pRight, Compare & less);
+
    // member variables
-   A    alloc;         // use alloacator for memory allocation
+   NodeAlloc alloc;    // use alloacator for memory allocation
    size_t numElements; // though we could count, it is faster to keep a variable
    Node * pHead;       // pointer to the beginning of the list
    Node * pTail;       // pointer to the ending of the list
+   Node * pFree;       // freed nodes, chained through pNext
+   size_t numFree;     // how many nodes are on pFree
+   size_t maxFree;     // the most pFree may hold
 };
 
 /*************************************************
@@ -262,7 +339,7 @@ private:
  ****************************************/
 template <typename T, typename A>
 list <T, A> ::list(size_t num, const T & t, const A& a) : pHead(nullptr), pTail(nullptr), 
-      numElements(0), alloc(a)
+      numElements(0), alloc(a), pFree(nullptr), numFree(0), maxFree(defaultFreeNodes)
 {
    // do nothing if there is nothing to do 
    if (num > 0)
@@ -278,14 +355,14 @@ list <T, A> ::list(size_t num, const T & t, const A& a) : pHead(nullptr), pTail(
  ****************************************/
 template <typename T, typename A>
 list <T, A> ::list(size_t num, const A& a) : pHead(nullptr), pTail(nullptr), 
-      numElements(0), alloc(a)
+      numElements(0), alloc(a), pFree(nullptr), numFree(0), maxFree(defaultFreeNodes)
 {
    // do nothing if there is nothing to do 
    if (num > 0)
    {
       for (size_t i = 0; i < num; i++) // using the allocator? 
       {
-         Node* pNew = new Node();
+         Node* pNew = newNode();
          pNew->pPrev = pTail;
          if (pTail)
             pTail->pNext = pNew;
@@ -300,11 +377,14 @@ list <T, A> ::list(size_t num, const A& a) : pHead(nullptr), pTail(nullptr),
 
 /*****************************************
  * LIST :: MOVE constructors
- * Steal the values from the RHS
+ * Steal the values from the RHS, and its
+ * allocator with them, since the nodes must
+ * go back where they came from
  ****************************************/
 template <typename T, typename A>
-list <T, A> ::list(list <T, A>&& rhs, const A& a) : pHead(rhs.pHead), pTail(rhs.pTail),
-      numElements(rhs.numElements),  alloc(a)
+list <T, A> ::list(list <T, A>&& rhs) : pHead(rhs.pHead), pTail(rhs.pTail),
+      numElements(rhs.numElements),  alloc(rhs.alloc),
+      pFree(nullptr), numFree(0), maxFree(rhs.maxFree)
 {
    rhs.pHead = rhs.pTail = nullptr;
    rhs.numElements = 0;
@@ -410,7 +490,7 @@ list <T, A> & list <T, A> :: operator = (list <T, A> & rhs)
       {
          // remember p.pNext before we kill p...
          pNext = p->pNext;
-         delete p;
+         deleteNode(p);
          // update p 
          p = pNext;
          numElements--;
@@ -513,7 +593,7 @@ list <T, A>& list <T, A> :: operator = (const std::initializer_list<T>& rhs)
       {
          // remember p.pNext before we kill p...
          Node* pNext = pDest->pNext;
-         delete pDest;
+         deleteNode(pDest);
          // update p 
          pDest = pNext;
          numElements--;
@@ -544,7 +624,7 @@ void list <T, A> :: clear()
    while (p)
    {
       Node* pNext = p->pNext;
-      delete p;
+      deleteNode(p);
       p = pNext;
    }
    pHead = nullptr;
@@ -563,7 +643,7 @@ template <typename T, typename A>
 void list <T, A> ::push_back(const T& data)
 {
    // create a new node [z]
-   Node* pNew = new Node(data);
+   Node* pNew = newNode(data);
 
    // new node's pPrev is our tail...
    pNew->pPrev = pTail;
@@ -583,7 +663,7 @@ template <typename T, typename A>
 void list <T, A> ::push_back(T && data)
 {
    // create a new node [z]
-   Node* pNew = new Node(std::move(data));
+   Node* pNew = newNode(std::move(data));
    
    // new node's pPrev is our tail...
    // pTail
@@ -627,7 +707,7 @@ template <typename T, typename A>
 void list <T, A> :: push_front(const T & data)
 {
    // create a new node [a]
-   Node* pNew = new Node(data);
+   Node* pNew = newNode(data);
 
    // new node's pNext is our head...
    //        pHead
@@ -664,7 +744,7 @@ template <typename T, typename A>
 void list <T, A> ::push_front(T && data)
 {
    // create a new node [a]
-   Node* pNew = new Node(std::move(data));
+   Node* pNew = newNode(std::move(data));
 
    // new node's pNext is our head...
    pNew->pNext = pHead;
@@ -698,7 +778,7 @@ void list <T, A> ::pop_back()
       // a list with one element
       if (pTail == pHead)
       {
-         delete pTail;
+         deleteNode(pTail);
          pTail = nullptr;
          pHead = nullptr;
       }
@@ -719,7 +799,7 @@ void list <T, A> ::pop_back()
          pTail->pNext = nullptr;
 
          // obliterate [2] 
-         delete pRemove;
+         deleteNode(pRemove);
       }
       numElements--;
    }
@@ -741,7 +821,7 @@ void list <T, A> ::pop_front()
       // a list with one element
       if (pTail == pHead)
       {
-         delete pHead;
+         deleteNode(pHead);
          pTail = nullptr;
          pHead = nullptr;
       }
@@ -762,7 +842,7 @@ void list <T, A> ::pop_front()
          pHead->pPrev = nullptr;
 
          // obliterate [1]
-         delete pRemove;
+         deleteNode(pRemove);
       }
       numElements--;
    }
@@ -831,7 +911,7 @@ typename list <T, A> :: iterator  list <T, A> :: erase(const list <T, A> :: iter
          pHead = pHead->pNext;
       
       // delete the node
-      delete it.p;
+      deleteNode(it.p);
       numElements --;
    }
    
@@ -853,7 +933,7 @@ typename list <T, A> :: iterator list <T, A> :: insert(list <T, A> :: iterator i
    // inserting on an empty list, ie, new node = head = tail
    if (empty())
    {
-      pHead = new Node(data);
+      pHead = newNode(data);
       pTail = pHead;
       numElements = 1;
       return begin();
@@ -861,7 +941,7 @@ typename list <T, A> :: iterator list <T, A> :: insert(list <T, A> :: iterator i
    // inserting at the end of the list, ie, new node = tail 
    else if (it == end())
    {
-      Node* pNew = new Node(data);
+      Node* pNew = newNode(data);
       pTail->pNext = pNew;
       pNew->pPrev = pTail;
       pTail = pNew;
@@ -871,7 +951,7 @@ typename list <T, A> :: iterator list <T, A> :: insert(list <T, A> :: iterator i
    // inserting in the middle or at the head
    else
    {
-      Node* pNew = new Node(data);
+      Node* pNew = newNode(data);
       pNew->pPrev = it.p->pPrev;
       pNew->pNext = it.p;
       
@@ -910,7 +990,7 @@ typename list <T, A> ::iterator list <T, A> ::insert(list <T, A> ::iterator it,
    // inserting on an empty list, ie, new node = head = tail
    if (empty())
    {
-      pHead = new Node(std::move(data));
+      pHead = newNode(std::move(data));
       pTail = pHead;
       numElements = 1;
       return begin();
@@ -919,7 +999,7 @@ typename list <T, A> ::iterator list <T, A> ::insert(list <T, A> ::iterator it,
    // inserting at the end of the list, ie, new node = tail 
    else if (it == end())
    {
-      Node* pNew = new Node(std::move(data));
+      Node* pNew = newNode(std::move(data));
       pTail->pNext = pNew;
       pNew->pPrev = pTail;
       pTail = pNew;
@@ -930,7 +1010,7 @@ typename list <T, A> ::iterator list <T, A> ::insert(list <T, A> ::iterator it,
    // inserting in the middle or at the head
    else
    {
-      Node* pNew = new Node(std::move(data));
+      Node* pNew = newNode(std::move(data));
       pNew->pPrev = it.p->pPrev;
       pNew->pNext = it.p;
       
@@ -954,6 +1034,478 @@ typename list <T, A> ::iterator list <T, A> ::insert(list <T, A> ::iterator it,
    }
 }
 
+/******************************************
+ * LIST :: REMOVE IF
+ * Erase every element pred says to
+ *     INPUT  : pred  called with each element
+ *     OUTPUT : how many were erased
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+template <class Predicate>
+size_t list <T, A> :: remove_if(Predicate pred)
+{
+   size_t numRemoved = 0;
+   Node * p = pHead;
+   while (p)
+   {
+      Node * pNext = p->pNext;
+      if (pred(p->data))
+      {
+         unlink(p, p);
+         deleteNode(p);
+         numElements--;
+         numRemoved++;
+      }
+      p = pNext;
+   }
+   return numRemoved;
+}
+
+/******************************************
+ * LIST :: REMOVE
+ * Erase every element equal to value. value may
+ * be one of the elements, so the node holding it
+ * is kept until the walk is done.
+ *     INPUT  : value  what to take out
+ *     OUTPUT : how many were erased
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+size_t list <T, A> :: remove(const T & value)
+{
+   size_t numRemoved = 0;
+   Node * pValue = nullptr;   // the node value lives in, if it is ours
+   Node * p = pHead;
+   while (p)
+   {
+      Node * pNext = p->pNext;
+      if (p->data == value)
+      {
+         unlink(p, p);
+         if (&p->data == &value)
+            pValue = p;
+         else
+            deleteNode(p);
+         numElements--;
+         numRemoved++;
+      }
+      p = pNext;
+   }
+   if (pValue)
+      deleteNode(pValue);
+   return numRemoved;
+}
+
+/******************************************
+ * LIST :: UNIQUE
+ * Erase every element that is the same as the
+ * one kept before it, leaving the first of each
+ * run of equals
+ *     INPUT  : same  called as same(kept, next)
+ *     OUTPUT : how many were erased
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+template <class BinaryPredicate>
+size_t list <T, A> :: unique(BinaryPredicate same)
+{
+   size_t numRemoved = 0;
+   Node * pKeep = pHead;
+   while (pKeep && pKeep->pNext)
+   {
+      Node * p = pKeep->pNext;
+      if (same(pKeep->data, p->data))
+      {
+         unlink(p, p);
+         deleteNode(p);
+         numElements--;
+         numRemoved++;
+      }
+      else
+         pKeep = p;
+   }
+   return numRemoved;
+}
+
+/******************************************
+ * LIST :: SPLICE
+ * Move every node of rhs in before pos. rhs
+ * ends up empty. The two lists must share an
+ * allocator, since the nodes will be freed
+ * by this one.
+ *     INPUT  : pos  where the nodes go; end() for the back
+ *              rhs  where they come from
+ *     OUTPUT :
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(iterator pos, list <T, A> & rhs)
+{
+   assert(alloc == rhs.alloc);
+   if (&rhs == this || rhs.empty())
+      return;
+
+   Node * pFirst = rhs.pHead;
+   Node * pLast  = rhs.pTail;
+   size_t num    = rhs.numElements;
+   rhs.unlink(pFirst, pLast);
+   rhs.numElements = 0;
+   linkBefore(pos.p, pFirst, pLast);
+   numElements += num;
+}
+
+/******************************************
+ * LIST :: SPLICE
+ * Move the one node at it, from rhs, in before
+ * pos. rhs may be this list.
+ *     INPUT  : pos  where the node goes; end() for the back
+ *              rhs  the list holding it
+ *              it   the node to move
+ *     OUTPUT :
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(iterator pos, list <T, A> & rhs, iterator it)
+{
+   assert(alloc == rhs.alloc);
+   assert(it.p);
+
+   // already there
+   if (&rhs == this && (it.p == pos.p || it.p->pNext == pos.p))
+      return;
+
+   rhs.unlink(it.p, it.p);
+   rhs.numElements--;
+   linkBefore(pos.p, it.p, it.p);
+   numElements++;
+}
+
+/******************************************
+ * LIST :: SPLICE
+ * Move the nodes [first, last) of rhs in before
+ * pos. rhs may be this list, as long as pos is
+ * not inside the range.
+ *     INPUT  : pos          where the nodes go; end() for the back
+ *              rhs          the list holding them
+ *              first, last  the nodes to move
+ *     OUTPUT :
+ *     COST   : O(1) within one list, otherwise O(n) with
+ *              respect to the nodes moved, to count them
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(iterator pos, list <T, A> & rhs,
+                           iterator first, iterator last)
+{
+   assert(alloc == rhs.alloc);
+   if (first == last)
+      return;
+
+   Node * pFirst = first.p;
+   Node * pLast  = last.p ? last.p->pPrev : rhs.pTail;
+
+   // already there
+   if (&rhs == this && (pFirst == pos.p || pLast->pNext == pos.p))
+      return;
+
+   if (&rhs != this)
+   {
+      size_t num = 1;
+      for (Node * p = pFirst; p != pLast; p = p->pNext)
+         num++;
+      rhs.numElements -= num;
+      numElements += num;
+   }
+   rhs.unlink(pFirst, pLast);
+   linkBefore(pos.p, pFirst, pLast);
+}
+
+/******************************************
+ * LIST :: MERGE
+ * Move the nodes of sorted rhs into this sorted
+ * list, keeping it sorted. On a tie the node
+ * already here comes first.
+ *     INPUT  : rhs   sorted by less; ends up empty
+ *              less  the ordering
+ *     OUTPUT :
+ *     COST   : O(n + m)
+ ******************************************/
+template <typename T, typename A>
+template <class Compare>
+void list <T, A> :: merge(list <T, A> & rhs, Compare less)
+{
+   assert(alloc == rhs.alloc);
+   if (&rhs == this || rhs.empty())
+      return;
+
+   Node * p = pHead;
+   while (p && rhs.pHead)
+   {
+      if (less(rhs.pHead->data, p->data))
+      {
+         // move the run of rhs that goes before p in one piece
+         Node * pFirst = rhs.pHead;
+         Node * pLast  = pFirst;
+         size_t num = 1;
+         while (pLast->pNext && less(pLast->pNext->data, p->data))
+         {
+            pLast = pLast->pNext;
+            num++;
+         }
+         rhs.unlink(pFirst, pLast);
+         rhs.numElements -= num;
+         linkBefore(p, pFirst, pLast);
+         numElements += num;
+      }
+      p = p->pNext;
+   }
+
+   // whatever is left in rhs goes at the back
+   splice(end(), rhs);
+}
+
+/******************************************
+ * LIST :: SORT
+ * A stable bottom-up merge sort that only
+ * relinks nodes. bins[i] holds a sorted run of
+ * 2^i nodes, or nothing; each node coming off
+ * the list is carried up the bins like a binary
+ * counter. The runs only use pNext, so pPrev
+ * and pTail are put back at the end.
+ *     INPUT  : less  the ordering
+ *     OUTPUT :
+ *     COST   : O(n log n)
+ ******************************************/
+template <typename T, typename A>
+template <class Compare>
+void list <T, A> :: sort(Compare less)
+{
+   if (numElements < 2)
+      return;
+
+   const int numBins = 64;
+   Node * bins[numBins] = {};
+   Node * p = pHead;
+   while (p)
+   {
+      Node * pCarry = p;
+      p = p->pNext;
+      pCarry->pNext = nullptr;
+
+      // the runs in the bins are older, so they go on the left
+      int i = 0;
+      for (; i < numBins - 1 && bins[i]; i++)
+      {
+         pCarry = mergeChains(bins[i], pCarry, less);
+         bins[i] = nullptr;
+      }
+      bins[i] = mergeChains(bins[i], pCarry, less);
+   }
+
+   // fold the bins together, older runs on the left
+   Node * pSorted = nullptr;
+   for (int i = 0; i < numBins; i++)
+      if (bins[i])
+         pSorted = mergeChains(bins[i], pSorted, less);
+
+   // put pPrev and pTail back
+   pHead = pSorted;
+   Node * pPrev = nullptr;
+   for (p = pHead; p; p = p->pNext)
+   {
+      p->pPrev = pPrev;
+      pPrev = p;
+   }
+   pTail = pPrev;
+}
+
+/******************************************
+ * LIST :: REVERSE
+ * Swap every node's links, then the ends
+ *     INPUT  :
+ *     OUTPUT :
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: reverse()
+{
+   for (Node * p = pHead; p; p = p->pPrev)
+      std::swap(p->pNext, p->pPrev);
+   std::swap(pHead, pTail);
+}
+
+/**********************************************
+ * LIST :: UNLINK
+ * Close the gap the chain pFirst..pLast leaves.
+ * The chain keeps its inner links; its outer
+ * ones are cleared.
+ *     INPUT  : pFirst, pLast  the chain, in this list
+ *     OUTPUT :
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: unlink(Node * pFirst, Node * pLast)
+{
+   if (pFirst->pPrev)
+      pFirst->pPrev->pNext = pLast->pNext;
+   else
+      pHead = pLast->pNext;
+
+   if (pLast->pNext)
+      pLast->pNext->pPrev = pFirst->pPrev;
+   else
+      pTail = pFirst->pPrev;
+
+   pFirst->pPrev = nullptr;
+   pLast->pNext = nullptr;
+}
+
+/**********************************************
+ * LIST :: LINK BEFORE
+ * Hook the chain pFirst..pLast in before pPos
+ *     INPUT  : pPos           a node of this list, or nullptr for the back
+ *              pFirst, pLast  a chain not in any list
+ *     OUTPUT :
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: linkBefore(Node * pPos, Node * pFirst, Node * pLast)
+{
+   Node * pPrev = pPos ? pPos->pPrev : pTail;
+   pFirst->pPrev = pPrev;
+   pLast->pNext = pPos;
+
+   if (pPrev)
+      pPrev->pNext = pFirst;
+   else
+      pHead = pFirst;
+
+   if (pPos)
+      pPos->pPrev = pLast;
+   else
+      pTail = pLast;
+}
+
+/**********************************************
+ * LIST :: MERGE CHAINS
+ * Merge two sorted chains into one by their
+ * pNext links. pPrev is left for the caller.
+ *     INPUT  : pLeft, pRight  sorted chains, either may be nullptr
+ *              less           the ordering
+ *     OUTPUT : the head of the merged chain
+ *     COST   : O(n + m)
+ *********************************************/
+template <typename T, typename A>
+template <class Compare>
+typename list <T, A> :: Node * list <T, A> :: mergeChains(Node * pLeft, Node * pRight,
+                                                         Compare & less)
+{
+   // ppLink is the link the next node goes in, so no dummy node is needed
+   Node * pMerged = nullptr;
+   Node ** ppLink = &pMerged;
+   while (pLeft && pRight)
+   {
+      if (less(pRight->data, pLeft->data))
+      {
+         *ppLink = pRight;
+         pRight = pRight->pNext;
+      }
+      else
+      {
+         *ppLink = pLeft;
+         pLeft = pLeft->pNext;
+      }
+      ppLink = &(*ppLink)->pNext;
+   }
+   *ppLink = pLeft ? pLeft : pRight;
+   return pMerged;
+}
+
+/**********************************************
+ * LIST :: NEW NODE
+ * Build a node, in a freed one if the list kept
+ * any, otherwise in one from the allocator. If
+ * the element's constructor throws, the memory
+ * goes back where it came from.
+ *     INPUT  : args for the node's constructor
+ *     OUTPUT : the new node, not yet linked in
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+template <class ... Args>
+typename list <T, A> :: Node * list <T, A> :: newNode(Args && ... args)
+{
+   Node * p;
+   if (pFree)
+   {
+      p = pFree;
+      pFree = pFree->pNext;
+      numFree--;
+   }
+   else
+      p = std::allocator_traits<NodeAlloc>::allocate(alloc, 1);
+
+   try
+   {
+      std::allocator_traits<NodeAlloc>::construct(alloc, p, std::forward<Args>(args)...);
+   }
+   catch (...)
+   {
+      p->pNext = pFree;
+      pFree = p;
+      numFree++;
+      throw;
+   }
+   return p;
+}
+
+/**********************************************
+ * LIST :: DELETE NODE
+ * Destroy the node. Keep its memory on the free
+ * list for the next insert unless the list
+ * already holds maxFree, in which case it goes
+ * back to the allocator.
+ *     INPUT  : p  an unlinked node
+ *     OUTPUT :
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: deleteNode(Node * p)
+{
+   std::allocator_traits<NodeAlloc>::destroy(alloc, p);
+   if (numFree < maxFree)
+   {
+      p->pNext = pFree;
+      pFree = p;
+      numFree++;
+   }
+   else
+      std::allocator_traits<NodeAlloc>::deallocate(alloc, p, 1);
+}
+
+/**********************************************
+ * LIST :: SET MAX FREE NODES
+ * Change how many freed nodes the list keeps,
+ * giving back any over the new limit. Zero
+ * sends every freed node straight back to the
+ * allocator.
+ *     INPUT  : num  the new limit
+ *     OUTPUT :
+ *     COST   : O(n) with respect to the nodes given back
+ *********************************************/
+template <typename T, typename A>
+void list <T, A> :: set_max_free_nodes(size_t num)
+{
+   maxFree = num;
+   while (numFree > maxFree)
+   {
+      Node * p = pFree;
+      pFree = pFree->pNext;
+      numFree--;
+      std::allocator_traits<NodeAlloc>::deallocate(alloc, p, 1);
+   }
+}
+
 /**********************************************
  * LIST :: assignment operator - MOVE
  * Copy one list onto another
@@ -0,0 +1,296 @@
+/***********************************************************************
+ * Header:
+ *    NODE POOL
+ * Summary:
+ *    A slab allocator for small fixed-size objects such as list nodes.
+ *    Memory comes from the system in chunks of many nodes; a freed node
+ *    goes on a free list threaded through the node itself and is the
+ *    next one handed out. Allocating and freeing are a few pointer
+ *    moves, and churning nodes never reaches malloc.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        slab_pool      : Blocks of one size, carved from chunks
+ *        node_pool      : A slab_pool per size class
+ *        pool_allocator : An allocator drawing single objects from a node_pool
+ * Author
+ *    Thatcher Albiston
+ *    Elroe Woldemichael
+ *    Jacob Mower
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for ASSERT
+#include <cstddef>     // for std::max_align_t
+#include <memory>      // for std::shared_ptr
+#include <new>         // for ::operator new
+
+class TestNodePool; // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * SLAB POOL
+ * Hands out blocks of sizeBlock bytes. Chunks start
+ * small and double up to a limit, so a pool that only
+ * ever holds a few nodes stays small. A new chunk is
+ * carved lazily: blocks are taken from its unused end
+ * only when the free list is empty. Every chunk is
+ * kept until the pool is destroyed.
+ *
+ * Like the containers, a pool is not for use from
+ * several threads at once.
+ **************************************************/
+class slab_pool
+{
+   friend class ::TestNodePool; // give unit tests access to the privates
+public:
+   explicit slab_pool(size_t sizeBlock) :
+      sizeBlock(roundUp(sizeBlock)), pFree(nullptr), pChunks(nullptr),
+      pFresh(nullptr), pFreshEnd(nullptr),
+      numNextChunk(minChunkBlocks), numBlocks(0), numInUse(0) { }
+   slab_pool(const slab_pool &) = delete;
+   slab_pool & operator = (const slab_pool &) = delete;
+  ~slab_pool();
+
+   void * allocate();
+   void deallocate(void * p);
+
+   size_t block_size() const { return sizeBlock; }
+   size_t capacity()   const { return numBlocks; }   // blocks in all chunks
+   size_t in_use()     const { return numInUse; }
+
+private:
+   // a freed block holds the link to the next freed block
+   struct FreeBlock
+   {
+      FreeBlock * pNext;
+   };
+
+   // a chunk starts with this, followed by its blocks
+   struct alignas(std::max_align_t) Chunk
+   {
+      Chunk * pNext;
+   };
+
+   static const size_t minChunkBlocks = 16;
+   static const size_t maxChunkBlocks = 4096;
+
+   // a block must be able to hold the free list link
+   static size_t roundUp(size_t size)
+   {
+      size_t align = alignof(FreeBlock);
+      size = size < sizeof(FreeBlock) ? sizeof(FreeBlock) : size;
+      return (size + align - 1) / align * align;
+   }
+
+   void grow();
+
+   size_t sizeBlock;      // bytes per block
+   FreeBlock * pFree;     // blocks given back, most recent first
+   Chunk * pChunks;       // every chunk, most recent first
+   char * pFresh;         // the next never-used block in the newest chunk
+   char * pFreshEnd;      // the end of the newest chunk
+   size_t numNextChunk;   // blocks in the next chunk
+   size_t numBlocks;      // blocks in all chunks
+   size_t numInUse;       // blocks handed out and not given back
+};
+
+/**************************************************
+ * NODE POOL
+ * A slab_pool for every size class of eight bytes up
+ * to maxSize, each made the first time it is needed.
+ * Larger sizes go straight to operator new. Since a
+ * list's allocator is rebound to its node type, the
+ * pool is shared by size rather than by type.
+ **************************************************/
+class node_pool
+{
+   friend class ::TestNodePool; // give unit tests access to the privates
+public:
+   node_pool() : pools() { }
+   node_pool(const node_pool &) = delete;
+   node_pool & operator = (const node_pool &) = delete;
+  ~node_pool()
+   {
+      for (size_t i = 0; i < numClasses; i++)
+         delete pools[i];
+   }
+
+   void * allocate(size_t size)
+   {
+      if (size > maxSize)
+         return ::operator new(size);
+      slab_pool *& pPool = pools[classOf(size)];
+      if (!pPool)
+         pPool = new slab_pool((classOf(size) + 1) * classSize);
+      return pPool->allocate();
+   }
+
+   void deallocate(void * p, size_t size)
+   {
+      if (size > maxSize)
+         ::operator delete(p);
+      else
+      {
+         assert(pools[classOf(size)]);
+         pools[classOf(size)]->deallocate(p);
+      }
+   }
+
+   // blocks of this size handed out and not given back
+   size_t in_use(size_t size) const
+   {
+      const slab_pool * pPool = size > maxSize ? nullptr : pools[classOf(size)];
+      return pPool ? pPool->in_use() : 0;
+   }
+
+private:
+   static const size_t classSize  = 8;
+   static const size_t maxSize    = 256;
+   static const size_t numClasses = maxSize / classSize;
+
+   static size_t classOf(size_t size)
+   {
+      return size == 0 ? 0 : (size - 1) / classSize;
+   }
+
+   slab_pool * pools[numClasses];
+};
+
+/**************************************************
+ * POOL ALLOCATOR
+ * An allocator that takes single objects from a
+ * node_pool. Copies and rebinds share the pool, so
+ * lists given copies of one allocator recycle each
+ * other's nodes; a default-constructed allocator
+ * makes a pool of its own. Arrays, and types aligned
+ * more strictly than a pointer, go to operator new.
+ **************************************************/
+template <typename T>
+class pool_allocator
+{
+   template <typename U>
+   friend class pool_allocator;
+public:
+   typedef T value_type;
+   template <typename U> struct rebind { typedef pool_allocator<U> other; };
+
+   pool_allocator() : pPool(std::make_shared<node_pool>()) { }
+   explicit pool_allocator(const std::shared_ptr<node_pool> & pPool) : pPool(pPool) { }
+   template <typename U>
+   pool_allocator(const pool_allocator<U> & rhs) : pPool(rhs.pPool) { }
+
+   T * allocate(size_t num)
+   {
+      if (num == 1 && pooled())
+         return static_cast<T *>(pPool->allocate(sizeof(T)));
+      return static_cast<T *>(::operator new(num * sizeof(T)));
+   }
+
+   void deallocate(T * p, size_t num)
+   {
+      if (num == 1 && pooled())
+         pPool->deallocate(p, sizeof(T));
+      else
+         ::operator delete(p);
+   }
+
+   const std::shared_ptr<node_pool> & pool() const { return pPool; }
+
+   template <typename U>
+   bool operator == (const pool_allocator<U> & rhs) const { return pPool == rhs.pPool; }
+   template <typename U>
+   bool operator != (const pool_allocator<U> & rhs) const { return pPool != rhs.pPool; }
+
+private:
+   // a function, so the check waits until T is complete
+   static bool pooled() { return alignof(T) <= alignof(void *); }
+
+   std::shared_ptr<node_pool> pPool;
+};
+
+/*****************************************
+ * SLAB POOL :: DESTRUCTOR
+ * Give every chunk back. Blocks still in use
+ * go with them.
+ ****************************************/
+inline slab_pool :: ~slab_pool()
+{
+   while (pChunks)
+   {
+      Chunk * pNext = pChunks->pNext;
+      ::operator delete(pChunks);
+      pChunks = pNext;
+   }
+}
+
+/*****************************************
+ * SLAB POOL :: ALLOCATE
+ * The most recently freed block, else the next
+ * fresh one, else a fresh chunk
+ *     INPUT  :
+ *     OUTPUT : sizeBlock bytes
+ *     COST   : O(1)
+ ****************************************/
+inline void * slab_pool :: allocate()
+{
+   void * p;
+   if (pFree)
+   {
+      p = pFree;
+      pFree = pFree->pNext;
+   }
+   else
+   {
+      if (pFresh == pFreshEnd)
+         grow();
+      p = pFresh;
+      pFresh += sizeBlock;
+   }
+   numInUse++;
+   return p;
+}
+
+/*****************************************
+ * SLAB POOL :: DEALLOCATE
+ * Push the block on the free list
+ *     INPUT  : p  a block from this pool
+ *     OUTPUT :
+ *     COST   : O(1)
+ ****************************************/
+inline void slab_pool :: deallocate(void * p)
+{
+   assert(numInUse > 0);
+   FreeBlock * pBlock = static_cast<FreeBlock *>(p);
+   pBlock->pNext = pFree;
+   pFree = pBlock;
+   numInUse--;
+}
+
+/*****************************************
+ * SLAB POOL :: GROW
+ * Add a chunk of numNextChunk blocks and double
+ * numNextChunk for next time, up to the limit
+ ****************************************/
+inline void slab_pool :: grow()
+{
+   Chunk * pChunk = static_cast<Chunk *>(
+      ::operator new(sizeof(Chunk) + numNextChunk * sizeBlock));
+   pChunk->pNext = pChunks;
+   pChunks = pChunk;
+
+   pFresh = reinterpret_cast<char *>(pChunk + 1);
+   pFreshEnd = pFresh + numNextChunk * sizeBlock;
+   numBlocks += numNextChunk;
+   if (numNextChunk < maxChunkBlocks)
+      numNextChunk *= 2;
+}
+
+}; // namespace custom
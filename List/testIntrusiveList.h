@@ -0,0 +1,367 @@
+/***********************************************************************
+ * Header:
+ *    TEST INTRUSIVE LIST
+ * Summary:
+ *    Unit tests for intrusive_list
+ * Author
+ *    Thatcher Albiston
+ *    Elroe Woldemichael
+ *    Jacob Mower
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "intrusive_list.h"
+#include "unitTest.h"
+
+#include <vector>
+#include <cassert>
+
+/***************************************
+ * TASK
+ * Hooked in by inheritance: once untagged,
+ * once for a second list
+ ***************************************/
+struct TagReady;
+struct Task : public custom::list_base_hook<>,
+              public custom::list_base_hook<TagReady>
+{
+   Task(int id = 0) : id(id) { }
+   int id;
+};
+
+/***************************************
+ * JOB
+ * Hooked in by two members
+ ***************************************/
+struct Job
+{
+   Job(int id = 0) : id(id) { }
+   int id;
+   custom::list_hook hookAll;
+   custom::list_hook hookMine;
+};
+
+class TestIntrusiveList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Insert
+      test_pushback_empty();
+      test_pushback_standard();
+      test_pushfront_standard();
+      test_insert_middle();
+
+      // Remove
+      test_erase_middle();
+      test_erase_ends();
+      test_clear_unlinksAll();
+      test_destructor_unlinksAll();
+
+      // Hooks
+      test_hook_copyUnlinked();
+      test_hook_twoBaseLists();
+      test_hook_twoMemberLists();
+      test_iteratorTo_remove();
+      test_move();
+
+      report("IntrusiveList");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty list, and an object on no list
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Task t(11);
+      custom::intrusive_list<Task> l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.begin() == l.end());
+      assertUnit(!t.custom::list_base_hook<>::is_linked());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the only element has no neighbours but is still linked
+   void test_pushback_empty()
+   {  // setup
+      Task t(11);
+      custom::intrusive_list<Task> l;
+      // exercise
+      l.push_back(t);
+      // verify
+      assertUnit(l.size() == 1);
+      assertUnit(&l.front() == &t);
+      assertUnit(&l.back() == &t);
+      assertUnit(t.custom::list_base_hook<>::is_linked());
+      assertUnit(l.pHead->pNext == nullptr);
+      assertUnit(l.pHead->pPrev == nullptr);
+   }  // teardown
+
+   // push_back links the objects themselves, in order
+   void test_pushback_standard()
+   {  // setup
+      Task t11(11), t26(26), t31(31);
+      custom::intrusive_list<Task> l;
+      // exercise
+      l.push_back(t11);
+      l.push_back(t26);
+      l.push_back(t31);
+      // verify
+      assertUnit(ids(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(&*l.begin() == &t11);
+      assertUnit(&l.back() == &t31);
+      assertUnit(linked(l));
+   }  // teardown
+
+   // push_front puts each in at the head
+   void test_pushfront_standard()
+   {  // setup
+      Task t11(11), t26(26), t31(31);
+      custom::intrusive_list<Task> l;
+      // exercise
+      l.push_front(t31);
+      l.push_front(t26);
+      l.push_front(t11);
+      // verify
+      assertUnit(ids(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   // insert before an element in the middle
+   void test_insert_middle()
+   {  // setup
+      Task t11(11), t26(26), t31(31), t99(99);
+      custom::intrusive_list<Task> l;
+      l.push_back(t11);
+      l.push_back(t26);
+      l.push_back(t31);
+      // exercise
+      auto it = l.insert(++l.begin(), t99);
+      // verify
+      assertUnit(&*it == &t99);
+      assertUnit(it->id == 99);
+      assertUnit(ids(l) == std::vector<int>({ 11, 99, 26, 31 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase unlinks the object and returns the one after it
+   void test_erase_middle()
+   {  // setup
+      Task t11(11), t26(26), t31(31);
+      custom::intrusive_list<Task> l;
+      l.push_back(t11);
+      l.push_back(t26);
+      l.push_back(t31);
+      // exercise
+      auto it = l.erase(++l.begin());
+      // verify
+      assertUnit(&*it == &t31);
+      assertUnit(!t26.custom::list_base_hook<>::is_linked());
+      assertUnit(t26.id == 26);
+      assertUnit(ids(l) == std::vector<int>({ 11, 31 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   // popping both ends fixes pHead and pTail
+   void test_erase_ends()
+   {  // setup
+      Task t11(11), t26(26), t31(31);
+      custom::intrusive_list<Task> l;
+      l.push_back(t11);
+      l.push_back(t26);
+      l.push_back(t31);
+      // exercise
+      l.pop_front();
+      l.pop_back();
+      // verify
+      assertUnit(l.size() == 1);
+      assertUnit(&l.front() == &t26);
+      assertUnit(&l.back() == &t26);
+      assertUnit(!t11.custom::list_base_hook<>::is_linked());
+      assertUnit(!t31.custom::list_base_hook<>::is_linked());
+      assertUnit(linked(l));
+   }  // teardown
+
+   // clear unlinks everything and destroys nothing
+   void test_clear_unlinksAll()
+   {  // setup
+      Task t11(11), t26(26);
+      custom::intrusive_list<Task> l;
+      l.push_back(t11);
+      l.push_back(t26);
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.pHead == nullptr);
+      assertUnit(!t11.custom::list_base_hook<>::is_linked());
+      assertUnit(!t26.custom::list_base_hook<>::is_linked());
+      assertUnit(t26.id == 26);
+   }  // teardown
+
+   // the objects outlive their list
+   void test_destructor_unlinksAll()
+   {  // setup
+      Task t11(11), t26(26);
+      {
+         custom::intrusive_list<Task> l;
+         l.push_back(t11);
+         l.push_back(t26);
+         // exercise
+      }
+      // verify
+      assertUnit(!t11.custom::list_base_hook<>::is_linked());
+      assertUnit(!t26.custom::list_base_hook<>::is_linked());
+   }  // teardown
+
+   /***************************************
+    * HOOKS
+    ***************************************/
+
+   // a copy of a linked object is not on the list
+   void test_hook_copyUnlinked()
+   {  // setup
+      Task t11(11);
+      custom::intrusive_list<Task> l;
+      l.push_back(t11);
+      // exercise
+      Task tCopy(t11);
+      // verify
+      assertUnit(tCopy.id == 11);
+      assertUnit(!tCopy.custom::list_base_hook<>::is_linked());
+      assertUnit(l.size() == 1);
+      assertUnit(&l.front() == &t11);
+   }  // teardown
+
+   // one object on two lists through two tagged base hooks
+   void test_hook_twoBaseLists()
+   {  // setup
+      Task t11(11), t26(26), t31(31);
+      custom::intrusive_list<Task> lAll;
+      custom::intrusive_list<Task, custom::base_hook<TagReady>> lReady;
+      lAll.push_back(t11);
+      lAll.push_back(t26);
+      lAll.push_back(t31);
+      // exercise
+      lReady.push_back(t31);
+      lReady.push_back(t11);
+      lAll.erase(lAll.iterator_to(t11));
+      // verify
+      assertUnit(ids(lAll) == std::vector<int>({ 26, 31 }));
+      assertUnit(ids(lReady) == std::vector<int>({ 31, 11 }));
+      assertUnit(linked(lAll));
+      assertUnit(linked(lReady));
+   }  // teardown
+
+   // one object on two lists through two member hooks
+   void test_hook_twoMemberLists()
+   {  // setup
+      Job j11(11), j26(26), j31(31);
+      custom::intrusive_list<Job, custom::member_hook<Job, &Job::hookAll>> lAll;
+      custom::intrusive_list<Job, custom::member_hook<Job, &Job::hookMine>> lMine;
+      // exercise
+      lAll.push_back(j11);
+      lAll.push_back(j26);
+      lAll.push_back(j31);
+      lMine.push_back(j26);
+      // verify
+      assertUnit(&lMine.front() == &j26);
+      assertUnit(&lAll.back() == &j31);
+      assertUnit(lMine.begin()->id == 26);
+      assertUnit(ids(lAll) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(j26.hookAll.is_linked());
+      assertUnit(j26.hookMine.is_linked());
+      assertUnit(!j11.hookMine.is_linked());
+      assertUnit(linked(lAll));
+      assertUnit(linked(lMine));
+   }  // teardown
+
+   // an object takes itself off a list without a search
+   void test_iteratorTo_remove()
+   {  // setup
+      Job j11(11), j26(26), j31(31);
+      custom::intrusive_list<Job, custom::member_hook<Job, &Job::hookAll>> l;
+      l.push_back(j11);
+      l.push_back(j26);
+      l.push_back(j31);
+      // exercise
+      l.remove(j31);
+      // verify
+      assertUnit(!j31.hookAll.is_linked());
+      assertUnit(&l.back() == &j26);
+      assertUnit(ids(l) == std::vector<int>({ 11, 26 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   // moving a list moves the links, not the objects
+   void test_move()
+   {  // setup
+      Task t11(11), t26(26);
+      custom::intrusive_list<Task> lSrc;
+      lSrc.push_back(t11);
+      lSrc.push_back(t26);
+      // exercise
+      custom::intrusive_list<Task> lDes(std::move(lSrc));
+      // verify
+      assertUnit(lSrc.empty());
+      assertUnit(lSrc.pHead == nullptr);
+      assertUnit(ids(lDes) == std::vector<int>({ 11, 26 }));
+      assertUnit(linked(lDes));
+   }  // teardown
+
+   /****************************************************************
+    * IDs
+    * The elements' ids, in order
+    ****************************************************************/
+   template <class List>
+   std::vector<int> ids(List& l)
+   {
+      std::vector<int> v;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         v.push_back(it->id);
+      return v;
+   }
+
+   /****************************************************************
+    * Linked
+    * Every pPrev matches its pNext, the ends are right,
+    * and there are numElements hooks
+    ****************************************************************/
+   template <class List>
+   bool linked(const List& l)
+   {
+      size_t num = 0;
+      custom::list_hook* pPrev = nullptr;
+      for (custom::list_hook* p = l.pHead; p; p = p->pNext)
+      {
+         if (p->pPrev != pPrev)
+            return false;
+         pPrev = p;
+         num++;
+      }
+      return pPrev == l.pTail && num == l.numElements;
+   }
+};
+
+#endif // DEBUG
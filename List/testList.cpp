@@ -13,9 +13,15 @@
 #else
 #define PRIVATE public
 #endif
+//#define BENCHMARK  // Remove this comment to time the lists
 
 #include "testList.h"       // for the list unit tests
+#include "testNodePool.h"   // for the node pool unit tests
+#include "testIntrusiveList.h" // for the intrusive list unit tests
+#include "testUnrolledList.h"  // for the unrolled list unit tests
 #include "testSpy.h"        // for the spy unit tests
+#include "benchList.h"      // for the list churn benchmark
+#include "benchUnrolledList.h" // for the unrolled list walk benchmark
 int Spy::counters[] = {};
 
 
@@ -29,7 +35,15 @@ int main()
    // unit tests
    TestSpy().run();
    TestList().run();
+   TestNodePool().run();
+   TestIntrusiveList().run();
+   TestUnrolledList().run();
 #endif // DEBUG
+
+#ifdef BENCHMARK
+   BenchList().run();
+   BenchUnrolledList().run();
+#endif // BENCHMARK
    
    return 0;
 }
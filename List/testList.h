@@ -17,8 +17,11 @@
 #include "spy.h"
 
 #include <vector>
+#include <algorithm>
+#include <utility>
 #include <cassert>
 #include <memory>
+#include <string>
 #include <iostream>
 
 class TestList : public UnitTest
@@ -121,6 +124,28 @@ public:
       test_empty_empty();
       test_empty_three();
 
+      // Free nodes
+      test_free_clearKeeps();
+      test_free_limit();
+      test_free_setZero();
+      test_free_swap();
+      test_free_poolAllocator();
+      test_free_poolShared();
+
+      // Relink
+      test_splice_whole();
+      test_splice_oneSameList();
+      test_splice_oneOther();
+      test_splice_oneInPlace();
+      test_splice_range();
+      test_merge_stable();
+      test_sort_noCopies();
+      test_sort_stable();
+      test_unique();
+      test_removeIf();
+      test_remove_elementOfList();
+      test_reverse();
+
       report("List");
    }
 
@@ -3119,6 +3144,407 @@ public:
       teardownStandardFixture(l);
    }
 
+   /***************************************
+    * FREE NODES
+    ***************************************/
+
+   // clear keeps the nodes, and the next insert reuses one
+   void test_free_clearKeeps()
+   {  // setup
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      custom::list<Spy>::Node* pLast = l.pTail;
+      Spy::reset();
+      // exercise
+      l.clear();
+      l.push_back(Spy(99));
+      // verify
+      assertUnit(Spy::numDestructor() == 4); // destroy [11][26][31] and the temporary
+      assertUnit(l.free_nodes() == 2);
+      assertUnit(l.pHead == pLast);          // the last one freed
+      assertUnit(l.pHead->data == Spy(99));
+      assertUnit(l.pHead->pNext == nullptr);
+      assertUnit(l.pHead->pPrev == nullptr);
+      assertUnit(l.numElements == 1);
+   }  // teardown
+
+   // no more than max_free_nodes are kept
+   void test_free_limit()
+   {  // setup
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      l.set_max_free_nodes(2);
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(l.max_free_nodes() == 2);
+      assertUnit(l.free_nodes() == 2);
+      assertEmptyFixture(l);
+   }  // teardown
+
+   // lowering the limit gives the extra nodes back
+   void test_free_setZero()
+   {  // setup
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      l.clear();
+      // exercise
+      l.set_max_free_nodes(0);
+      l.push_back(Spy(99));
+      l.pop_back();
+      // verify
+      assertUnit(l.free_nodes() == 0);
+      assertUnit(l.pFree == nullptr);
+      assertEmptyFixture(l);
+   }  // teardown
+
+   // swap trades the free nodes along with the elements
+   void test_free_swap()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupStandardFixture(lSrc);
+      lSrc.pop_front();
+      custom::list<Spy> lDes;
+      // exercise
+      lDes.swap(lSrc);
+      // verify
+      assertUnit(lSrc.free_nodes() == 0);
+      assertUnit(lDes.free_nodes() == 1);
+      assertUnit(lDes.size() == 2);
+      assertEmptyFixture(lSrc);
+      // teardown
+      teardownStandardFixture(lDes);
+   }
+
+   // a list on a pool takes its nodes from the pool and gives them back
+   void test_free_poolAllocator()
+   {  // setup
+      custom::pool_allocator<Spy> a;
+      {
+         custom::list<Spy, custom::pool_allocator<Spy>> l(a);
+         l.set_max_free_nodes(0);
+         // exercise
+         for (int i = 0; i < 100; i++)
+            l.push_back(Spy(i));
+         // verify
+         assertUnit(a.pool()->in_use(sizeof(custom::list<Spy, custom::pool_allocator<Spy>>::Node)) == 100);
+         assertUnit(l.size() == 100);
+         assertUnit(l.front() == Spy(0));
+         assertUnit(l.back() == Spy(99));
+         l.clear();
+         assertUnit(a.pool()->in_use(sizeof(custom::list<Spy, custom::pool_allocator<Spy>>::Node)) == 0);
+      }
+   }  // teardown
+
+   // two lists sharing a pool reuse each other's nodes
+   void test_free_poolShared()
+   {  // setup
+      custom::pool_allocator<int> a;
+      custom::list<int, custom::pool_allocator<int>> l1(a);
+      custom::list<int, custom::pool_allocator<int>> l2(a);
+      l1.set_max_free_nodes(0);
+      l1.push_back(26);
+      auto pNode = l1.pHead;
+      l1.pop_back();
+      // exercise
+      l2.push_back(49);
+      // verify
+      assertUnit(l2.pHead == pNode);
+      assertUnit(l1.alloc == l2.alloc);
+      assertUnit(l2.front() == 49);
+   }  // teardown
+
+   /***************************************
+    * RELINK
+    ***************************************/
+
+   // splice a whole list in at the front, moving the nodes themselves
+   void test_splice_whole()
+   {  // setup
+      //     pHead             pTail
+      //    +----+   +----+   +----+
+      //    | 11 | - | 26 | - | 31 |
+      //    +----+   +----+   +----+
+      custom::list<Spy> lSrc;
+      setupStandardFixture(lSrc);
+      custom::list<Spy>::Node* p11 = lSrc.pHead;
+      custom::list<Spy> lDes;
+      lDes.push_back(Spy(99));
+      Spy::reset();
+      // exercise
+      lDes.splice(lDes.begin(), lSrc);
+      // verify
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertEmptyFixture(lSrc);
+      assertUnit(lDes.pHead == p11);
+      assertUnit(values(lDes) == std::vector<int>({ 11, 26, 31, 99 }));
+      assertUnit(linked(lDes));
+   }  // teardown
+
+   // splice one node from the back of a list to its front
+   void test_splice_oneSameList()
+   {  // setup
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      custom::list<Spy>::Node* p31 = l.pTail;
+      Spy::reset();
+      // exercise
+      l.splice(l.begin(), l, custom::list<Spy>::iterator(p31));
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(l.pHead == p31);
+      assertUnit(l.size() == 3);
+      assertUnit(values(l) == std::vector<int>({ 31, 11, 26 }));
+      assertUnit(linked(l));
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // splice the tail of one list onto the end of another
+   void test_splice_oneOther()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupStandardFixture(lSrc);
+      custom::list<Spy>::Node* p31 = lSrc.pTail;
+      custom::list<Spy> lDes;
+      lDes.push_back(Spy(99));
+      // exercise
+      lDes.splice(lDes.end(), lSrc, custom::list<Spy>::iterator(p31));
+      // verify
+      assertUnit(lDes.pTail == p31);
+      assertUnit(lSrc.size() == 2);
+      assertUnit(lDes.size() == 2);
+      assertUnit(values(lSrc) == std::vector<int>({ 11, 26 }));
+      assertUnit(values(lDes) == std::vector<int>({ 99, 31 }));
+      assertUnit(linked(lSrc));
+      assertUnit(linked(lDes));
+   }  // teardown
+
+   // splice a node to where it already is
+   void test_splice_oneInPlace()
+   {  // setup
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      custom::list<Spy>::Node* p26 = l.pHead->pNext;
+      // exercise
+      l.splice(custom::list<Spy>::iterator(l.pTail), l, custom::list<Spy>::iterator(p26));
+      // verify
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // splice the back two nodes of one list onto the end of another
+   void test_splice_range()
+   {  // setup
+      custom::list<Spy> lSrc;
+      setupStandardFixture(lSrc);
+      custom::list<Spy> lDes;
+      lDes.push_back(Spy(99));
+      Spy::reset();
+      // exercise
+      lDes.splice(lDes.end(), lSrc, ++lSrc.begin(), lSrc.end());
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(lSrc.size() == 1);
+      assertUnit(lDes.size() == 3);
+      assertUnit(values(lSrc) == std::vector<int>({ 11 }));
+      assertUnit(values(lDes) == std::vector<int>({ 99, 26, 31 }));
+      assertUnit(linked(lSrc));
+      assertUnit(linked(lDes));
+   }  // teardown
+
+   // merge two sorted lists; equal elements of this list come first
+   void test_merge_stable()
+   {  // setup
+      custom::list<Spy> l1;
+      custom::list<Spy> l2;
+      for (int i : { 1, 3, 5 })
+         l1.push_back(Spy(i));
+      for (int i : { 2, 3, 4, 6 })
+         l2.push_back(Spy(i));
+      custom::list<Spy>::Node* p3Left = l1.pHead->pNext;
+      custom::list<Spy>::Node* p3Right = l2.pHead->pNext;
+      Spy::reset();
+      // exercise
+      l1.merge(l2);
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(l2.empty());
+      assertUnit(l2.pHead == nullptr);
+      assertUnit(l1.size() == 7);
+      assertUnit(values(l1) == std::vector<int>({ 1, 2, 3, 3, 4, 5, 6 }));
+      assertUnit(p3Left->pNext == p3Right);
+      assertUnit(linked(l1));
+   }  // teardown
+
+   // sort by relinking: nothing is copied, assigned or allocated
+   void test_sort_noCopies()
+   {  // setup
+      custom::list<Spy> l;
+      for (int i : { 31, 11, 99, 26, 11 })
+         l.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(values(l) == std::vector<int>({ 11, 11, 26, 31, 99 }));
+      assertUnit(linked(l));
+      assertUnit(l.free_nodes() == 0);
+   }  // teardown
+
+   // a big sort matches std::stable_sort, ties and all
+   void test_sort_stable()
+   {  // setup
+      custom::list<std::pair<int, int>> l;
+      std::vector<std::pair<int, int>> v;
+      unsigned int seed = 26;
+      for (int i = 0; i < 1000; i++)
+      {
+         seed = seed * 1103515245u + 12345u;
+         std::pair<int, int> element((int)((seed >> 16) % 50), i);
+         l.push_back(element);
+         v.push_back(element);
+      }
+      auto byKey = [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs)
+      {
+         return lhs.first < rhs.first;
+      };
+      // exercise
+      l.sort(byKey);
+      // verify
+      std::stable_sort(v.begin(), v.end(), byKey);
+      bool same = true;
+      auto it = l.begin();
+      for (size_t i = 0; i < v.size(); i++, ++it)
+         same = same && *it == v[i];
+      assertUnit(same);
+      assertUnit(it == l.end());
+      assertUnit(linked(l));
+   }  // teardown
+
+   // unique keeps the first of each run of equals
+   void test_unique()
+   {  // setup
+      custom::list<Spy> l;
+      for (int i : { 11, 11, 26, 26, 26, 31, 11 })
+         l.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      size_t numRemoved = l.unique();
+      // verify
+      assertUnit(numRemoved == 3);
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(values(l) == std::vector<int>({ 11, 26, 31, 11 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   // remove_if takes out matches anywhere, ends included
+   void test_removeIf()
+   {  // setup
+      custom::list<Spy> l;
+      for (int i : { 10, 11, 26, 31, 40 })
+         l.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      size_t numRemoved = l.remove_if([](const Spy& s) { return s.get() % 2 == 0; });
+      // verify
+      assertUnit(numRemoved == 3);
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(values(l) == std::vector<int>({ 11, 31 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   // the value to remove can be one of the elements it removes
+   void test_remove_elementOfList()
+   {  // setup
+      custom::list<Spy> l;
+      for (int i : { 11, 26, 11, 31, 11 })
+         l.push_back(Spy(i));
+      custom::list<std::string> lString{ "a", "b", "a", "a" };
+      Spy::reset();
+      // exercise
+      size_t numRemoved = l.remove(*l.begin());
+      size_t numRemovedString = lString.remove(*lString.begin());
+      // verify
+      assertUnit(numRemoved == 3);
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(values(l) == std::vector<int>({ 26, 31 }));
+      assertUnit(linked(l));
+      assertUnit(numRemovedString == 3);
+      assertUnit(lString.size() == 1);
+      assertUnit(lString.front() == "b");
+   }  // teardown
+
+   // reverse swaps the links in place
+   void test_reverse()
+   {  // setup
+      custom::list<Spy> l;
+      setupStandardFixture(l);
+      custom::list<Spy>::Node* p11 = l.pHead;
+      Spy::reset();
+      // exercise
+      l.reverse();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(l.pTail == p11);
+      assertUnit(values(l) == std::vector<int>({ 31, 26, 11 }));
+      assertUnit(linked(l));
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   /****************************************************************
+    * Values
+    * The elements in order, read through pNext
+    ****************************************************************/
+   std::vector<int> values(const custom::list<Spy>& l)
+   {
+      std::vector<int> v;
+      for (custom::list<Spy>::Node* p = l.pHead; p; p = p->pNext)
+         v.push_back(p->data.get());
+      return v;
+   }
+
+   /****************************************************************
+    * Linked
+    * Every pPrev matches its pNext, the ends are right,
+    * and there are numElements nodes
+    ****************************************************************/
+   template <class List>
+   bool linked(const List& l)
+   {
+      size_t num = 0;
+      decltype(l.pHead) pPrev = nullptr;
+      for (auto p = l.pHead; p; p = p->pNext)
+      {
+         if (p->pPrev != pPrev)
+            return false;
+         pPrev = p;
+         num++;
+      }
+      return pPrev == l.pTail && num == l.numElements;
+   }
+
    /****************************************************************
     * Setup Standard Fixture
     *        pHead             pTail
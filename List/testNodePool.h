@@ -0,0 +1,203 @@
+/***********************************************************************
+ * Header:
+ *    TEST NODE POOL
+ * Summary:
+ *    Unit tests for slab_pool, node_pool and pool_allocator
+ * Author
+ *    Thatcher Albiston
+ *    Elroe Woldemichael
+ *    Jacob Mower
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "node_pool.h"
+#include "unitTest.h"
+
+#include <cassert>
+
+class TestNodePool : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Slab pool
+      test_slab_blockSize();
+      test_slab_firstChunk();
+      test_slab_reuseLast();
+      test_slab_chunksDouble();
+
+      // Node pool
+      test_node_sizeClasses();
+      test_node_large();
+
+      // Pool allocator
+      test_allocator_rebindShares();
+      test_allocator_defaultOwnPool();
+      test_allocator_array();
+
+      report("NodePool");
+   }
+
+   /***************************************
+    * SLAB POOL
+    ***************************************/
+
+   // blocks are rounded up to hold the free list link
+   void test_slab_blockSize()
+   {  // setup
+      // exercise
+      custom::slab_pool p1(1);
+      custom::slab_pool p12(12);
+      custom::slab_pool p24(24);
+      // verify
+      assertUnit(p1.block_size() == sizeof(void *));
+      assertUnit(p12.block_size() == 16);
+      assertUnit(p24.block_size() == 24);
+      assertUnit(p1.capacity() == 0);
+      assertUnit(p1.pChunks == nullptr);
+   }  // teardown
+
+   // the first allocation makes the first chunk, carved in order
+   void test_slab_firstChunk()
+   {  // setup
+      custom::slab_pool p(24);
+      // exercise
+      char * p1 = static_cast<char *>(p.allocate());
+      char * p2 = static_cast<char *>(p.allocate());
+      // verify
+      assertUnit(p.capacity() == custom::slab_pool::minChunkBlocks);
+      assertUnit(p.in_use() == 2);
+      assertUnit(p2 == p1 + 24);
+      assertUnit(p.pChunks != nullptr);
+      assertUnit(p.pChunks->pNext == nullptr);
+      assertUnit(p.pFree == nullptr);
+   }  // teardown
+
+   // the block freed last is the next one handed out
+   void test_slab_reuseLast()
+   {  // setup
+      custom::slab_pool p(24);
+      void * p1 = p.allocate();
+      void * p2 = p.allocate();
+      void * p3 = p.allocate();
+      p.deallocate(p1);
+      p.deallocate(p3);
+      // exercise
+      void * pA = p.allocate();
+      void * pB = p.allocate();
+      void * pC = p.allocate();
+      // verify
+      assertUnit(pA == p3);
+      assertUnit(pB == p1);
+      assertUnit(pC != p1 && pC != p2 && pC != p3);
+      assertUnit(p.in_use() == 4);
+      assertUnit(p.capacity() == custom::slab_pool::minChunkBlocks);
+   }  // teardown
+
+   // a full chunk is followed by one twice the size
+   void test_slab_chunksDouble()
+   {  // setup
+      custom::slab_pool p(8);
+      size_t num = custom::slab_pool::minChunkBlocks;
+      // exercise
+      for (size_t i = 0; i < num + 1; i++)
+         p.allocate();
+      // verify
+      assertUnit(p.capacity() == num * 3);
+      assertUnit(p.numNextChunk == num * 4);
+      assertUnit(p.pChunks->pNext != nullptr);
+      assertUnit(p.pChunks->pNext->pNext == nullptr);
+      assertUnit(p.in_use() == num + 1);
+   }  // teardown
+
+   /***************************************
+    * NODE POOL
+    ***************************************/
+
+   // sizes share a slab_pool within a class of eight bytes
+   void test_node_sizeClasses()
+   {  // setup
+      custom::node_pool pool;
+      // exercise
+      void * p20 = pool.allocate(20);
+      void * p24 = pool.allocate(24);
+      void * p25 = pool.allocate(25);
+      // verify
+      assertUnit(pool.pools[2] != nullptr);
+      assertUnit(pool.pools[3] != nullptr);
+      assertUnit(pool.pools[2]->block_size() == 24);
+      assertUnit(pool.in_use(24) == 2);
+      assertUnit(pool.in_use(25) == 1);
+      assertUnit(pool.pools[0] == nullptr);
+      pool.deallocate(p20, 20);
+      pool.deallocate(p24, 24);
+      pool.deallocate(p25, 25);
+      assertUnit(pool.in_use(24) == 0);
+   }  // teardown
+
+   // big objects skip the slabs
+   void test_node_large()
+   {  // setup
+      custom::node_pool pool;
+      // exercise
+      void * p = pool.allocate(1000);
+      // verify
+      assertUnit(p != nullptr);
+      assertUnit(pool.in_use(1000) == 0);
+      for (size_t i = 0; i < custom::node_pool::numClasses; i++)
+         assertUnit(pool.pools[i] == nullptr);
+      // teardown
+      pool.deallocate(p, 1000);
+   }
+
+   /***************************************
+    * POOL ALLOCATOR
+    ***************************************/
+
+   // a rebound copy draws from the same pool
+   void test_allocator_rebindShares()
+   {  // setup
+      custom::pool_allocator<int> aInt;
+      // exercise
+      custom::pool_allocator<double> aDouble(aInt);
+      double * p = aDouble.allocate(1);
+      // verify
+      assertUnit(aInt == aDouble);
+      assertUnit(aInt.pool() == aDouble.pool());
+      assertUnit(aInt.pool()->in_use(sizeof(double)) == 1);
+      // teardown
+      aDouble.deallocate(p, 1);
+   }
+
+   // allocators made on their own do not share
+   void test_allocator_defaultOwnPool()
+   {  // setup
+      // exercise
+      custom::pool_allocator<int> a1;
+      custom::pool_allocator<int> a2;
+      // verify
+      assertUnit(a1 != a2);
+      assertUnit(a1.pool() != a2.pool());
+   }  // teardown
+
+   // arrays come from operator new, not the pool
+   void test_allocator_array()
+   {  // setup
+      custom::pool_allocator<int> a;
+      // exercise
+      int * p = a.allocate(10);
+      // verify
+      assertUnit(p != nullptr);
+      assertUnit(a.pool()->in_use(sizeof(int)) == 0);
+      assertUnit(a.pool()->pools[0] == nullptr);
+      // teardown
+      a.deallocate(p, 10);
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,429 @@
+/***********************************************************************
+ * Header:
+ *    TEST UNROLLED LIST
+ * Summary:
+ *    Unit tests for unrolled_list. Most use four elements to a node
+ *    so that splits and merges happen after a handful of inserts.
+ * Author
+ *    Thatcher Albiston
+ *    Elroe Woldemichael
+ *    Jacob Mower
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "unrolled_list.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cstdlib>
+#include <list>
+#include <vector>
+#include <cassert>
+
+class TestUnrolledList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_initializer();
+      test_construct_copy();
+      test_assign_move();
+
+      // Insert
+      test_pushback_fillsNodes();
+      test_pushfront_fillsNodes();
+      test_insert_split();
+      test_insert_intoPrevious();
+      test_pushback_iteratorsStable();
+
+      // Remove
+      test_erase_merge();
+      test_erase_borrow();
+      test_erase_lastOfNode();
+      test_pop_ends();
+      test_clear_destroysAll();
+
+      // Walk
+      test_iterator_backward();
+      test_insertErase_random();
+
+      report("UnrolledList");
+   }
+
+   typedef custom::unrolled_list<int, 4> List4;
+   typedef custom::unrolled_list<Spy, 4> SpyList4;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty list has no nodes
+   void test_construct_default()
+   {  // setup
+      // exercise
+      List4 l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.size() == 0);
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.begin() == l.end());
+      assertUnit(l.rbegin() == l.end());
+   }  // teardown
+
+   // the default node fits in four cache lines
+   void test_construct_initializer()
+   {  // setup
+      // exercise
+      custom::unrolled_list<int> l{ 11, 26, 31 };
+      // verify
+      assertUnit(values(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(nodes(l) == std::vector<size_t>({ 3 }));
+      assertUnit(sizeof(*l.pHead) <= 256);
+      assertUnit(custom::unrolledNodeCells(sizeof(int)) > 32);
+      assertUnit(custom::unrolledNodeCells(1000) == 4);
+   }  // teardown
+
+   // a copy packs its nodes full and owns its own elements
+   void test_construct_copy()
+   {  // setup
+      SpyList4 lSrc;
+      for (int i = 0; i < 6; i++)
+         lSrc.push_front(Spy(i));
+      lSrc.erase(++lSrc.begin());
+      Spy::reset();
+      // exercise
+      SpyList4 lDes(lSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 5);
+      assertUnit(Spy::numAlloc() == 5);
+      assertUnit(nodes(lDes) == std::vector<size_t>({ 4, 1 }));
+      assertUnit(values(lDes) == values(lSrc));
+      assertUnit(&lDes.front() != &lSrc.front());
+      assertUnit(linked(lDes));
+   }  // teardown
+
+   // moving takes the nodes, touching no element
+   void test_assign_move()
+   {  // setup
+      SpyList4 lSrc{ Spy(11), Spy(26), Spy(31) };
+      SpyList4 lDes{ Spy(99) };
+      Spy * pFront = &lSrc.front();
+      Spy::reset();
+      // exercise
+      lDes = std::move(lSrc);
+      // verify
+      assertUnit(Spy::numDestructor() == 1);  // the old [99]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(lSrc.empty());
+      assertUnit(lSrc.pHead == nullptr);
+      assertUnit(&lDes.front() == pFront);
+      assertUnit(values(lDes) == std::vector<int>({ 11, 26, 31 }));
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_back fills each node before starting the next
+   void test_pushback_fillsNodes()
+   {  // setup
+      List4 l;
+      // exercise
+      for (int i = 0; i < 9; i++)
+         l.push_back(i);
+      // verify
+      assertUnit(l.size() == 9);
+      assertUnit(nodes(l) == std::vector<size_t>({ 4, 4, 1 }));
+      assertUnit(values(l) == std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8 }));
+      assertUnit(l.back() == 8);
+      assertUnit(linked(l));
+   }  // teardown
+
+   // push_front fills the first node, then starts a new one in front
+   void test_pushfront_fillsNodes()
+   {  // setup
+      List4 l;
+      // exercise
+      for (int i = 0; i < 6; i++)
+         l.push_front(i);
+      // verify
+      assertUnit(nodes(l) == std::vector<size_t>({ 2, 4 }));
+      assertUnit(values(l) == std::vector<int>({ 5, 4, 3, 2, 1, 0 }));
+      assertUnit(l.front() == 5);
+      assertUnit(linked(l));
+   }  // teardown
+
+   // a full node gives its back half to a new node
+   //    [11 26 31 42]  -->  [11 26] [31 99 42]
+   void test_insert_split()
+   {  // setup
+      SpyList4 l{ Spy(11), Spy(26), Spy(31), Spy(42) };
+      auto it = l.begin();
+      ++it; ++it; ++it;
+      Spy::reset();
+      // exercise
+      it = l.insert(it, Spy(99));
+      // verify
+      assertUnit(it->get() == 99);
+      assertUnit(it.p == l.pTail);
+      assertUnit(it.i == 1);
+      assertUnit(nodes(l) == std::vector<size_t>({ 2, 3 }));
+      assertUnit(values(l) == std::vector<int>({ 11, 26, 31, 99, 42 }));
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(linked(l));
+   }  // teardown
+
+   // in front of a node's first element, it goes at the back of the
+   // node before without moving anything
+   //    [11 26] [31 42 57]  -->  [11 26 99] [31 42 57]
+   void test_insert_intoPrevious()
+   {  // setup
+      List4 l{ 11, 26, 31, 57 };
+      l.insert(l.rbegin(), 42);
+      assertUnit(nodes(l) == std::vector<size_t>({ 2, 3 }));
+      auto it31 = l.begin();
+      ++it31; ++it31;
+      int * p31 = &*it31;
+      // exercise
+      auto it = l.insert(it31, 99);
+      // verify
+      assertUnit(*it == 99);
+      assertUnit(it.p == l.pHead);
+      assertUnit(nodes(l) == std::vector<size_t>({ 3, 3 }));
+      assertUnit(values(l) == std::vector<int>({ 11, 26, 99, 31, 42, 57 }));
+      assertUnit(&*it31 == p31);
+      assertUnit(*it31 == 31);
+      assertUnit(linked(l));
+   }  // teardown
+
+   // nothing already in the list moves when more go on the back
+   void test_pushback_iteratorsStable()
+   {  // setup
+      List4 l;
+      std::vector<int *> addresses;
+      for (int i = 0; i < 10; i++)
+      {
+         l.push_back(i);
+         addresses.push_back(&l.back());
+      }
+      // exercise
+      for (int i = 10; i < 100; i++)
+         l.push_back(i);
+      // verify
+      int i = 0;
+      for (auto it = l.begin(); i < 10; ++it, ++i)
+         assertUnit(&*it == addresses[i]);
+      assertUnit(l.size() == 100);
+      assertUnit(linked(l));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // a node under half full takes in the next one when both fit
+   //    [11 26] [31 42]  -->  [26 31 42]
+   void test_erase_merge()
+   {  // setup
+      SpyList4 l{ Spy(11), Spy(26), Spy(31), Spy(42) };
+      l.erase(l.insert(l.rbegin(), Spy(99)));
+      assertUnit(nodes(l) == std::vector<size_t>({ 2, 2 }));
+      Spy::reset();
+      // exercise
+      auto it = l.erase(l.begin());
+      // verify
+      assertUnit(it->get() == 26);
+      assertUnit(Spy::numDestructor() == 4);  // the erased and three moved from
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(nodes(l) == std::vector<size_t>({ 3 }));
+      assertUnit(values(l) == std::vector<int>({ 26, 31, 42 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   // when both do not fit, the two nodes share evenly
+   //    [11 26] [31 42 57 68]  -->  [26 31] [42 57 68]
+   void test_erase_borrow()
+   {  // setup
+      List4 l{ 11, 26, 31, 57 };
+      l.insert(l.rbegin(), 42);
+      l.push_back(68);
+      assertUnit(nodes(l) == std::vector<size_t>({ 2, 4 }));
+      // exercise
+      auto it = l.erase(l.begin());
+      // verify
+      assertUnit(*it == 26);
+      assertUnit(it.p == l.pHead);
+      assertUnit(nodes(l) == std::vector<size_t>({ 2, 3 }));
+      assertUnit(values(l) == std::vector<int>({ 26, 31, 42, 57, 68 }));
+      assertUnit(linked(l));
+   }  // teardown
+
+   // the last element of a node takes the node with it
+   void test_erase_lastOfNode()
+   {  // setup
+      List4 l{ 11, 26, 31, 42, 57 };
+      // exercise
+      auto it = l.erase(l.rbegin());
+      // verify
+      assertUnit(it == l.end());
+      assertUnit(nodes(l) == std::vector<size_t>({ 4 }));
+      assertUnit(l.pHead == l.pTail);
+      assertUnit(l.back() == 42);
+      assertUnit(linked(l));
+   }  // teardown
+
+   // taking from both ends down to nothing leaves no nodes
+   void test_pop_ends()
+   {  // setup
+      List4 l{ 11, 26, 31, 42, 57, 68 };
+      // exercise
+      l.pop_back();
+      l.pop_back();
+      l.pop_back();
+      l.pop_front();
+      // verify
+      assertUnit(values(l) == std::vector<int>({ 26, 31 }));
+      assertUnit(l.front() == 26);
+      assertUnit(l.back() == 31);
+      assertUnit(linked(l));
+      l.pop_front();
+      l.pop_front();
+      l.pop_front();
+      assertUnit(l.empty());
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+   }  // teardown
+
+   // clear destroys each element once and gives back every node
+   void test_clear_destroysAll()
+   {  // setup
+      SpyList4 l;
+      for (int i = 0; i < 10; i++)
+         l.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 10);
+      assertUnit(Spy::numDelete() == 10);
+      assertUnit(l.empty());
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   /***************************************
+    * WALK
+    ***************************************/
+
+   // rbegin back to the front crosses every node
+   void test_iterator_backward()
+   {  // setup
+      List4 l;
+      for (int i = 0; i < 10; i++)
+         l.push_back(i);
+      // exercise
+      std::vector<int> v;
+      for (auto it = l.rbegin(); it != l.end(); --it)
+         v.push_back(*it);
+      // verify
+      assertUnit(v == std::vector<int>({ 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 }));
+   }  // teardown
+
+   // a long random run of edits matches std::list
+   void test_insertErase_random()
+   {  // setup
+      SpyList4 l;
+      std::list<int> lCheck;
+      srand(25);
+      Spy::reset();
+      // exercise
+      for (int round = 0; round < 4000; round++)
+      {
+         int pos = lCheck.empty() ? 0 : rand() % (int)(lCheck.size() + 1);
+         auto it = l.begin();
+         auto itCheck = lCheck.begin();
+         for (int i = 0; i < pos; i++, ++it, ++itCheck)
+            ;
+         if (round % 1000 < 600 || itCheck == lCheck.end())
+         {
+            it = l.insert(it, Spy(round));
+            itCheck = lCheck.insert(itCheck, round);
+         }
+         else
+         {
+            it = l.erase(it);
+            itCheck = lCheck.erase(itCheck);
+         }
+         // verify
+         assertUnit((it == l.end()) == (itCheck == lCheck.end()));
+         if (itCheck != lCheck.end())
+            assertUnit(it->get() == *itCheck);
+      }
+      assertUnit(l.size() == lCheck.size());
+      assertUnit(values(l) == std::vector<int>(lCheck.begin(), lCheck.end()));
+      assertUnit(linked(l));
+      // teardown
+      l.clear();
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }
+
+   /****************************************************************
+    * VALUES
+    * The elements, in order
+    ****************************************************************/
+   template <class List>
+   std::vector<int> values(List& l)
+   {
+      std::vector<int> v;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         v.push_back(valueOf(*it));
+      return v;
+   }
+   static int valueOf(int i)         { return i;       }
+   static int valueOf(const Spy & s) { return s.get(); }
+
+   /****************************************************************
+    * NODES
+    * How many elements each node holds, front to back
+    ****************************************************************/
+   template <class List>
+   std::vector<size_t> nodes(const List& l)
+   {
+      std::vector<size_t> v;
+      for (auto p = l.pHead; p; p = p->pNext)
+         v.push_back(p->num);
+      return v;
+   }
+
+   /****************************************************************
+    * Linked
+    * Every pPrev matches its pNext, the ends are right, no node is
+    * empty, and the counts add up to numElements
+    ****************************************************************/
+   template <class List>
+   bool linked(const List& l)
+   {
+      size_t num = 0;
+      decltype(l.pHead) pPrev = nullptr;
+      for (auto p = l.pHead; p; p = p->pNext)
+      {
+         if (p->pPrev != pPrev || p->num == 0)
+            return false;
+         pPrev = p;
+         num += p->num;
+      }
+      return pPrev == l.pTail && num == l.numElements;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,660 @@
+/***********************************************************************
+ * Header:
+ *    UNROLLED LIST
+ * Summary:
+ *    A doubly linked list whose nodes each hold a small array of up to
+ *    K elements instead of one. Walking it takes one pointer hop per
+ *    node rather than per element, and the two links and the count are
+ *    paid once per node, so a list of small elements is faster to walk
+ *    and takes less memory than list. A full node splits in half when
+ *    something goes into it, and a node left under half full by an
+ *    erase takes elements from the node after it, or merges with it.
+ *
+ *    Elements move within their node when their neighbours come and go,
+ *    so an insert or erase invalidates iterators into the nodes it
+ *    touches, unlike list. Iterators into every other node stay good:
+ *        push_back, insert at end() : none are invalidated
+ *        pop_back                   : only the element taken out
+ *        push_front                 : those into the first node
+ *        pop_front                  : those into the first node, and
+ *                                     into the node after it
+ *        insert                     : those into the node it goes in,
+ *                                     and into the new one on a split
+ *        erase                      : those into the node it comes out
+ *                                     of, and into the node after it
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        unrolled_list          : A list of nodes of up to K elements
+ *        unrolled_list iterator : An iterator through unrolled_list
+ * Author
+ *    Thatcher Albiston
+ *    Elroe Woldemichael
+ *    Jacob Mower
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for ASSERT
+#include <cstddef>     // for std::ptrdiff_t
+#include <initializer_list> // for std::initializer_list
+#include <iterator>    // for std::bidirectional_iterator_tag
+#include <memory>      // for std::allocator
+#include <utility>     // for std::forward
+
+class TestUnrolledList; // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * UNROLLED NODE CELLS
+ * How many elements fit in a node of about four cache
+ * lines after its two links and count, but never
+ * fewer than four
+ **************************************************/
+constexpr size_t unrolledNodeCells(size_t size)
+{
+   return (256 - 3 * sizeof(void *)) / size < 4 ? 4 :
+          (256 - 3 * sizeof(void *)) / size;
+}
+
+/**************************************************
+ * UNROLLED LIST
+ * Like list, with up to K elements to a node
+ **************************************************/
+template <typename T, size_t K = unrolledNodeCells(sizeof(T)),
+          typename A = std::allocator<T>>
+class unrolled_list
+{
+   friend class ::TestUnrolledList; // give unit tests access to the privates
+   static_assert(K >= 2, "a node must hold at least two elements to split");
+public:
+
+   //
+   // Construct
+   //
+
+   unrolled_list(const A & a = A()) :
+      pHead(nullptr), pTail(nullptr), numElements(0), alloc(a) { }
+   unrolled_list(const unrolled_list & rhs) :
+      pHead(nullptr), pTail(nullptr), numElements(0), alloc(rhs.alloc)
+   {
+      for (Node * p = rhs.pHead; p; p = p->pNext)
+         for (size_t i = 0; i < p->num; i++)
+            push_back(p->data()[i]);
+   }
+   unrolled_list(unrolled_list && rhs) :
+      pHead(nullptr), pTail(nullptr), numElements(0), alloc(rhs.alloc)
+   {
+      swap(rhs);
+   }
+   unrolled_list(const std::initializer_list<T> & il, const A & a = A()) :
+      pHead(nullptr), pTail(nullptr), numElements(0), alloc(a)
+   {
+      for (const T & t : il)
+         push_back(t);
+   }
+  ~unrolled_list()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+
+   unrolled_list & operator = (const unrolled_list & rhs)
+   {
+      if (this != &rhs)
+      {
+         unrolled_list copy(rhs);
+         swap(copy);
+      }
+      return *this;
+   }
+   unrolled_list & operator = (unrolled_list && rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(unrolled_list & rhs)
+   {
+      std::swap(pHead, rhs.pHead);
+      std::swap(pTail, rhs.pTail);
+      std::swap(numElements, rhs.numElements);
+      std::swap(alloc, rhs.alloc);
+   }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin()  { return iterator(pHead, 0);                          }
+   iterator rbegin() { return pTail ? iterator(pTail, pTail->num - 1) : end(); }
+   iterator end()    { return iterator(nullptr, 0);                        }
+
+   //
+   // Access
+   //
+
+   T & front();
+   T & back();
+
+   //
+   // Insert
+   //
+
+   void push_front(const T &  t) { emplace(begin(), t);            }
+   void push_front(      T && t) { emplace(begin(), std::move(t)); }
+   void push_back (const T &  t) { emplace(end(),   t);            }
+   void push_back (      T && t) { emplace(end(),   std::move(t)); }
+   iterator insert(iterator it, const T &  t) { return emplace(it, t);            }
+   iterator insert(iterator it,       T && t) { return emplace(it, std::move(t)); }
+   template <class ... Args>
+   iterator emplace(iterator it, Args && ... args);
+
+   //
+   // Remove
+   //
+
+   void pop_front() { if (pHead) erase(begin());  }
+   void pop_back()  { if (pTail) erase(rbegin()); }
+   void clear();
+   iterator erase(const iterator & it);
+
+   //
+   // Status
+   //
+
+   bool empty()  const { return numElements == 0; }
+   size_t size() const { return numElements;      }
+
+private:
+   // nested node class
+   class Node;
+
+   // the allocator, rebound from elements to nodes
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+
+   // an empty node, not yet linked in
+   Node * newNode();
+
+   // give back a node whose elements are already gone
+   void deleteNode(Node * p);
+
+   // link pNew in after pPos, or at the front when pPos is nullptr
+   void linkAfter(Node * pPos, Node * pNew);
+
+   // take p out of the chain of nodes
+   void unlinkNode(Node * p);
+
+   // move n elements from pSrc starting at iSrc into the unused
+   // cells of pDest starting at iDest. The counts are the caller's.
+   void moveCells(Node * pDest, size_t iDest, Node * pSrc, size_t iSrc, size_t n);
+
+   // open a gap at cell i of a node that is not full
+   void openGap(Node * p, size_t i);
+
+   // close the gap left at cell i by an element already destroyed
+   void closeGap(Node * p, size_t i);
+
+   // fill a node left under half full from the one after it
+   void rebalance(Node * p);
+
+   // member variables
+   Node * pHead;       // the first node
+   Node * pTail;       // the last node
+   size_t numElements; // elements over all the nodes
+   NodeAlloc alloc;    // where the nodes come from
+};
+
+/*************************************************
+ * UNROLLED LIST NODE
+ * Two links, a count, and raw room for K elements.
+ * Cells 0 through num - 1 hold elements; the rest
+ * are unconstructed.
+ *************************************************/
+template <typename T, size_t K, typename A>
+class unrolled_list <T, K, A> :: Node
+{
+public:
+   Node() : pNext(nullptr), pPrev(nullptr), num(0) { }
+
+   T * data() { return reinterpret_cast<T *>(cells); }
+
+   Node * pNext;
+   Node * pPrev;
+   size_t num;
+   alignas(T) unsigned char cells[K * sizeof(T)];
+};
+
+/*************************************************
+ * UNROLLED LIST ITERATOR
+ * A node and a cell within it. end() is no node.
+ ************************************************/
+template <typename T, size_t K, typename A>
+class unrolled_list <T, K, A> :: iterator
+{
+   friend class ::TestUnrolledList; // give unit tests access to the privates
+   template <typename TT, size_t KK, typename AA>
+   friend class custom::unrolled_list;
+public:
+   typedef std::bidirectional_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
+   // constructors, destructors, and assignment operator
+   iterator()                        : p(nullptr), i(0)    { }
+   iterator(Node * pRHS, size_t iRHS) : p(pRHS), i(iRHS)   { }
+   iterator(const iterator & rhs)    : p(rhs.p), i(rhs.i)  { }
+
+   iterator & operator = (const iterator & rhs)
+   {
+      this->p = rhs.p;
+      this->i = rhs.i;
+      return *this;
+   }
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return p == rhs.p && i == rhs.i; }
+   bool operator != (const iterator & rhs) const { return !(*this == rhs);          }
+
+   // dereference operator, fetch the element
+   T & operator * ()  { return p->data()[i];  }
+   T * operator -> () { return p->data() + i; }
+
+   // postfix increment
+   iterator operator ++ (int postfix)
+   {
+      iterator it = *this;
+      ++*this;
+      return it;
+   }
+
+   // prefix increment: the next cell, or the next node once this one runs out
+   iterator & operator ++ ()
+   {
+      if (++i == p->num)
+      {
+         p = p->pNext;
+         i = 0;
+      }
+      return *this;
+   }
+
+   // postfix decrement
+   iterator operator -- (int postfix)
+   {
+      iterator it = *this;
+      --*this;
+      return it;
+   }
+
+   // prefix decrement: the cell before, or the last of the node before
+   iterator & operator -- ()
+   {
+      if (i == 0)
+      {
+         p = p->pPrev;
+         i = p ? p->num - 1 : 0;
+      }
+      else
+         i--;
+      return *this;
+   }
+
+private:
+   Node * p;
+   size_t i;
+};
+
+/*********************************************
+ * UNROLLED LIST :: FRONT
+ * the first element in the list
+ *     INPUT  :
+ *     OUTPUT : the element
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, size_t K, typename A>
+T & unrolled_list <T, K, A> :: front()
+{
+   if (pHead)
+      return pHead->data()[0];
+   throw "ERROR: unable to access data from an empty list";
+}
+
+/*********************************************
+ * UNROLLED LIST :: BACK
+ * the last element in the list
+ *     INPUT  :
+ *     OUTPUT : the element
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, size_t K, typename A>
+T & unrolled_list <T, K, A> :: back()
+{
+   if (pTail)
+      return pTail->data()[pTail->num - 1];
+   throw "ERROR: unable to access data from an empty list";
+}
+
+/******************************************
+ * UNROLLED LIST :: EMPLACE
+ * build an element in before it. At end() it goes
+ * in the last node's first unused cell, or a new
+ * node when that is full, so nothing moves. Going
+ * in before the first element of a node, it takes
+ * the back of the node before when there is room,
+ * and a new node when there is none and its own
+ * node is full. Otherwise the elements after it in
+ * its node move up one, and a full node first
+ * splits in half.
+ *     INPUT  : it   where it goes; end() for the back
+ *              args for the element's constructor
+ *     OUTPUT : iterator to the new element
+ *     COST   : O(K)
+ ******************************************/
+template <typename T, size_t K, typename A>
+template <class ... Args>
+typename unrolled_list <T, K, A> :: iterator
+unrolled_list <T, K, A> :: emplace(iterator it, Args && ... args)
+{
+   Node * p = it.p;
+   size_t i = it.i;
+
+   // at the back, or the back of the node before
+   if (p == nullptr ||
+       (i == 0 && ((p->pPrev && p->pPrev->num < K) || p->num == K)))
+   {
+      Node * pBack = p ? p->pPrev : pTail;
+      if (pBack == nullptr || pBack->num == K)
+      {
+         Node * pNew = newNode();
+         linkAfter(pBack, pNew);
+         pBack = pNew;
+      }
+      try
+      {
+         std::allocator_traits<NodeAlloc>::construct(alloc, pBack->data() + pBack->num,
+                                                     std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+         if (pBack->num == 0)
+         {
+            unlinkNode(pBack);
+            deleteNode(pBack);
+         }
+         throw;
+      }
+      numElements++;
+      return iterator(pBack, pBack->num++);
+   }
+
+   // args may be an element of this list, so build it before anything moves
+   T t(std::forward<Args>(args)...);
+
+   // a full node gives its back half to a new node after it
+   if (p->num == K)
+   {
+      Node * pNew = newNode();
+      linkAfter(p, pNew);
+      moveCells(pNew, 0, p, K / 2, K - K / 2);
+      pNew->num = K - K / 2;
+      p->num = K / 2;
+      if (i > K / 2)
+      {
+         p = pNew;
+         i -= K / 2;
+      }
+   }
+
+   openGap(p, i);
+   std::allocator_traits<NodeAlloc>::construct(alloc, p->data() + i, std::move(t));
+   p->num++;
+   numElements++;
+   return iterator(p, i);
+}
+
+/******************************************
+ * UNROLLED LIST :: ERASE
+ * take an element out and close the gap. A node
+ * left empty goes away; one left under half full
+ * is topped up from the node after it.
+ *     INPUT  : it  the element to take out
+ *     OUTPUT : iterator to the one after it
+ *     COST   : O(K)
+ ******************************************/
+template <typename T, size_t K, typename A>
+typename unrolled_list <T, K, A> :: iterator
+unrolled_list <T, K, A> :: erase(const iterator & it)
+{
+   Node * p = it.p;
+   size_t i = it.i;
+   if (!p)
+      return end();
+
+   std::allocator_traits<NodeAlloc>::destroy(alloc, p->data() + i);
+   closeGap(p, i);
+   p->num--;
+   numElements--;
+
+   if (p->num == 0)
+   {
+      Node * pNext = p->pNext;
+      unlinkNode(p);
+      deleteNode(p);
+      return iterator(pNext, 0);
+   }
+
+   if (p->num < K / 2)
+      rebalance(p);
+
+   // the one after it is still in cell i, unless that was the end of the node
+   return i < p->num ? iterator(p, i) : iterator(p->pNext, 0);
+}
+
+/**********************************************
+ * UNROLLED LIST :: CLEAR
+ * destroy every element and give back every node
+ *     INPUT  :
+ *     OUTPUT :
+ *     COST   : O(n) with respect to the number of elements
+ *********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: clear()
+{
+   Node * p = pHead;
+   while (p)
+   {
+      Node * pNext = p->pNext;
+      for (size_t i = 0; i < p->num; i++)
+         std::allocator_traits<NodeAlloc>::destroy(alloc, p->data() + i);
+      deleteNode(p);
+      p = pNext;
+   }
+   pHead = nullptr;
+   pTail = nullptr;
+   numElements = 0;
+}
+
+/*********************************************
+ * UNROLLED LIST :: NEW NODE
+ * an empty node from the allocator
+ *     INPUT  :
+ *     OUTPUT : the node, not yet linked in
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, size_t K, typename A>
+typename unrolled_list <T, K, A> :: Node * unrolled_list <T, K, A> :: newNode()
+{
+   Node * p = std::allocator_traits<NodeAlloc>::allocate(alloc, 1);
+   std::allocator_traits<NodeAlloc>::construct(alloc, p);
+   return p;
+}
+
+/*********************************************
+ * UNROLLED LIST :: DELETE NODE
+ * give a node back. Its elements must already
+ * have been destroyed or moved out.
+ *     INPUT  : p  the node
+ *     OUTPUT :
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: deleteNode(Node * p)
+{
+   std::allocator_traits<NodeAlloc>::destroy(alloc, p);
+   std::allocator_traits<NodeAlloc>::deallocate(alloc, p, 1);
+}
+
+/*********************************************
+ * UNROLLED LIST :: LINK AFTER
+ * put a node into the chain
+ *     INPUT  : pPos  the node it follows; nullptr for the front
+ *              pNew  the node
+ *     OUTPUT :
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: linkAfter(Node * pPos, Node * pNew)
+{
+   Node * pNext = pPos ? pPos->pNext : pHead;
+   pNew->pPrev = pPos;
+   pNew->pNext = pNext;
+
+   if (pPos)
+      pPos->pNext = pNew;
+   else
+      pHead = pNew;
+
+   if (pNext)
+      pNext->pPrev = pNew;
+   else
+      pTail = pNew;
+}
+
+/*********************************************
+ * UNROLLED LIST :: UNLINK NODE
+ * take a node out of the chain
+ *     INPUT  : p  the node
+ *     OUTPUT :
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: unlinkNode(Node * p)
+{
+   if (p->pPrev)
+      p->pPrev->pNext = p->pNext;
+   else
+      pHead = p->pNext;
+
+   if (p->pNext)
+      p->pNext->pPrev = p->pPrev;
+   else
+      pTail = p->pPrev;
+}
+
+/*********************************************
+ * UNROLLED LIST :: MOVE CELLS
+ * move elements from one node into the unused
+ * cells of another, destroying what is left behind
+ *     INPUT  : pDest, iDest  where they go
+ *              pSrc,  iSrc   where they come from
+ *              n             how many
+ *     OUTPUT :
+ *     COST   : O(n)
+ *********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: moveCells(Node * pDest, size_t iDest,
+                                           Node * pSrc, size_t iSrc, size_t n)
+{
+   for (size_t j = 0; j < n; j++)
+   {
+      T * pFrom = pSrc->data() + iSrc + j;
+      std::allocator_traits<NodeAlloc>::construct(alloc, pDest->data() + iDest + j,
+                                                  std::move(*pFrom));
+      std::allocator_traits<NodeAlloc>::destroy(alloc, pFrom);
+   }
+}
+
+/*********************************************
+ * UNROLLED LIST :: OPEN GAP
+ * move cells i through num - 1 up one, leaving
+ * cell i unconstructed. num is the caller's to fix.
+ *     INPUT  : p  a node with room
+ *              i  the cell to open
+ *     OUTPUT :
+ *     COST   : O(K)
+ *********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: openGap(Node * p, size_t i)
+{
+   assert(p->num < K);
+   for (size_t j = p->num; j > i; j--)
+      moveCells(p, j, p, j - 1, 1);
+}
+
+/*********************************************
+ * UNROLLED LIST :: CLOSE GAP
+ * move cells i + 1 through num - 1 down one into
+ * the unconstructed cell i. num is the caller's to fix.
+ *     INPUT  : p  the node
+ *              i  the empty cell
+ *     OUTPUT :
+ *     COST   : O(K)
+ *********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: closeGap(Node * p, size_t i)
+{
+   for (size_t j = i + 1; j < p->num; j++)
+      moveCells(p, j - 1, p, j, 1);
+}
+
+/*********************************************
+ * UNROLLED LIST :: REBALANCE
+ * top up a node that has fallen under half full
+ * from the node after it. When both fit in one
+ * the next node is emptied into this one and goes
+ * away; otherwise they split what they hold evenly.
+ * The last node has nothing to draw from, and is
+ * left as it is.
+ *     INPUT  : p  the node under half full
+ *     OUTPUT :
+ *     COST   : O(K)
+ *********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: rebalance(Node * p)
+{
+   Node * pNext = p->pNext;
+   if (!pNext)
+      return;
+
+   size_t total = p->num + pNext->num;
+   size_t numTake = total <= K ? pNext->num : total / 2 - p->num;
+
+   moveCells(p, p->num, pNext, 0, numTake);
+   p->num += numTake;
+
+   if (numTake == pNext->num)
+   {
+      unlinkNode(pNext);
+      deleteNode(pNext);
+   }
+   else
+   {
+      moveCells(pNext, 0, pNext, numTake, pNext->num - numTake);
+      pNext->num -= numTake;
+   }
+}
+
+}; // namespace custom
@@ -13,6 +13,8 @@
  *    This will contain the class definition of:
  *        vector                 : A class that represents a Vector
  *        vector::iterator       : An iterator through Vector
+ *        vector::const_iterator : A read-only iterator through Vector
+ *        is_trivially_relocatable : Can a T be moved with memmove?
  * Author
  *    Jacob Mower
  *    Elroe Woldemichael
@@ -24,6 +26,9 @@
 #include <cassert>  // because I am paranoid
 #include <new>      // std::bad_alloc
 #include <memory>   // for std::allocator
+#include <iterator> // for std::random_access_iterator_tag
+#include <cstring>  // for std::memmove
+#include <type_traits> // for std::is_trivially_copyable
 
 class TestVector; // forward declaration for unit tests
 class TestStack;
@@ -33,6 +38,16 @@ class TestHash;
 namespace custom
 {
 
+   /*****************************************
+    * IS TRIVIALLY RELOCATABLE
+    * Moving one of these to a new address and forgetting
+    * the old one is the same as copying the bytes. Every
+    * trivially copyable type qualifies. Other types can opt
+    * in by specializing this in namespace custom.
+    ****************************************/
+   template <typename T>
+   struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
    /*****************************************
     * VECTOR
     * Just like the std :: vector <T> class
@@ -73,14 +88,19 @@ namespace custom
       // Iterator
       //
       class iterator;
-      iterator begin()
-      {
+      class const_iterator;
+      iterator begin() 
+      { 
          return iterator(data);
       }
-      iterator end()
-      {
+      iterator end() 
+      { 
          return iterator(data + numElements);
       }
+      const_iterator begin()  const { return const_iterator(data);               }
+      const_iterator end()    const { return const_iterator(data + numElements); }
+      const_iterator cbegin() const { return const_iterator(data);               }
+      const_iterator cend()   const { return const_iterator(data + numElements); }
 
       //
       // Access
@@ -132,6 +152,9 @@ namespace custom
 
    private:
 
+      // move num elements from pSource to raw memory at pDest
+      void relocate(T* pDest, T* pSource, size_t num);
+
       A    alloc;                // use allocator for memory allocation
       T* data;                 // user data, a dynamically-allocated array
       size_t  numCapacity;       // the capacity of the array
@@ -140,14 +163,10 @@ namespace custom
 
    /**************************************************
     * VECTOR ITERATOR
-    * An iterator through vector.  You only need to
-    * support the following:
-    *   1. Constructors (default and copy)
-    *   2. Not equals operator
-    *   3. Increment (prefix and postfix)
-    *   4. Dereference
-    * This particular iterator is a bi-directional meaning
-    * that ++ and -- both work.  Not all iterators are that way.
+    * An iterator through vector. The elements are
+    * contiguous, so this is a random-access iterator
+    * and the standard algorithms (sort, lower_bound,
+    * distance, ...) can jump around in constant time.
     *************************************************/
    template <typename T, typename A>
    class vector <T, A> ::iterator
@@ -156,11 +175,20 @@ namespace custom
       friend class ::TestStack;
       friend class ::TestPQueue;
       friend class ::TestHash;
+      friend class vector <T, A>;
+      friend class vector <T, A> ::const_iterator;
    public:
+      // iterator traits so the standard algorithms know what we are
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef T                               value_type;
+      typedef std::ptrdiff_t                  difference_type;
+      typedef T *                             pointer;
+      typedef T &                             reference;
+
       // constructors, destructors, and assignment operator
-      iterator() : p(nullptr) {  }
-      iterator(T* p) : p(p) {  }
-      iterator(const iterator& rhs) : p(rhs.p) {  }
+      iterator()                           : p(nullptr)        {  }
+      iterator(T* p)                       : p(p)              {  }
+      iterator(const iterator& rhs)        : p(rhs.p)          {  }
       iterator(size_t index, vector<T>& v) : p(v.data + index) {  }
       iterator& operator = (const iterator& rhs)
       {
@@ -168,15 +196,28 @@ namespace custom
          return *this;
       }
 
-      // equals, not equals operator
-      bool operator != (const iterator& rhs) const { return this->p != rhs.p; }
-      bool operator == (const iterator& rhs) const { return this->p == rhs.p; }
+      // equals, not equals and relative order. Mixing in a const_iterator,
+      // on either side, uses const_iterator's operators
+      friend bool operator == (const iterator& lhs, const iterator& rhs) { return lhs.p == rhs.p; }
+      friend bool operator != (const iterator& lhs, const iterator& rhs) { return lhs.p != rhs.p; }
+      friend bool operator <  (const iterator& lhs, const iterator& rhs) { return lhs.p <  rhs.p; }
+      friend bool operator >  (const iterator& lhs, const iterator& rhs) { return lhs.p >  rhs.p; }
+      friend bool operator <= (const iterator& lhs, const iterator& rhs) { return lhs.p <= rhs.p; }
+      friend bool operator >= (const iterator& lhs, const iterator& rhs) { return lhs.p >= rhs.p; }
 
       // dereference operator
-      T& operator * ()
+      T& operator * () const
       {
          return *(p);
       }
+      T* operator -> () const
+      {
+         return p;
+      }
+      T& operator [] (difference_type n) const
+      {
+         return p[n];
+      }
 
       // prefix increment
       iterator& operator ++ ()
@@ -208,10 +249,115 @@ namespace custom
          return it;
       }
 
+      // jump n elements
+      iterator& operator += (difference_type n) { this->p += n; return *this; }
+      iterator& operator -= (difference_type n) { this->p -= n; return *this; }
+      iterator  operator +  (difference_type n) const { return iterator(p + n); }
+      iterator  operator -  (difference_type n) const { return iterator(p - n); }
+      friend iterator operator + (difference_type n, const iterator& it) { return it + n; }
+
+      // distance between two iterators
+      friend difference_type operator - (const iterator& lhs, const iterator& rhs) { return lhs.p - rhs.p; }
+
    private:
       T* p;
    };
 
+   /**************************************************
+    * VECTOR CONST ITERATOR
+    * The same as iterator, but the elements can only
+    * be read. Any iterator converts to one of these.
+    *************************************************/
+   template <typename T, typename A>
+   class vector <T, A> ::const_iterator
+   {
+      friend class ::TestVector; // give unit tests access to the privates
+      friend class ::TestStack;
+      friend class ::TestPQueue;
+      friend class ::TestHash;
+      friend class vector <T, A>;
+   public:
+      // iterator traits so the standard algorithms know what we are
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef T                               value_type;
+      typedef std::ptrdiff_t                  difference_type;
+      typedef const T *                       pointer;
+      typedef const T &                       reference;
+
+      // constructors, destructors, and assignment operator
+      const_iterator()                          : p(nullptr)   {  }
+      const_iterator(const T* p)                : p(p)         {  }
+      const_iterator(const const_iterator& rhs) : p(rhs.p)     {  }
+      const_iterator(const iterator& rhs)       : p(rhs.p)     {  }
+      const_iterator& operator = (const const_iterator& rhs)
+      {
+         this->p = rhs.p;
+         return *this;
+      }
+
+      // equals, not equals and relative order. Either side may be an
+      // iterator, which converts
+      friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p == rhs.p; }
+      friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p != rhs.p; }
+      friend bool operator <  (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p <  rhs.p; }
+      friend bool operator >  (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p >  rhs.p; }
+      friend bool operator <= (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p <= rhs.p; }
+      friend bool operator >= (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p >= rhs.p; }
+
+      // dereference operator
+      const T& operator * () const
+      {
+         return *(p);
+      }
+      const T* operator -> () const
+      {
+         return p;
+      }
+      const T& operator [] (difference_type n) const
+      {
+         return p[n];
+      }
+
+      // prefix and postfix increment
+      const_iterator& operator ++ ()
+      {
+         this->p += 1;
+         return *this;
+      }
+      const_iterator operator ++ (int postfix)
+      {
+         const_iterator it = *this;
+         this->p += 1;
+         return it;
+      }
+
+      // prefix and postfix decrement
+      const_iterator& operator -- ()
+      {
+         this->p -= 1;
+         return *this;
+      }
+      const_iterator operator -- (int postfix)
+      {
+         const_iterator it = *this;
+         this->p -= 1;
+         return it;
+      }
+
+      // jump n elements
+      const_iterator& operator += (difference_type n) { this->p += n; return *this; }
+      const_iterator& operator -= (difference_type n) { this->p -= n; return *this; }
+      const_iterator  operator +  (difference_type n) const { return const_iterator(p + n); }
+      const_iterator  operator -  (difference_type n) const { return const_iterator(p - n); }
+      friend const_iterator operator + (difference_type n, const const_iterator& it) { return it + n; }
+
+      // distance between two iterators
+      friend difference_type operator - (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p - rhs.p; }
+
+   private:
+      const T* p;
+   };
+
 
    /*****************************************
     * VECTOR :: NON-DEFAULT constructors
@@ -398,17 +544,45 @@ namespace custom
 
       //Make new space as needed and move elements
       T* dataNew = alloc.allocate(newCapacity);
-      for (auto i = 0; i < numElements; i++)
-         new ((void*)(dataNew + i)) T(std::move(data[i]));
-
-      //Destroy old elements after move is complete
-      for (size_t i = 0; i < numElements; ++i)
-         alloc.destroy(data + i);
+      relocate(dataNew, data, numElements);
       alloc.deallocate(data, numCapacity);
       data = dataNew;
       numCapacity = newCapacity;
    }
 
+   /***************************************
+    * VECTOR :: RELOCATE
+    * Move num elements from pSource into the raw
+    * memory at pDest. The source slots are left
+    * destroyed. Relocatable types go over as a
+    * single block of bytes.
+    *     INPUT  : pDest   the uninitialized destination
+    *              pSource the elements to move
+    *              num     how many elements to move
+    *     OUTPUT :
+    **************************************/
+   template <typename T, typename A>
+   void vector <T, A> ::relocate(T* pDest, T* pSource, size_t num)
+   {
+      //Nothing to move
+      if (num == 0 || pDest == pSource)
+         return;
+
+      //The bytes are the object so copy them all at once
+      if (is_trivially_relocatable<T>::value)
+      {
+         std::memmove((void*)pDest, (const void*)pSource, num * sizeof(T));
+         return;
+      }
+
+      //Otherwise move each one over and destroy the original
+      for (size_t i = 0; i < num; i++)
+      {
+         new ((void*)(pDest + i)) T(std::move(pSource[i]));
+         alloc.destroy(pSource + i);
+      }
+   }
+
    /***************************************
     * VECTOR :: SHRINK TO FIT
     * Get rid of any extra capacity
@@ -427,13 +601,19 @@ namespace custom
          //Allocate new spot for smaller vector
          T* dataNew = alloc.allocate(numElements);
 
-         //Create our vector in the new spot
-         for (size_t i = 0; i < numElements; i++)
-            alloc.construct(&dataNew[i], data[i]);
+         //Relocatable elements can just be moved over in bulk
+         if (is_trivially_relocatable<T>::value)
+            relocate(dataNew, data, numElements);
+         else
+         {
+            //Create our vector in the new spot
+            for (size_t i = 0; i < numElements; i++)
+               alloc.construct(&dataNew[i], data[i]);
 
-         //Destroy the vector in the old spot
-         for (size_t i = 0; i < numElements; ++i)
-            alloc.destroy(&data[i]);
+            //Destroy the vector in the old spot
+            for (size_t i = 0; i < numElements; ++i)
+               alloc.destroy(&data[i]);
+         }
          alloc.deallocate(data, numCapacity);
 
          //Update members
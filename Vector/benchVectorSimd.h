@@ -0,0 +1,129 @@
+/***********************************************************************
+ * Header:
+ *    BENCH VECTOR SIMD
+ * Summary:
+ *    Time each vector kernel against its scalar loop. Build with
+ *    optimization and BENCHMARK defined to run it from the driver.
+ * Author:
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "vector_simd.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+
+class BenchVectorSimd
+{
+public:
+   BenchVectorSimd(size_t num = (size_t)1 << 22, int numRepeat = 50) :
+      num(num), numRepeat(numRepeat), sink(0) {}
+
+   void run()
+   {
+      custom::vector<int32_t>  vInt(num);
+      custom::vector<float>    vFloat(num);
+      custom::vector<uint64_t> vLong(num);
+      custom::vector<int32_t>  vIntCopy(num);
+      for (size_t i = 0; i < num; i++)
+      {
+         vInt[i]   = (int32_t)(i % 1000);
+         vFloat[i] = (float)(i % 1000);
+         vLong[i]  = (uint64_t)(i % 1000);
+         vIntCopy[i] = vInt[i];
+      }
+      const int32_t  * pInt   = &*vInt.cbegin();
+      const float    * pFloat = &*vFloat.cbegin();
+      const uint64_t * pLong  = &*vLong.cbegin();
+      const int32_t  * pCopy  = &*vIntCopy.cbegin();
+      using namespace custom::simd;
+
+      const char * levels[] = { "scalar", "SSE4.2", "AVX2" };
+      std::cout << "Vector kernels: " << num << " elements, "
+                << levels[level()] << " dispatch\n";
+      std::cout << std::setw(24) << std::left << "kernel"
+                << std::setw(12) << std::right << "scalar ms"
+                << std::setw(12) << "simd ms"
+                << std::setw(10) << "speedup" << std::endl;
+
+      // the value looked for is never there so the whole vector is scanned
+      report("find<int32_t>",
+             time([&] { return findScalar(pInt, num, (int32_t)-1); }),
+             time([&] { return find(pInt, num, (int32_t)-1); }));
+      report("find<float>",
+             time([&] { return findScalar(pFloat, num, -1.0f); }),
+             time([&] { return find(pFloat, num, -1.0f); }));
+      report("find<uint64_t>",
+             time([&] { return findScalar(pLong, num, (uint64_t)-1); }),
+             time([&] { return find(pLong, num, (uint64_t)-1); }));
+      report("count<int32_t>",
+             time([&] { return countScalar(pInt, num, (int32_t)7); }),
+             time([&] { return count(pInt, num, (int32_t)7); }));
+      report("count<uint64_t>",
+             time([&] { return countScalar(pLong, num, (uint64_t)7); }),
+             time([&] { return count(pLong, num, (uint64_t)7); }));
+      report("min_element<int32_t>",
+             time([&] { return minScalar(pInt, num); }),
+             time([&] { return min(pInt, num); }));
+      report("max_element<float>",
+             time([&] { return maxScalar(pFloat, num); }),
+             time([&] { return max(pFloat, num); }));
+      report("sum<int32_t>",
+             time([&] { return (size_t)sumScalar(pInt, num); }),
+             time([&] { return (size_t)sum(pInt, num); }));
+      report("sum<float>",
+             time([&] { return (size_t)sumScalar(pFloat, num); }),
+             time([&] { return (size_t)sum(pFloat, num); }));
+      report("sum<uint64_t>",
+             time([&] { return (size_t)sumScalar(pLong, num); }),
+             time([&] { return (size_t)sum(pLong, num); }));
+      report("dot<float>",
+             time([&] { return (size_t)dotScalar(pFloat, pFloat, num); }),
+             time([&] { return (size_t)dot(pFloat, pFloat, num); }));
+      report("mismatch<int32_t>",
+             time([&] { return mismatchScalar(pInt, pCopy, num); }),
+             time([&] { return mismatch(pInt, pCopy, num); }));
+   }
+
+private:
+   // milliseconds for one call, best of numRepeat
+   template <class Kernel>
+   double time(Kernel kernel)
+   {
+      double best = 1e30;
+      for (int i = 0; i < numRepeat; i++)
+      {
+         auto begin = std::chrono::steady_clock::now();
+         sink += kernel();
+         auto end = std::chrono::steady_clock::now();
+         double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+         if (ms < best)
+            best = ms;
+      }
+      return best;
+   }
+
+   void report(const char * name, double msScalar, double msSimd)
+   {
+      std::cout << std::setw(24) << std::left << name << std::right
+                << std::fixed << std::setprecision(3)
+                << std::setw(12) << msScalar
+                << std::setw(12) << msSimd
+                << std::setprecision(2)
+                << std::setw(9) << msScalar / msSimd << "x" << std::endl;
+   }
+
+   size_t num;
+   int numRepeat;
+   size_t sink;      // keeps the optimizer from dropping the kernels
+};
+
+#endif // BENCHMARK
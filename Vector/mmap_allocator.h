@@ -0,0 +1,205 @@
+/***********************************************************************
+ * Header:
+ *    MMAP ALLOCATOR
+ * Summary:
+ *    An allocator for very large buffers. Anything at or above the
+ *    threshold is mapped straight from the operating system so that
+ *    vector can grow or shrink it in place instead of copying it.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        mmap_allocator         : An allocator that maps large buffers
+ * Author
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#include <cstring>  // for std::memcpy
+#include <new>      // std::bad_alloc
+#include <utility>  // for std::forward
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>   // for VirtualAlloc
+#else
+#include <sys/mman.h>  // for mmap, mremap, munmap
+#endif
+
+namespace custom
+{
+
+/*****************************************
+ * MMAP ALLOCATOR
+ * Small requests go to the heap like std::allocator.
+ * Requests of threshold bytes or more are mapped
+ * pages. On Linux those pages are resized with
+ * mremap, so the elements are never copied and a
+ * shrink hands the unused pages back to the OS.
+ ****************************************/
+template <typename T, size_t threshold = ((size_t)64 << 20)>
+class mmap_allocator
+{
+public:
+   typedef T value_type;
+
+   template <typename U>
+   struct rebind
+   {
+      typedef mmap_allocator<U, threshold> other;
+   };
+
+   mmap_allocator() noexcept { }
+   template <typename U>
+   mmap_allocator(const mmap_allocator<U, threshold> &) noexcept { }
+
+   //
+   // Memory
+   //
+   T * allocate(size_t num);
+   void deallocate(T * p, size_t num) noexcept;
+   T * reallocate(T * p, size_t numOld, size_t numNew, size_t numKeep);
+
+   //
+   // Construct and destroy
+   //
+   template <typename U, typename ... Args>
+   void construct(U * p, Args && ... args)
+   {
+      new ((void*)p) U(std::forward<Args>(args)...);
+   }
+   template <typename U>
+   void destroy(U * p)
+   {
+      p->~U();
+   }
+
+   //
+   // Status
+   //
+   static bool isMapped(size_t num) { return num * sizeof(T) >= threshold; }
+
+   // all mmap allocators can free each other's memory
+   bool operator == (const mmap_allocator &) const { return true;  }
+   bool operator != (const mmap_allocator &) const { return false; }
+
+private:
+   static void * map(size_t bytes);
+   static void unmap(void * p, size_t bytes) noexcept;
+};
+
+/***************************************
+ * MMAP ALLOCATOR :: ALLOCATE
+ * Get room for num elements, mapping the
+ * pages if the buffer is big enough
+ *     INPUT  : num the number of elements
+ *     OUTPUT : the uninitialized buffer
+ **************************************/
+template <typename T, size_t threshold>
+T * mmap_allocator <T, threshold> :: allocate(size_t num)
+{
+   if (isMapped(num))
+      return (T *)map(num * sizeof(T));
+   return (T *)::operator new(num * sizeof(T));
+}
+
+/***************************************
+ * MMAP ALLOCATOR :: DEALLOCATE
+ * Give back a buffer from allocate(). The
+ * size tells us where it came from.
+ *     INPUT  : p   the buffer
+ *              num the number of elements it holds
+ *     OUTPUT :
+ **************************************/
+template <typename T, size_t threshold>
+void mmap_allocator <T, threshold> :: deallocate(T * p, size_t num) noexcept
+{
+   if (p == nullptr)
+      return;
+   if (isMapped(num))
+      unmap((void *)p, num * sizeof(T));
+   else
+      ::operator delete((void *)p);
+}
+
+/***************************************
+ * MMAP ALLOCATOR :: REALLOCATE
+ * Resize a buffer, keeping the bytes of the
+ * first numKeep elements. Only use this for
+ * trivially relocatable elements.
+ *     INPUT  : p       the buffer from allocate()
+ *              numOld  the size it was allocated with
+ *              numNew  the size we want
+ *              numKeep the number of elements to carry over
+ *     OUTPUT : the resized buffer, possibly at a new address
+ **************************************/
+template <typename T, size_t threshold>
+T * mmap_allocator <T, threshold> :: reallocate(T * p, size_t numOld,
+                                                size_t numNew, size_t numKeep)
+{
+#ifdef __linux__
+   //Both sides are pages so let the kernel move the page tables
+   if (p != nullptr && isMapped(numOld) && isMapped(numNew))
+   {
+      void * pNew = mremap((void *)p, numOld * sizeof(T),
+                           numNew * sizeof(T), MREMAP_MAYMOVE);
+      if (pNew == MAP_FAILED)
+         throw std::bad_alloc();
+      return (T *)pNew;
+   }
+#endif // __linux__
+
+   //Otherwise we have to copy into a fresh buffer
+   T * pNew = allocate(numNew);
+   if (numKeep > numNew)
+      numKeep = numNew;
+   if (numKeep)
+      std::memcpy((void *)pNew, (const void *)p, numKeep * sizeof(T));
+   deallocate(p, numOld);
+   return pNew;
+}
+
+/***************************************
+ * MMAP ALLOCATOR :: MAP
+ * Get zero-filled pages from the OS
+ **************************************/
+template <typename T, size_t threshold>
+void * mmap_allocator <T, threshold> :: map(size_t bytes)
+{
+#ifdef _WIN32
+   void * p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+   if (p == nullptr)
+      throw std::bad_alloc();
+#else
+   void * p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (p == MAP_FAILED)
+      throw std::bad_alloc();
+#endif // _WIN32
+   return p;
+}
+
+/***************************************
+ * MMAP ALLOCATOR :: UNMAP
+ * Return pages to the OS
+ **************************************/
+template <typename T, size_t threshold>
+void mmap_allocator <T, threshold> :: unmap(void * p, size_t bytes) noexcept
+{
+#ifdef _WIN32
+   VirtualFree(p, 0, MEM_RELEASE);
+#else
+   munmap(p, bytes);
+#endif // _WIN32
+}
+
+} // namespace custom
@@ -0,0 +1,456 @@
+/***********************************************************************
+ * Header:
+ *    MMAP VECTOR
+ * Summary:
+ *    A vector whose elements live in a memory-mapped file. Opening
+ *    an existing file maps it without reading it, so a restart costs
+ *    the same no matter how big the vector is, and every process
+ *    mapping the file shares the OS page cache.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        mmap_vector            : A vector backed by a file
+ * Author
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // because I am paranoid
+#include <cstdint>     // for uint64_t
+#include <cstring>     // for std::memcmp
+#include <stdexcept>   // for std::runtime_error
+#include <string>      // for the error messages
+#include <type_traits> // for std::is_trivially_copyable
+#include <utility>     // for std::swap
+#include "vector.h"    // for vector::iterator
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>   // for CreateFileMapping and MapViewOfFile
+#else
+#include <fcntl.h>     // for open
+#include <unistd.h>    // for ftruncate, pread and close
+#include <sys/mman.h>  // for mmap, mremap, msync, munmap
+#include <sys/stat.h>  // for fstat
+#endif // _WIN32
+
+class TestMmapVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * MMAP VECTOR
+ * The file holds a small header, which records the
+ * element size and how many elements there are,
+ * followed by the elements. The rest of the file
+ * past the elements is the spare capacity. Only
+ * trivially copyable T can be stored; pointers in
+ * T would mean nothing in the next process.
+ ****************************************/
+template <typename T>
+class mmap_vector
+{
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "mmap_vector can only hold trivially copyable types");
+   friend class ::TestMmapVector; // give unit tests access to the privates
+public:
+
+   //
+   // Construct
+   //
+   explicit mmap_vector(const char * fileName);
+   mmap_vector(mmap_vector && rhs);
+   mmap_vector(const mmap_vector & rhs) = delete;
+  ~mmap_vector();
+
+   //
+   // Assign
+   //
+   mmap_vector & operator = (mmap_vector && rhs)
+   {
+      swap(rhs);
+      return *this;
+   }
+   mmap_vector & operator = (const mmap_vector & rhs) = delete;
+   void swap(mmap_vector & rhs)
+   {
+      std::swap(pMap, rhs.pMap);
+      std::swap(numCapacity, rhs.numCapacity);
+#ifdef _WIN32
+      std::swap(hFile, rhs.hFile);
+      std::swap(hMapping, rhs.hMapping);
+#else
+      std::swap(fd, rhs.fd);
+#endif // _WIN32
+   }
+
+   //
+   // Iterator
+   //
+   typedef typename vector <T> ::iterator iterator;
+   typedef typename vector <T> ::const_iterator const_iterator;
+   iterator begin()              { return iterator(data());               }
+   iterator end()                { return iterator(data() + size());      }
+   const_iterator begin()  const { return const_iterator(data());         }
+   const_iterator end()    const { return const_iterator(data() + size()); }
+   const_iterator cbegin() const { return begin(); }
+   const_iterator cend()   const { return end();   }
+
+   //
+   // Access
+   //
+         T & operator [] (size_t index)       { return data()[index]; }
+   const T & operator [] (size_t index) const { return data()[index]; }
+         T & front()       { return data()[0]; }
+   const T & front() const { return data()[0]; }
+         T & back()        { return data()[size() - 1]; }
+   const T & back()  const { return data()[size() - 1]; }
+
+   //
+   // Insert
+   //
+   void push_back(const T & t)
+   {
+      //t might be one of ours, and growing moves the mapping
+      T copy = t;
+
+      //Grow the file by doubling, like vector
+      if (size() == capacity())
+         reserve(capacity() ? capacity() * 2 : 1);
+      data()[header()->numElements++] = copy;
+   }
+   void reserve(size_t newCapacity)
+   {
+      if (newCapacity > numCapacity)
+         remap(newCapacity);
+   }
+   void resize(size_t newElements);
+   void resize(size_t newElements, const T & t);
+
+   //
+   // Remove
+   //
+   void clear()      { header()->numElements = 0; }
+   void pop_back()
+   {
+      if (!empty())
+         header()->numElements--;
+   }
+   void shrink_to_fit()
+   {
+      if (numCapacity > size())
+         remap(size());
+   }
+
+   //
+   // Status
+   //
+   size_t size()     const { return (size_t)header()->numElements; }
+   size_t capacity() const { return numCapacity; }
+   bool   empty()    const { return size() == 0; }
+
+   // write dirty pages back to the file now instead of whenever the OS likes
+   void flush();
+
+private:
+
+   // the start of the file, written when it is first created
+   struct Header
+   {
+      char     magic[8];        // "CUSTVEC" so we know it is ours
+      uint64_t elementSize;     // sizeof(T) of whoever made it
+      uint64_t numElements;     // the number of items currently used
+   };
+   static const size_t headerSize = 64;   // so the elements stay aligned
+
+   Header * header()      const { return (Header *)pMap;             }
+   T * data()             const { return (T *)(pMap + headerSize);   }
+   static size_t bytes(size_t num) { return headerSize + num * sizeof(T); }
+
+   // read the header from the file without mapping or resizing it
+   bool readHeader(Header & h);
+
+   // resize the file to hold newCapacity elements and map all of it
+   void remap(size_t newCapacity);
+   void close() noexcept;
+
+   unsigned char * pMap;      // the whole file, header and all
+   size_t numCapacity;        // the number of elements the file can hold
+#ifdef _WIN32
+   HANDLE hFile;
+   HANDLE hMapping;
+#else
+   int fd;
+#endif // _WIN32
+};
+
+/*****************************************
+ * MMAP VECTOR :: CONSTRUCTOR
+ * Open fileName, creating it if needed, and map
+ * it. A file that is not empty must have been made
+ * by an mmap_vector of the same element size, or
+ * it is left alone and the constructor throws.
+ ****************************************/
+template <typename T>
+mmap_vector <T> :: mmap_vector(const char * fileName) : pMap(nullptr), numCapacity(0)
+{
+   //Open the file and find out how big it is
+   size_t fileSize;
+#ifdef _WIN32
+   hMapping = nullptr;
+   hFile = CreateFileA(fileName, GENERIC_READ | GENERIC_WRITE,
+                       FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                       OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (hFile == INVALID_HANDLE_VALUE)
+      throw std::runtime_error(std::string("mmap_vector: cannot open ") + fileName);
+   LARGE_INTEGER size;
+   GetFileSizeEx(hFile, &size);
+   fileSize = (size_t)size.QuadPart;
+#else
+   fd = ::open(fileName, O_RDWR | O_CREAT, 0644);
+   if (fd < 0)
+      throw std::runtime_error(std::string("mmap_vector: cannot open ") + fileName);
+   struct stat status;
+   fstat(fd, &status);
+   fileSize = (size_t)status.st_size;
+#endif // _WIN32
+
+   try
+   {
+      //A new file gets a header and no elements
+      if (fileSize == 0)
+      {
+         remap(0);
+         std::memcpy(header()->magic, "CUSTVEC", 8);
+         header()->elementSize = sizeof(T);
+         header()->numElements = 0;
+         return;
+      }
+
+      //An old file is read and checked before anything touches it,
+      //so a file that is not ours is left just as it was
+      Header h;
+      if (fileSize < headerSize || !readHeader(h) ||
+          std::memcmp(h.magic, "CUSTVEC", 8) != 0 ||
+          h.elementSize != sizeof(T) ||
+          (fileSize - headerSize) % sizeof(T) != 0 ||
+          h.numElements > (fileSize - headerSize) / sizeof(T))
+         throw std::runtime_error(std::string("mmap_vector: not a vector of this type: ") + fileName);
+
+      //The file is exactly the right size, so mapping it changes nothing
+      remap((fileSize - headerSize) / sizeof(T));
+   }
+   catch (...)
+   {
+      //The destructor will not run, so do not leak the file
+      close();
+      throw;
+   }
+}
+
+/*****************************************
+ * MMAP VECTOR :: MOVE CONSTRUCTOR
+ * Take over the file from rhs
+ ****************************************/
+template <typename T>
+mmap_vector <T> :: mmap_vector(mmap_vector && rhs) : pMap(nullptr), numCapacity(0)
+{
+#ifdef _WIN32
+   hFile = INVALID_HANDLE_VALUE;
+   hMapping = nullptr;
+#else
+   fd = -1;
+#endif // _WIN32
+   swap(rhs);
+}
+
+/*****************************************
+ * MMAP VECTOR :: DESTRUCTOR
+ * Unmap and close the file. The elements stay
+ * in the file for the next mmap_vector to find.
+ ****************************************/
+template <typename T>
+mmap_vector <T> :: ~mmap_vector()
+{
+   close();
+}
+
+/***************************************
+ * MMAP VECTOR :: RESIZE
+ * Grow or shrink to newElements. New elements
+ * are value-initialized, or copies of t.
+ *     INPUT  : newElements the new size
+ *     OUTPUT :
+ **************************************/
+template <typename T>
+void mmap_vector <T> :: resize(size_t newElements)
+{
+   resize(newElements, T());
+}
+
+template <typename T>
+void mmap_vector <T> :: resize(size_t newElements, const T & t)
+{
+   //t might be one of ours, and growing moves the mapping
+   T copy = t;
+   reserve(newElements);
+   for (size_t i = size(); i < newElements; i++)
+      data()[i] = copy;
+   header()->numElements = newElements;
+}
+
+/***************************************
+ * MMAP VECTOR :: FLUSH
+ * Write the dirty pages out and wait for them
+ **************************************/
+template <typename T>
+void mmap_vector <T> :: flush()
+{
+#ifdef _WIN32
+   FlushViewOfFile(pMap, bytes(numCapacity));
+   FlushFileBuffers(hFile);
+#else
+   msync(pMap, bytes(numCapacity), MS_SYNC);
+#endif // _WIN32
+}
+
+/***************************************
+ * MMAP VECTOR :: READ HEADER
+ * Read the first bytes of the file into h
+ *     INPUT  : h  where the header goes
+ *     OUTPUT : whether all of it could be read
+ **************************************/
+template <typename T>
+bool mmap_vector <T> :: readHeader(Header & h)
+{
+#ifdef _WIN32
+   LARGE_INTEGER start;
+   start.QuadPart = 0;
+   DWORD numRead = 0;
+   return SetFilePointerEx(hFile, start, nullptr, FILE_BEGIN) &&
+          ReadFile(hFile, &h, sizeof(Header), &numRead, nullptr) &&
+          numRead == sizeof(Header);
+#else
+   return pread(fd, &h, sizeof(Header), 0) == (ssize_t)sizeof(Header);
+#endif // _WIN32
+}
+
+/***************************************
+ * MMAP VECTOR :: REMAP
+ * Make the file exactly big enough for the header
+ * and newCapacity elements, and map all of it. The
+ * kernel moves the pages; nothing is copied.
+ *     INPUT  : newCapacity the number of elements to hold
+ *     OUTPUT :
+ **************************************/
+template <typename T>
+void mmap_vector <T> :: remap(size_t newCapacity)
+{
+   size_t oldBytes = bytes(numCapacity);
+   size_t newBytes = bytes(newCapacity);
+
+#ifdef _WIN32
+   //Windows will not resize a file that is mapped, so let go of it first
+   if (pMap)
+      UnmapViewOfFile(pMap);
+   if (hMapping)
+      CloseHandle(hMapping);
+   pMap = nullptr;
+   LARGE_INTEGER size;
+   size.QuadPart = (LONGLONG)newBytes;
+   SetFilePointerEx(hFile, size, nullptr, FILE_BEGIN);
+   SetEndOfFile(hFile);
+   hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+   if (hMapping == nullptr)
+      throw std::bad_alloc();
+   pMap = (unsigned char *)MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, newBytes);
+   if (pMap == nullptr)
+      throw std::bad_alloc();
+#else
+   //Shrinking: stop mapping the tail before the file loses it, and
+   //record the smaller size at once so a failed truncate below
+   //leaves numCapacity matching the mapping
+   if (pMap && newBytes < oldBytes)
+   {
+#ifdef __linux__
+      void * pNew = mremap(pMap, oldBytes, newBytes, MREMAP_MAYMOVE);
+#else
+      //Map the smaller view before letting go of the old one
+      void * pNew = mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (pNew != MAP_FAILED)
+         munmap(pMap, oldBytes);
+#endif // __linux__
+      if (pNew == MAP_FAILED)
+         throw std::bad_alloc();
+      pMap = (unsigned char *)pNew;
+      numCapacity = newCapacity;
+      oldBytes = newBytes;
+   }
+
+   //Size the file, then map the pages
+   if (ftruncate(fd, (off_t)newBytes) != 0)
+      throw std::bad_alloc();
+   if (pMap && newBytes > oldBytes)
+   {
+#ifdef __linux__
+      void * pNew = mremap(pMap, oldBytes, newBytes, MREMAP_MAYMOVE);
+#else
+      void * pNew = mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (pNew != MAP_FAILED)
+         munmap(pMap, oldBytes);
+#endif // __linux__
+      if (pNew == MAP_FAILED)
+         throw std::bad_alloc();
+      pMap = (unsigned char *)pNew;
+   }
+   if (pMap == nullptr)
+   {
+      void * pNew = mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (pNew == MAP_FAILED)
+         throw std::bad_alloc();
+      pMap = (unsigned char *)pNew;
+   }
+#endif // _WIN32
+
+   numCapacity = newCapacity;
+}
+
+/***************************************
+ * MMAP VECTOR :: CLOSE
+ * Unmap the pages and close the file
+ **************************************/
+template <typename T>
+void mmap_vector <T> :: close() noexcept
+{
+#ifdef _WIN32
+   if (pMap)
+      UnmapViewOfFile(pMap);
+   if (hMapping)
+      CloseHandle(hMapping);
+   if (hFile != INVALID_HANDLE_VALUE)
+      CloseHandle(hFile);
+   hMapping = nullptr;
+   hFile = INVALID_HANDLE_VALUE;
+#else
+   if (pMap)
+      munmap(pMap, bytes(numCapacity));
+   if (fd >= 0)
+      ::close(fd);
+   fd = -1;
+#endif // _WIN32
+   pMap = nullptr;
+   numCapacity = 0;
+}
+
+} // namespace custom
@@ -0,0 +1,437 @@
+/***********************************************************************
+ * Header:
+ *    SMALL VECTOR
+ * Summary:
+ *    A vector that keeps its first N elements inside the object
+ *    itself and only goes to the allocator when it outgrows them
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        small_vector           : A vector with N inline slots
+ *        small_vector::iterator : The same iterator as vector
+ *        small_vector::const_iterator : The same read-only iterator as vector
+ * Author
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>  // because I am paranoid
+#include <new>      // std::bad_alloc
+#include <memory>   // for std::allocator
+#include <iterator> // for the iterator tags
+#include <type_traits> // for std::enable_if
+#include "vector.h" // for vector::iterator and vector_base
+
+class TestSmallVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * SMALL VECTOR
+ * Just like custom::vector, but the first N
+ * elements live in a buffer inside the object.
+ * Only a vector that grows past N allocates.
+ * The buffer work is vector_base's; all this
+ * adds is switching between inline and heap.
+ ****************************************/
+template <typename T, size_t N = 8, typename A = std::allocator<T>>
+class small_vector : public vector_base<T, A, small_vector<T, N, A>>
+{
+   friend class ::TestSmallVector; // give unit tests access to the privates
+   typedef vector_base<T, A, small_vector> base;
+   friend base;
+   static_assert(N > 0, "small_vector needs at least one inline slot");
+public:
+
+   //
+   // Construct
+   //
+   small_vector(const A& a = A());
+   small_vector(size_t numElements,                const A & a = A());
+   small_vector(size_t numElements, const T & t,   const A & a = A());
+   small_vector(const std::initializer_list<T>& l, const A & a = A());
+   small_vector(const small_vector &  rhs);
+   small_vector(      small_vector && rhs);
+  ~small_vector();
+
+   //
+   // Assign
+   //
+   void swap(small_vector& rhs)
+   {
+      //Inline elements can't trade places by swapping pointers
+      small_vector temp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(temp);
+   }
+   small_vector & operator = (const small_vector & rhs);
+   small_vector & operator = (small_vector&& rhs);
+
+   //
+   // Iterator
+   //
+   typedef typename vector<T, A>::iterator       iterator;
+   typedef typename vector<T, A>::const_iterator const_iterator;
+   iterator begin()
+   {
+      return iterator(data);
+   }
+   iterator end()
+   {
+      return iterator(data + numElements);
+   }
+   const_iterator begin()  const { return const_iterator(data);               }
+   const_iterator end()    const { return const_iterator(data + numElements); }
+   const_iterator cbegin() const { return begin();                            }
+   const_iterator cend()   const { return end();                              }
+
+   //
+   // Access
+   //
+         T& operator [] (size_t index)       { return data[index];           }
+   const T& operator [] (size_t index) const { return data[index];           }
+         T& front()                          { return data[0];               }
+   const T& front()                    const { return data[0];               }
+         T& back()                           { return data[numElements - 1]; }
+   const T& back()                     const { return data[numElements - 1]; }
+
+   //
+   // Insert
+   //
+   void reserve(size_t newCapacity);
+   void resize(size_t newElements);
+   void resize(size_t newElements, const T& t);
+   iterator insert(iterator pos, size_t num, const T& t)
+   {
+      return iterator(this->insertFill(pos - begin(), num, t));
+   }
+   template <class Iterator,
+             class = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
+   iterator insert(iterator pos, Iterator first, Iterator last)
+   {
+      //Integers are not iterators: insert(pos, 3, 5) is a count and a value
+      return iterator(this->insertRange(pos - begin(), first, last,
+                      typename std::iterator_traits<Iterator>::iterator_category()));
+   }
+
+   //
+   // Remove
+   //
+   using base::clear;
+   iterator erase(iterator first, iterator last)
+   {
+      //The buffer stays where it is
+      return iterator(this->eraseRange(first - begin(), last - begin()));
+   }
+   void shrink_to_fit();
+
+   //
+   // Status
+   //
+   using base::size;
+   using base::capacity;
+   using base::empty;
+   bool isInline()         const { return data == inlineData();}
+
+private:
+   using base::alloc;
+   using base::data;
+   using base::numCapacity;
+   using base::numElements;
+   using base::relocate;
+
+   // the buffer inside the object
+         T * inlineData()       { return reinterpret_cast<      T *>(buffer); }
+   const T * inlineData() const { return reinterpret_cast<const T *>(buffer); }
+
+   // give back the heap buffer, if we have one, and go back inline
+   void release();
+
+   // free the old buffer, its elements already moved out, and take dataNew
+   void replaceBuffer(T * dataNew, size_t newCapacity)
+   {
+      release();
+      data = dataNew;
+      numCapacity = newCapacity;
+   }
+
+   // take the elements of rhs, leaving it empty
+   void steal(small_vector & rhs);
+
+   alignas(T) unsigned char buffer[N * sizeof(T)]; // the first N slots
+};
+
+/*****************************************
+ * SMALL VECTOR :: DEFAULT constructor
+ * Start out using the inline buffer
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> :: small_vector(const A & a) : base(a, nullptr, N)
+{
+   data = inlineData();
+}
+
+/*****************************************
+ * SMALL VECTOR :: NON-DEFAULT constructors
+ * non-default constructor: set the number of elements,
+ * construct each element, and copy the values over
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> :: small_vector(size_t num, const A & a) : base(a, nullptr, N)
+{
+   data = inlineData();
+   resize(num);
+}
+
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> :: small_vector(size_t num, const T & t, const A & a) : base(a, nullptr, N)
+{
+   data = inlineData();
+   resize(num, t);
+}
+
+/*****************************************
+ * SMALL VECTOR :: INITIALIZATION LIST constructors
+ * Create a small vector with an initialization list.
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> :: small_vector(const std::initializer_list<T> & l, const A & a) : base(a, nullptr, N)
+{
+   data = inlineData();
+   reserve(l.size());
+   for (auto it = l.begin(); it != l.end(); ++it)
+      alloc.construct(data + numElements++, *it);
+}
+
+/*****************************************
+ * SMALL VECTOR :: COPY CONSTRUCTOR
+ * Allocate only if rhs does not fit inline and
+ * call the copy constructor on each element
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> :: small_vector(const small_vector & rhs) : base(rhs.alloc, nullptr, N)
+{
+   data = inlineData();
+   reserve(rhs.numElements);
+   for (size_t i = 0; i < rhs.numElements; i++)
+      alloc.construct(data + numElements++, rhs.data[i]);
+}
+
+/*****************************************
+ * SMALL VECTOR :: MOVE CONSTRUCTOR
+ * Steal the heap buffer from the RHS, or move
+ * the elements over if they are inline.
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> :: small_vector(small_vector && rhs) : base(rhs.alloc, nullptr, N)
+{
+   data = inlineData();
+   steal(rhs);
+}
+
+/*****************************************
+ * SMALL VECTOR :: DESTRUCTOR
+ * Destroy each element and give back the heap
+ * buffer if we ever needed one
+ ****************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> :: ~small_vector()
+{
+   clear();
+   release();
+}
+
+/***************************************
+ * SMALL VECTOR :: RESIZE
+ * This method will adjust the size to newElements.
+ * This will either grow or shrink newElements.
+ *     INPUT  : newElements the new size
+ *     OUTPUT :
+ **************************************/
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> :: resize(size_t newElements)
+{
+   //Desired size is smaller than current so destroy the old slots
+   if (newElements < numElements)
+      for (size_t i = newElements; i < numElements; i++)
+         alloc.destroy(data + i);
+
+   //New slots are made
+   else if (newElements > numElements)
+   {
+      reserve(newElements);
+      for (size_t i = numElements; i < newElements; i++)
+         new ((void*)(data + i)) T;
+   }
+   numElements = newElements;
+}
+
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> :: resize(size_t newElements, const T & t)
+{
+   //Desired size is smaller than current so destroy the old slots
+   if (newElements < numElements)
+      for (size_t i = newElements; i < numElements; i++)
+         alloc.destroy(data + i);
+
+   //t might be one of ours and about to move, so keep a copy
+   else if (newElements > numElements && &t >= data && &t < data + numElements)
+   {
+      T copy(t);
+      resize(newElements, copy);
+      return;
+   }
+
+   //New slots are made and filled with t
+   else if (newElements > numElements)
+   {
+      reserve(newElements);
+      for (size_t i = numElements; i < newElements; i++)
+         alloc.construct(data + i, t);
+   }
+   numElements = newElements;
+}
+
+/***************************************
+ * SMALL VECTOR :: RESERVE
+ * Grow the buffer to newCapacity. The first
+ * time past N this moves us out to the heap.
+ *     INPUT  : newCapacity the size of the new buffer
+ *     OUTPUT :
+ **************************************/
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> :: reserve(size_t newCapacity)
+{
+   //Already have enough space
+   if (newCapacity <= numCapacity)
+      return;
+
+   //Make new space and move the elements over
+   this->moveTo(newCapacity);
+}
+
+/***************************************
+ * SMALL VECTOR :: SHRINK TO FIT
+ * Get rid of any extra capacity, moving back
+ * inline if the elements fit there again
+ *     INPUT  :
+ *     OUTPUT :
+ **************************************/
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> :: shrink_to_fit()
+{
+   //Inline storage has nothing to give back
+   if (isInline() || numElements == numCapacity)
+      return;
+
+   //Everything fits back inside the object
+   if (numElements <= N)
+   {
+      T * dataOld = data;
+      size_t capacityOld = numCapacity;
+      relocate(inlineData(), dataOld, numElements);
+      alloc.deallocate(dataOld, capacityOld);
+      data = inlineData();
+      numCapacity = N;
+      return;
+   }
+
+   //Still on the heap, just a smaller piece of it
+   this->moveTo(numElements);
+}
+
+/***************************************
+ * SMALL VECTOR :: ASSIGNMENT
+ * This operator will copy the contents of the
+ * rhs onto *this, growing the buffer as needed
+ *     INPUT  : rhs the small vector to copy from
+ *     OUTPUT : *this
+ **************************************/
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> & small_vector <T, N, A> :: operator = (const small_vector & rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   //Not enough room: start over with a big enough buffer
+   if (rhs.size() > capacity())
+   {
+      clear();
+      reserve(rhs.size());
+   }
+
+   //Assign over the elements we share, then fix up the rest
+   size_t numCommon = size() < rhs.size() ? size() : rhs.size();
+   for (size_t i = 0; i < numCommon; i++)
+      data[i] = rhs.data[i];
+   for (size_t i = numCommon; i < rhs.size(); i++)
+      alloc.construct(data + i, rhs.data[i]);
+   for (size_t i = rhs.size(); i < size(); i++)
+      alloc.destroy(data + i);
+
+   numElements = rhs.size();
+   return *this;
+}
+
+template <typename T, size_t N, typename A>
+small_vector <T, N, A> & small_vector <T, N, A> :: operator = (small_vector && rhs)
+{
+   //If they are the same vector, do nothing
+   if (this == &rhs)
+      return *this;
+
+   //Empty ourselves out and take theirs
+   clear();
+   release();
+   steal(rhs);
+   return *this;
+}
+
+/***************************************
+ * SMALL VECTOR :: RELEASE
+ * Free the heap buffer and point back at the
+ * inline one. The elements must already be gone.
+ **************************************/
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> :: release()
+{
+   if (!isInline())
+      alloc.deallocate(data, numCapacity);
+   data = inlineData();
+   numCapacity = N;
+}
+
+/***************************************
+ * SMALL VECTOR :: STEAL
+ * Take the elements from rhs. A heap buffer
+ * changes hands; inline elements get moved.
+ * We must be empty and inline beforehand.
+ **************************************/
+template <typename T, size_t N, typename A>
+void small_vector <T, N, A> :: steal(small_vector & rhs)
+{
+   assert(isInline() && empty());
+
+   if (rhs.isInline())
+      relocate(inlineData(), rhs.data, rhs.numElements);
+   else
+   {
+      data = rhs.data;
+      numCapacity = rhs.numCapacity;
+      rhs.data = rhs.inlineData();
+      rhs.numCapacity = N;
+   }
+   numElements = rhs.numElements;
+   rhs.numElements = 0;
+}
+
+} // namespace custom
@@ -0,0 +1,366 @@
+/***********************************************************************
+ * Header:
+ *    SOA VECTOR
+ * Summary:
+ *    A structure-of-arrays vector. Each field of a record lives in
+ *    its own contiguous column, so a loop over one field streams
+ *    only that field through the cache.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        span                   : A view of one contiguous column
+ *        soa_reference          : One row, as references into the columns
+ *        soa_vector             : One vector per field
+ *        soa_vector::iterator   : An iterator through the rows
+ *        soa_vector::const_iterator : A read-only iterator through the rows
+ * Author
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // because I am paranoid
+#include <tuple>       // for std::tuple and std::tie
+#include <utility>     // for std::index_sequence
+#include <iterator>    // for std::random_access_iterator_tag
+#include <cstddef>     // for std::ptrdiff_t
+#include "vector.h"
+
+class TestSoaVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * SPAN
+ * A pointer and a length. This is what a column
+ * of a soa_vector looks like from the outside: the
+ * values can be read and changed, but the column
+ * cannot be resized on its own.
+ ****************************************/
+template <typename T>
+class span
+{
+public:
+   span()                  : p(nullptr), num(0)   {  }
+   span(T * p, size_t num) : p(p),       num(num) {  }
+
+   T * begin()  const { return p;        }
+   T * end()    const { return p + num;  }
+   T * data()   const { return p;        }
+   size_t size() const { return num;     }
+   bool empty()  const { return num == 0; }
+   T & operator [] (size_t index) const { return p[index]; }
+
+private:
+   T * p;
+   size_t num;
+};
+
+/*****************************************
+ * SOA REFERENCE
+ * A row: a tuple of references into the columns.
+ * Assigning to it, even to a temporary, writes the
+ * fields in place, and swap trades the fields of
+ * two rows. That is what lets std::sort and the
+ * other algorithms move rows through the iterator.
+ ****************************************/
+template <typename ... Fields>
+class soa_reference : public std::tuple<Fields & ...>
+{
+   typedef std::tuple<Fields & ...> Base;
+public:
+   soa_reference(Fields & ... fields) : Base(fields...) {  }
+   soa_reference(const soa_reference & rhs) = default;
+
+   const soa_reference & operator = (const soa_reference & rhs) const
+   {
+      assign(rhs, std::index_sequence_for<Fields...>());
+      return *this;
+   }
+   const soa_reference & operator = (const std::tuple<Fields...> & rhs) const
+   {
+      assign(rhs, std::index_sequence_for<Fields...>());
+      return *this;
+   }
+   const soa_reference & operator = (std::tuple<Fields...> && rhs) const
+   {
+      assignMove(rhs, std::index_sequence_for<Fields...>());
+      return *this;
+   }
+
+   // found by std::iter_swap, which hands over two temporaries
+   friend void swap(soa_reference lhs, soa_reference rhs)
+   {
+      lhs.swapFields(rhs, std::index_sequence_for<Fields...>());
+   }
+
+private:
+   template <class Tuple, size_t ... I>
+   void assign(const Tuple & rhs, std::index_sequence<I...>) const
+   {
+      int unused[] = { 0, (std::get<I>(base()) = std::get<I>(rhs), 0)... };
+      (void)unused;
+   }
+   template <size_t ... I>
+   void assignMove(std::tuple<Fields...> & rhs, std::index_sequence<I...>) const
+   {
+      int unused[] = { 0, (std::get<I>(base()) = std::move(std::get<I>(rhs)), 0)... };
+      (void)unused;
+   }
+   template <size_t ... I>
+   void swapFields(soa_reference & rhs, std::index_sequence<I...>) const
+   {
+      using std::swap;
+      int unused[] = { 0, (swap(std::get<I>(base()), std::get<I>(rhs.base())), 0)... };
+      (void)unused;
+   }
+
+   // the references themselves never change, only what they refer to
+   Base & base() const { return const_cast<soa_reference &>(*this); }
+};
+
+/*****************************************
+ * SOA VECTOR
+ * Holds rows of (Fields...) as one custom::vector
+ * per field, kept the same length. A row is handed
+ * out as a tuple of references into the columns.
+ ****************************************/
+template <typename ... Fields>
+class soa_vector
+{
+   static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+   friend class ::TestSoaVector; // give unit tests access to the privates
+   typedef std::index_sequence_for<Fields...> Indexes;
+public:
+   typedef soa_reference<Fields...>       reference;
+   typedef std::tuple<const Fields & ...> const_reference;
+   template <size_t I>
+   using field_type = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+   //
+   // Construct
+   //
+   soa_vector() {}
+   soa_vector(size_t num) : columns(vector<Fields>(num)...) {}
+
+   //
+   // Assign
+   //
+   void swap(soa_vector & rhs) { columns.swap(rhs.columns); }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   class const_iterator;
+   iterator begin() { return iterator(this, 0);      }
+   iterator end()   { return iterator(this, size()); }
+   const_iterator begin()  const { return const_iterator(this, 0);      }
+   const_iterator end()    const { return const_iterator(this, size()); }
+   const_iterator cbegin() const { return begin(); }
+   const_iterator cend()   const { return end();   }
+
+   //
+   // Access
+   //
+   reference       operator [] (size_t index)       { return row(index, Indexes()); }
+   const_reference operator [] (size_t index) const { return row(index, Indexes()); }
+   reference       front()       { return (*this)[0];          }
+   const_reference front() const { return (*this)[0];          }
+   reference       back()        { return (*this)[size() - 1]; }
+   const_reference back()  const { return (*this)[size() - 1]; }
+
+   // one field of every row, contiguous
+   template <size_t I>
+   span<field_type<I>> column()
+   {
+      vector<field_type<I>> & v = std::get<I>(columns);
+      return span<field_type<I>>(v.empty() ? nullptr : &*v.begin(), v.size());
+   }
+   template <size_t I>
+   span<const field_type<I>> column() const
+   {
+      const vector<field_type<I>> & v = std::get<I>(columns);
+      return span<const field_type<I>>(v.empty() ? nullptr : &*v.begin(), v.size());
+   }
+
+   //
+   // Insert
+   //
+   void push_back(const Fields & ... fields)
+   {
+      pushBack(Indexes(), fields...);
+   }
+   void push_back(const std::tuple<Fields...> & t)
+   {
+      pushBackTuple(t, Indexes());
+   }
+   void reserve(size_t newCapacity) { forEach([=](auto & v) { v.reserve(newCapacity); }); }
+   void resize(size_t newElements)  { forEach([=](auto & v) { v.resize(newElements);  }); }
+
+   //
+   // Remove
+   //
+   void clear()         { forEach([](auto & v) { v.clear();         }); }
+   void pop_back()      { forEach([](auto & v) { v.pop_back();      }); }
+   void shrink_to_fit() { forEach([](auto & v) { v.shrink_to_fit(); }); }
+
+   //
+   // Status
+   //
+   size_t size()     const { return std::get<0>(columns).size();     }
+   size_t capacity() const { return std::get<0>(columns).capacity(); }
+   bool   empty()    const { return size() == 0; }
+
+private:
+
+   template <size_t ... I>
+   reference row(size_t index, std::index_sequence<I...>)
+   {
+      return reference(std::get<I>(columns)[index]...);
+   }
+   template <size_t ... I>
+   const_reference row(size_t index, std::index_sequence<I...>) const
+   {
+      return const_reference(std::get<I>(columns)[index]...);
+   }
+
+   template <size_t ... I>
+   void pushBack(std::index_sequence<I...>, const Fields & ... fields)
+   {
+      // the array is only here so the pack expands in order
+      int unused[] = { 0, (std::get<I>(columns).push_back(fields), 0)... };
+      (void)unused;
+   }
+   template <size_t ... I>
+   void pushBackTuple(const std::tuple<Fields...> & t, std::index_sequence<I...>)
+   {
+      pushBack(Indexes(), std::get<I>(t)...);
+   }
+
+   // do the same thing to every column
+   template <class F>
+   void forEach(F f)
+   {
+      forEach(f, Indexes());
+   }
+   template <class F, size_t ... I>
+   void forEach(F f, std::index_sequence<I...>)
+   {
+      int unused[] = { 0, (f(std::get<I>(columns)), 0)... };
+      (void)unused;
+   }
+
+   std::tuple<vector<Fields>...> columns;   // one vector per field, all the same size
+};
+
+/**************************************************
+ * SOA VECTOR ITERATOR
+ * Walks the rows. Dereferencing builds a
+ * soa_reference, so this is a proxy iterator: it
+ * does not hand out a real T&, but rows can be
+ * read, written and swapped through it, which is
+ * enough for std::sort.
+ *************************************************/
+template <typename ... Fields>
+class soa_vector <Fields...> ::iterator
+{
+   friend class soa_vector <Fields...> ::const_iterator;
+public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef std::tuple<Fields...>           value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef void                            pointer;
+   typedef typename soa_vector::reference  reference;
+
+   iterator()                                 : pSoa(nullptr), index(0)     {  }
+   iterator(soa_vector * pSoa, size_t index)  : pSoa(pSoa),    index(index) {  }
+
+   bool operator != (const iterator & rhs) const { return index != rhs.index; }
+   bool operator == (const iterator & rhs) const { return index == rhs.index; }
+   bool operator <  (const iterator & rhs) const { return index <  rhs.index; }
+   bool operator >  (const iterator & rhs) const { return index >  rhs.index; }
+   bool operator <= (const iterator & rhs) const { return index <= rhs.index; }
+   bool operator >= (const iterator & rhs) const { return index >= rhs.index; }
+
+   reference operator * () const { return (*pSoa)[index]; }
+   reference operator [] (difference_type n) const { return (*pSoa)[index + n]; }
+
+   iterator & operator ++ ()    { ++index; return *this; }
+   iterator   operator ++ (int) { iterator it = *this; ++index; return it; }
+   iterator & operator -- ()    { --index; return *this; }
+   iterator   operator -- (int) { iterator it = *this; --index; return it; }
+   iterator & operator += (difference_type n) { index += n; return *this; }
+   iterator & operator -= (difference_type n) { index -= n; return *this; }
+   iterator   operator +  (difference_type n) const { return iterator(pSoa, index + n); }
+   iterator   operator -  (difference_type n) const { return iterator(pSoa, index - n); }
+   difference_type operator - (const iterator & rhs) const
+   {
+      return (difference_type)index - (difference_type)rhs.index;
+   }
+   friend iterator operator + (difference_type n, const iterator & it) { return it + n; }
+
+private:
+   soa_vector * pSoa;
+   size_t index;
+};
+
+/**************************************************
+ * SOA VECTOR CONST ITERATOR
+ * The same walk as iterator, but each row is a
+ * const_reference, a tuple of const references,
+ * so it can be read and not written. Any iterator
+ * converts to one of these.
+ *************************************************/
+template <typename ... Fields>
+class soa_vector <Fields...> ::const_iterator
+{
+public:
+   typedef std::random_access_iterator_tag         iterator_category;
+   typedef std::tuple<Fields...>                   value_type;
+   typedef std::ptrdiff_t                          difference_type;
+   typedef void                                    pointer;
+   typedef typename soa_vector::const_reference    reference;
+
+   const_iterator()                                      : pSoa(nullptr),   index(0)        {  }
+   const_iterator(const soa_vector * pSoa, size_t index) : pSoa(pSoa),      index(index)    {  }
+   const_iterator(const iterator & rhs)                  : pSoa(rhs.pSoa),  index(rhs.index) {  }
+
+   bool operator != (const const_iterator & rhs) const { return index != rhs.index; }
+   bool operator == (const const_iterator & rhs) const { return index == rhs.index; }
+   bool operator <  (const const_iterator & rhs) const { return index <  rhs.index; }
+   bool operator >  (const const_iterator & rhs) const { return index >  rhs.index; }
+   bool operator <= (const const_iterator & rhs) const { return index <= rhs.index; }
+   bool operator >= (const const_iterator & rhs) const { return index >= rhs.index; }
+
+   reference operator * () const { return (*pSoa)[index]; }
+   reference operator [] (difference_type n) const { return (*pSoa)[index + n]; }
+
+   const_iterator & operator ++ ()    { ++index; return *this; }
+   const_iterator   operator ++ (int) { const_iterator it = *this; ++index; return it; }
+   const_iterator & operator -- ()    { --index; return *this; }
+   const_iterator   operator -- (int) { const_iterator it = *this; --index; return it; }
+   const_iterator & operator += (difference_type n) { index += n; return *this; }
+   const_iterator & operator -= (difference_type n) { index -= n; return *this; }
+   const_iterator   operator +  (difference_type n) const { return const_iterator(pSoa, index + n); }
+   const_iterator   operator -  (difference_type n) const { return const_iterator(pSoa, index - n); }
+   difference_type operator - (const const_iterator & rhs) const
+   {
+      return (difference_type)index - (difference_type)rhs.index;
+   }
+   friend const_iterator operator + (difference_type n, const const_iterator & it) { return it + n; }
+
+private:
+   const soa_vector * pSoa;
+   size_t index;
+};
+
+} // namespace custom
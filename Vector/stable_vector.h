@@ -0,0 +1,386 @@
+/***********************************************************************
+ * Header:
+ *    STABLE VECTOR
+ * Summary:
+ *    A segmented vector. Like deque it keeps its elements in fixed
+ *    size blocks reached through a table of block pointers, so growing
+ *    never moves an element and pointers to elements stay good.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        stable_vector                 : A vector that never relocates
+ *        stable_vector::iterator       : An iterator through it
+ *        stable_vector::const_iterator : A read-only iterator
+ * Author
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>     // because I am paranoid
+#include <memory>      // for std::allocator
+#include <iterator>    // for std::random_access_iterator_tag
+#include <utility>     // for std::move
+#include <initializer_list>
+#include "vector.h"    // for the block table
+
+class TestStableVector; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************
+ * STABLE VECTOR BLOCK CELLS
+ * About 4KB of elements per block, rounded down to
+ * a power of two so an index splits with a shift
+ * and a mask. Never fewer than 16.
+ ****************************************/
+constexpr size_t stableBlockCells(size_t size, size_t cells = 16)
+{
+   return cells * 2 * size > 4096 ? cells : stableBlockCells(size, cells * 2);
+}
+
+/*****************************************
+ * STABLE VECTOR
+ * Elements live in blocks of numCells. The blocks
+ * are listed in a vector of pointers; when that
+ * table grows only the pointers are copied.
+ * Element i is in block i / numCells at cell
+ * i % numCells, so indexing is O(1).
+ ****************************************/
+template <typename T, size_t numCells = stableBlockCells(sizeof(T)),
+          typename A = std::allocator<T>>
+class stable_vector
+{
+   static_assert(numCells > 0 && (numCells & (numCells - 1)) == 0,
+                 "stable_vector blocks must hold a power of two elements");
+   friend class ::TestStableVector; // give unit tests access to the privates
+public:
+
+   //
+   // Construct
+   //
+   stable_vector(const A & a = A()) : alloc(a), numElements(0) {}
+   stable_vector(size_t num, const A & a = A()) : alloc(a), numElements(0)
+   {
+      resize(num);
+   }
+   stable_vector(size_t num, const T & t, const A & a = A()) : alloc(a), numElements(0)
+   {
+      resize(num, t);
+   }
+   stable_vector(const std::initializer_list<T> & l, const A & a = A()) : alloc(a), numElements(0)
+   {
+      reserve(l.size());
+      for (const T & t : l)
+         push_back(t);
+   }
+   stable_vector(const stable_vector & rhs) : alloc(rhs.alloc), numElements(0)
+   {
+      *this = rhs;
+   }
+   stable_vector(stable_vector && rhs) : alloc(rhs.alloc), numElements(0)
+   {
+      swap(rhs);
+   }
+  ~stable_vector()
+   {
+      clear();
+      shrink_to_fit();
+   }
+
+   //
+   // Assign
+   //
+   stable_vector & operator = (const stable_vector & rhs);
+   stable_vector & operator = (stable_vector && rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(stable_vector & rhs)
+   {
+      blocks.swap(rhs.blocks);
+      std::swap(numElements, rhs.numElements);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   class const_iterator;
+   iterator begin()              { return iterator(this, 0);                  }
+   iterator end()                { return iterator(this, numElements);        }
+   const_iterator begin()  const { return const_iterator(this, 0);            }
+   const_iterator end()    const { return const_iterator(this, numElements);  }
+   const_iterator cbegin() const { return begin(); }
+   const_iterator cend()   const { return end();   }
+
+   //
+   // Access
+   //
+   T & operator [] (size_t index)
+   {
+      assert(index < numElements);
+      return blocks[ibFromID(index)][icFromID(index)];
+   }
+   const T & operator [] (size_t index) const
+   {
+      assert(index < numElements);
+      return blocks[ibFromID(index)][icFromID(index)];
+   }
+         T & front()       { return (*this)[0];               }
+   const T & front() const { return (*this)[0];               }
+         T & back()        { return (*this)[numElements - 1]; }
+   const T & back()  const { return (*this)[numElements - 1]; }
+
+   //
+   // Insert
+   //
+   void push_back(const T & t)
+   {
+      new ((void *)slotBack()) T(t);
+      numElements++;
+   }
+   void push_back(T && t)
+   {
+      new ((void *)slotBack()) T(std::move(t));
+      numElements++;
+   }
+   template <typename ... Args>
+   T & emplace_back(Args && ... args)
+   {
+      T * p = new ((void *)slotBack()) T(std::forward<Args>(args)...);
+      numElements++;
+      return *p;
+   }
+   void reserve(size_t newCapacity)
+   {
+      //Only whole blocks are added; nothing already here moves
+      while (capacity() < newCapacity)
+         blocks.push_back(alloc.allocate(numCells));
+   }
+   void resize(size_t newElements);
+   void resize(size_t newElements, const T & t);
+
+   //
+   // Remove
+   //
+   void pop_back()
+   {
+      if (!empty())
+      {
+         alloc.destroy(&back());
+         numElements--;
+      }
+   }
+   void clear()
+   {
+      for (size_t id = 0; id < numElements; id++)
+         alloc.destroy(&(*this)[id]);
+      numElements = 0;
+   }
+   void shrink_to_fit();
+
+   //
+   // Status
+   //
+   size_t size()     const { return numElements; }
+   size_t capacity() const { return blocks.size() * numCells; }
+   bool   empty()    const { return numElements == 0; }
+
+private:
+   // block index from the index of an element
+   static size_t ibFromID(size_t id) { return id / numCells; }
+
+   // cell index within that block
+   static size_t icFromID(size_t id) { return id & (numCells - 1); }
+
+   // the raw slot just past the end, adding a block if we are full
+   T * slotBack()
+   {
+      if (numElements == capacity())
+         blocks.push_back(alloc.allocate(numCells));
+      return blocks[ibFromID(numElements)] + icFromID(numElements);
+   }
+
+   A alloc;                   // for the blocks and the elements in them
+   vector<T *> blocks;        // the block table; every block is full size
+   size_t numElements;        // the number of elements in use
+};
+
+/**************************************************
+ * STABLE VECTOR ITERATOR
+ * An index into a stable vector. Every jump is a
+ * bit of arithmetic, so this is random-access.
+ *************************************************/
+template <typename T, size_t numCells, typename A>
+class stable_vector <T, numCells, A> ::iterator
+{
+   friend class ::TestStableVector; // give unit tests access to the privates
+   friend class stable_vector <T, numCells, A> ::const_iterator;
+public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
+   iterator()                                 : v(nullptr), id(0)  {  }
+   iterator(stable_vector * v, size_t id)     : v(v),       id(id) {  }
+
+   bool operator != (const iterator & rhs) const { return id != rhs.id; }
+   bool operator == (const iterator & rhs) const { return id == rhs.id; }
+   bool operator <  (const iterator & rhs) const { return id <  rhs.id; }
+   bool operator >  (const iterator & rhs) const { return id >  rhs.id; }
+   bool operator <= (const iterator & rhs) const { return id <= rhs.id; }
+   bool operator >= (const iterator & rhs) const { return id >= rhs.id; }
+
+   T & operator * ()  const { return (*v)[id];  }
+   T * operator -> () const { return &(*v)[id]; }
+   T & operator [] (difference_type n) const { return (*v)[id + n]; }
+
+   iterator & operator ++ ()    { ++id; return *this; }
+   iterator   operator ++ (int) { iterator it = *this; ++id; return it; }
+   iterator & operator -- ()    { --id; return *this; }
+   iterator   operator -- (int) { iterator it = *this; --id; return it; }
+   iterator & operator += (difference_type n) { id += n; return *this; }
+   iterator & operator -= (difference_type n) { id -= n; return *this; }
+   iterator   operator +  (difference_type n) const { return iterator(v, id + n); }
+   iterator   operator -  (difference_type n) const { return iterator(v, id - n); }
+   friend iterator operator + (difference_type n, const iterator & it) { return it + n; }
+   difference_type operator - (const iterator & rhs) const
+   {
+      return (difference_type)id - (difference_type)rhs.id;
+   }
+
+private:
+   stable_vector * v;
+   size_t id;
+};
+
+/**************************************************
+ * STABLE VECTOR CONST ITERATOR
+ * The same, but read-only
+ *************************************************/
+template <typename T, size_t numCells, typename A>
+class stable_vector <T, numCells, A> ::const_iterator
+{
+public:
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef const T *                       pointer;
+   typedef const T &                       reference;
+
+   const_iterator()                                 : v(nullptr), id(0)  {  }
+   const_iterator(const stable_vector * v, size_t id) : v(v),     id(id) {  }
+   const_iterator(const iterator & rhs)             : v(rhs.v),   id(rhs.id) {  }
+
+   bool operator != (const const_iterator & rhs) const { return id != rhs.id; }
+   bool operator == (const const_iterator & rhs) const { return id == rhs.id; }
+   bool operator <  (const const_iterator & rhs) const { return id <  rhs.id; }
+   bool operator >  (const const_iterator & rhs) const { return id >  rhs.id; }
+   bool operator <= (const const_iterator & rhs) const { return id <= rhs.id; }
+   bool operator >= (const const_iterator & rhs) const { return id >= rhs.id; }
+
+   const T & operator * ()  const { return (*v)[id];  }
+   const T * operator -> () const { return &(*v)[id]; }
+   const T & operator [] (difference_type n) const { return (*v)[id + n]; }
+
+   const_iterator & operator ++ ()    { ++id; return *this; }
+   const_iterator   operator ++ (int) { const_iterator it = *this; ++id; return it; }
+   const_iterator & operator -- ()    { --id; return *this; }
+   const_iterator   operator -- (int) { const_iterator it = *this; --id; return it; }
+   const_iterator & operator += (difference_type n) { id += n; return *this; }
+   const_iterator & operator -= (difference_type n) { id -= n; return *this; }
+   const_iterator   operator +  (difference_type n) const { return const_iterator(v, id + n); }
+   const_iterator   operator -  (difference_type n) const { return const_iterator(v, id - n); }
+   friend const_iterator operator + (difference_type n, const const_iterator & it) { return it + n; }
+   difference_type operator - (const const_iterator & rhs) const
+   {
+      return (difference_type)id - (difference_type)rhs.id;
+   }
+
+private:
+   const stable_vector * v;
+   size_t id;
+};
+
+/*****************************************
+ * STABLE VECTOR :: COPY-ASSIGN
+ * Assign over the elements we share, then
+ * construct or destroy the difference. Our
+ * blocks are kept, so no pointer into the
+ * shared part moves.
+ ****************************************/
+template <typename T, size_t numCells, typename A>
+stable_vector <T, numCells, A> & stable_vector <T, numCells, A> :: operator = (const stable_vector & rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   size_t numShared = numElements < rhs.numElements ? numElements : rhs.numElements;
+   for (size_t id = 0; id < numShared; id++)
+      (*this)[id] = rhs[id];
+   while (numElements > rhs.numElements)
+      pop_back();
+   reserve(rhs.numElements);
+   for (size_t id = numShared; id < rhs.numElements; id++)
+      push_back(rhs[id]);
+   return *this;
+}
+
+/***************************************
+ * STABLE VECTOR :: RESIZE
+ * Grow with default-constructed elements or
+ * copies of t, or shrink by destroying the tail
+ *     INPUT  : newElements the new size
+ *     OUTPUT :
+ **************************************/
+template <typename T, size_t numCells, typename A>
+void stable_vector <T, numCells, A> :: resize(size_t newElements)
+{
+   while (numElements > newElements)
+      pop_back();
+   reserve(newElements);
+   while (numElements < newElements)
+      emplace_back();
+}
+
+template <typename T, size_t numCells, typename A>
+void stable_vector <T, numCells, A> :: resize(size_t newElements, const T & t)
+{
+   while (numElements > newElements)
+      pop_back();
+   reserve(newElements);
+   while (numElements < newElements)
+      push_back(t);
+}
+
+/***************************************
+ * STABLE VECTOR :: SHRINK TO FIT
+ * Free the blocks past the last element. The
+ * block holding the last element stays whole.
+ **************************************/
+template <typename T, size_t numCells, typename A>
+void stable_vector <T, numCells, A> :: shrink_to_fit()
+{
+   size_t numBlocksUsed = (numElements + numCells - 1) / numCells;
+   while (blocks.size() > numBlocksUsed)
+   {
+      alloc.deallocate(blocks.back(), numCells);
+      blocks.pop_back();
+   }
+   blocks.shrink_to_fit();
+}
+
+} // namespace custom
@@ -0,0 +1,428 @@
+/***********************************************************************
+ * Header:
+ *    TEST MMAP VECTOR
+ * Summary:
+ *    Unit tests for mmap_vector. Each test works on a scratch file
+ *    in the current directory and removes it when done.
+ * Author:
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mmap_vector.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+class TestMmapVector : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_newFile();
+      test_construct_reopen();
+      test_construct_wrongType();
+      test_construct_shortForeign();
+      test_construct_longForeign();
+      test_construct_ragged();
+      test_constructMove_standard();
+
+      // Iterator
+      test_iterator_sort();
+
+      // Insert
+      test_pushback_grow();
+      test_pushback_ownElement();
+      test_reserve_ten();
+      test_resize_value();
+      test_resize_ownElement();
+
+      // Remove
+      test_popback_persist();
+      test_shrink_standard();
+
+      report("MmapVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // a new file gets just the header
+   void test_construct_newFile()
+   {  // setup
+      std::remove(fileName);
+      // exercise
+      {
+         custom::mmap_vector<int> v(fileName);
+         // verify
+         assertUnit(v.pMap != nullptr);
+         assertUnit(v.numCapacity == 0);
+         assertUnit(v.size() == 0);
+         assertUnit(v.empty());
+      }
+      assertUnit(fileSize() == 64);
+      std::remove(fileName);
+   }  // teardown
+
+   // the elements are still there after the vector is closed
+   void test_construct_reopen()
+   {  // setup
+      std::remove(fileName);
+      {
+         custom::mmap_vector<int> v(fileName);
+         setupStandardFixture(v);
+      }
+      // exercise
+      custom::mmap_vector<int> v(fileName);
+      // verify
+      assertStandardFixture(v);
+      std::remove(fileName);
+   }  // teardown
+
+   // a file of int cannot be opened as a vector of double
+   void test_construct_wrongType()
+   {  // setup
+      std::remove(fileName);
+      {
+         custom::mmap_vector<int> v(fileName);
+         setupStandardFixture(v);
+      }
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::mmap_vector<double> v(fileName);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      std::remove(fileName);
+   }  // teardown
+
+   // a file too short for a header is not ours, and is not touched
+   void test_construct_shortForeign()
+   {  // setup
+      std::string contents = "hello\n";
+      writeFile(contents);
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::mmap_vector<int> v(fileName);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(readFile() == contents);
+      std::remove(fileName);
+   }  // teardown
+
+   // a longer file without the magic is checked before it is resized
+   void test_construct_longForeign()
+   {  // setup
+      std::string contents;
+      for (int i = 0; i < 101; i++)
+         contents += (char)('a' + i % 26);
+      writeFile(contents);
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::mmap_vector<int> v(fileName);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(readFile() == contents);
+      std::remove(fileName);
+   }  // teardown
+
+   // a vector file with a partial element on the end is refused, not cut
+   void test_construct_ragged()
+   {  // setup
+      std::remove(fileName);
+      {
+         custom::mmap_vector<int> v(fileName);
+         setupStandardFixture(v);
+      }
+      std::string contents = readFile() + "xyz";
+      writeFile(contents);
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::mmap_vector<int> v(fileName);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(fileSize() == 64 + 4 * 4 + 3);
+      assertUnit(readFile() == contents);
+      std::remove(fileName);
+   }  // teardown
+
+   // moving hands over the mapping
+   void test_constructMove_standard()
+   {  // setup
+      std::remove(fileName);
+      custom::mmap_vector<int> vSrc(fileName);
+      setupStandardFixture(vSrc);
+      unsigned char * pOld = vSrc.pMap;
+      // exercise
+      custom::mmap_vector<int> vDest(std::move(vSrc));
+      // verify
+      assertUnit(vSrc.pMap == nullptr);
+      assertUnit(vDest.pMap == pOld);
+      assertStandardFixture(vDest);
+      std::remove(fileName);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // the elements can be sorted in the file
+   void test_iterator_sort()
+   {  // setup
+      std::remove(fileName);
+      custom::mmap_vector<int> v(fileName);
+      v.push_back(89);
+      v.push_back(26);
+      v.push_back(67);
+      v.push_back(49);
+      // exercise
+      std::sort(v.begin(), v.end());
+      // verify
+      assertStandardFixture(v);
+      std::remove(fileName);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push back doubles the file like vector doubles its buffer
+   void test_pushback_grow()
+   {  // setup
+      std::remove(fileName);
+      custom::mmap_vector<int> v(fileName);
+      // exercise
+      v.push_back(26);
+      v.push_back(49);
+      v.push_back(67);
+      // verify
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.size() == 3);
+      assertUnit(v[0] == 26);
+      assertUnit(v[2] == 67);
+      assertUnit(fileSize() == 64 + 4 * sizeof(int));
+      std::remove(fileName);
+   }  // teardown
+
+   // push back one of our own elements when the file has to grow
+   void test_pushback_ownElement()
+   {  // setup
+      std::remove(fileName);
+      custom::mmap_vector<int> v(fileName);
+      setupStandardFixture(v);
+      assert(v.numCapacity == v.size());   // full, so the next one moves the map
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.size() == 5);
+      assertUnit(v[3] == 89);
+      assertUnit(v[4] == 26);
+      std::remove(fileName);
+   }  // teardown
+
+   // reserve grows the file but not the size
+   void test_reserve_ten()
+   {  // setup
+      std::remove(fileName);
+      custom::mmap_vector<int> v(fileName);
+      setupStandardFixture(v);
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.size() == 4);
+      assertUnit(fileSize() == 64 + 10 * sizeof(int));
+      assertUnit(v[3] == 89);
+      std::remove(fileName);
+   }  // teardown
+
+   // resize fills the new slots
+   void test_resize_value()
+   {  // setup
+      std::remove(fileName);
+      custom::mmap_vector<int> v(fileName);
+      setupStandardFixture(v);
+      // exercise
+      v.resize(6, 99);
+      // verify
+      assertUnit(v.size() == 6);
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v[3] == 89);
+      assertUnit(v[4] == 99);
+      assertUnit(v[5] == 99);
+      std::remove(fileName);
+   }  // teardown
+
+   // fill the new slots with one of our own elements
+   void test_resize_ownElement()
+   {  // setup
+      std::remove(fileName);
+      custom::mmap_vector<int> v(fileName);
+      setupStandardFixture(v);
+      assert(v.numCapacity == v.size());   // full, so the next one moves the map
+      // exercise
+      v.resize(6, v[1]);
+      // verify
+      assertUnit(v.size() == 6);
+      assertUnit(v[4] == 49);
+      assertUnit(v[5] == 49);
+      std::remove(fileName);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // the size is kept in the file too
+   void test_popback_persist()
+   {  // setup
+      std::remove(fileName);
+      {
+         custom::mmap_vector<int> v(fileName);
+         setupStandardFixture(v);
+         // exercise
+         v.pop_back();
+      }
+      // verify
+      custom::mmap_vector<int> v(fileName);
+      assertUnit(v.size() == 3);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.back() == 67);
+      std::remove(fileName);
+   }  // teardown
+
+   // shrink truncates the file
+   void test_shrink_standard()
+   {  // setup
+      std::remove(fileName);
+      custom::mmap_vector<int> v(fileName);
+      setupStandardFixture(v);
+      v.reserve(1000);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(fileSize() == 64 + 4 * sizeof(int));
+      assertStandardFixture(v);
+      std::remove(fileName);
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *      0    1    2    3
+    *    +----+----+----+----+
+    *    | 26 | 49 | 67 | 89 |
+    *    +----+----+----+----+
+    *************************************************************/
+   void setupStandardFixture(custom::mmap_vector<int>& v)
+   {
+      v.remap(4);
+      v.data()[0] = 26;
+      v.data()[1] = 49;
+      v.data()[2] = 67;
+      v.data()[3] = 89;
+      v.header()->numElements = 4;
+   }
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE PARAMETERS
+    *      0    1    2    3
+    *    +----+----+----+----+
+    *    | 26 | 49 | 67 | 89 |
+    *    +----+----+----+----+
+    *************************************************************/
+   void assertStandardFixtureParameters(const custom::mmap_vector<int>& v, int line, const char* function)
+   {
+      assertIndirect(v.pMap != nullptr);
+      assertIndirect(v.numCapacity == 4);
+      assertIndirect(v.size() == 4);
+
+      if (v.pMap && v.size() >= 4)
+      {
+         assertIndirect(v[0] == 26);
+         assertIndirect(v[1] == 49);
+         assertIndirect(v[2] == 67);
+         assertIndirect(v[3] == 89);
+      }
+   }
+
+   // how big is the scratch file?
+   long fileSize()
+   {
+      FILE * f = std::fopen(fileName, "rb");
+      if (f == nullptr)
+         return -1;
+      std::fseek(f, 0, SEEK_END);
+      long size = std::ftell(f);
+      std::fclose(f);
+      return size;
+   }
+
+   // replace the scratch file with these bytes
+   void writeFile(const std::string & contents)
+   {
+      FILE * f = std::fopen(fileName, "wb");
+      assert(f != nullptr);
+      std::fwrite(contents.data(), 1, contents.size(), f);
+      std::fclose(f);
+   }
+
+   // every byte of the scratch file
+   std::string readFile()
+   {
+      std::string contents;
+      FILE * f = std::fopen(fileName, "rb");
+      if (f == nullptr)
+         return contents;
+      int c;
+      while ((c = std::fgetc(f)) != EOF)
+         contents += (char)c;
+      std::fclose(f);
+      return contents;
+   }
+
+   const char * fileName = "testMmapVector.tmp";
+};
+
+#endif // DEBUG
@@ -0,0 +1,566 @@
+/***********************************************************************
+ * Header:
+ *    TEST SMALL VECTOR
+ * Summary:
+ *    Unit tests for small_vector
+ * Author:
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "small_vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+
+class TestSmallVector : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_sizeFourFill();
+      test_construct_sizeSpill();
+      test_constructCopy_inline();
+      test_constructMove_inline();
+      test_constructMove_heap();
+
+      // Assign
+      test_assign_heapToInline();
+      test_swap_inlineHeap();
+
+      // Iterator
+      test_iterator_walk();
+      test_iterator_const();
+
+      // Insert
+      test_pushback_inline();
+      test_pushback_spill();
+      test_pushback_selfSpill();
+      test_reserve_inline();
+      test_insert_middleInline();
+      test_insert_middleSpill();
+      test_insert_rangeSpill();
+      test_append_input();
+      test_resize_selfSpill();
+      test_resizeDefaultInit_spill();
+      test_reserveSpare_commit();
+
+      // Remove
+      test_erase_middleHeap();
+      test_erase_middleInline();
+      test_shrink_backInline();
+      test_shrink_heap();
+
+      report("SmallVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, points at the inline buffer
+   void test_construct_default()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v;
+      // verify
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(v.data == v.inlineData());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 0);
+   }  // teardown
+
+   // four elements of 99 all fit inline
+   void test_construct_sizeFourFill()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v(4, Spy(99));
+      // verify
+      assertUnit(Spy::numCopy() == 4);       // copy-construct [99,99,99,99]
+      assertUnit(v.data == v.inlineData());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[0] == Spy(99));
+      assertUnit(v.data[3] == Spy(99));
+   }  // teardown
+
+   // more elements than slots goes to the heap
+   void test_construct_sizeSpill()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> v(6, Spy(99));
+      // verify
+      assertUnit(Spy::numCopy() == 6);       // copy-construct [99,99,99,99,99,99]
+      assertUnit(Spy::numCopyMove() == 0);   // nothing was inline to move
+      assertUnit(v.data != v.inlineData());
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+      assertUnit(v.data[5] == Spy(99));
+   }  // teardown
+
+   // copy an inline small vector
+   void test_constructCopy_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc;
+      setupStandardFixture(vSrc);
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDest(vSrc);
+      // verify
+      assertUnit(Spy::numCopy() == 4);       // copy [26,49,67,89]
+      assertUnit(Spy::numAlloc() == 4);      // allocate [26,49,67,89]
+      assertUnit(vDest.data == vDest.inlineData());
+      assertStandardFixture(vSrc);
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   // move an inline small vector: the elements must move
+   void test_constructMove_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc;
+      setupStandardFixture(vSrc);
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopyMove() == 4);   // move [26,49,67,89]
+      assertUnit(Spy::numDestructor() == 4); // destroy the moved-from slots
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(vSrc.numElements == 0);
+      assertUnit(vDest.data == vDest.inlineData());
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   // move a small vector on the heap: the buffer changes hands
+   void test_constructMove_heap()
+   {  // setup
+      custom::small_vector<Spy, 2> vSrc;
+      vSrc.push_back(Spy(26));
+      vSrc.push_back(Spy(49));
+      vSrc.push_back(Spy(67));
+      Spy * pOld = vSrc.data;
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 2> vDest(std::move(vSrc));
+      // verify
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(vDest.data == pOld);
+      assertUnit(vDest.numElements == 3);
+      assertUnit(vSrc.data == vSrc.inlineData());
+      assertUnit(vSrc.numCapacity == 2);
+      assertUnit(vSrc.numElements == 0);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // copy a heap small vector onto an inline one
+   void test_assign_heapToInline()
+   {  // setup
+      custom::small_vector<Spy, 2> vSrc;
+      vSrc.push_back(Spy(26));
+      vSrc.push_back(Spy(49));
+      vSrc.push_back(Spy(67));
+      custom::small_vector<Spy, 2> vDest;
+      vDest.push_back(Spy(99));
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(vDest.data != vDest.inlineData());
+      assertUnit(vDest.numElements == 3);
+      assertUnit(vDest.data[0] == Spy(26));
+      assertUnit(vDest.data[1] == Spy(49));
+      assertUnit(vDest.data[2] == Spy(67));
+      assertUnit(vSrc.numElements == 3);
+   }  // teardown
+
+   // swap an inline small vector with one on the heap
+   void test_swap_inlineHeap()
+   {  // setup
+      custom::small_vector<Spy, 2> vLHS;
+      vLHS.push_back(Spy(99));
+      custom::small_vector<Spy, 2> vRHS;
+      vRHS.push_back(Spy(26));
+      vRHS.push_back(Spy(49));
+      vRHS.push_back(Spy(67));
+      // exercise
+      vLHS.swap(vRHS);
+      // verify
+      assertUnit(vLHS.data != vLHS.inlineData());
+      assertUnit(vLHS.numElements == 3);
+      assertUnit(vLHS.data[0] == Spy(26));
+      assertUnit(vLHS.data[2] == Spy(67));
+      assertUnit(vRHS.data == vRHS.inlineData());
+      assertUnit(vRHS.numElements == 1);
+      assertUnit(vRHS.data[0] == Spy(99));
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk the elements with vector's iterator
+   void test_iterator_walk()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      setupStandardFixture(v);
+      custom::vector<Spy>::iterator it;
+      int sum = 0;
+      // exercise
+      for (it = v.begin(); it != v.end(); ++it)
+         sum += (*it).get();
+      // verify
+      assertUnit(sum == 26 + 49 + 67 + 89);
+      assertStandardFixture(v);
+   }  // teardown
+
+   // a const small vector can be read through const_iterator
+   void test_iterator_const()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      setupStandardFixture(v);
+      const custom::small_vector<Spy, 4> & c = v;
+      int sum = 0;
+      // exercise
+      for (custom::small_vector<Spy, 4>::const_iterator it = c.begin(); it != c.end(); ++it)
+         sum += it->get();
+      // verify
+      assertUnit(sum == 26 + 49 + 67 + 89);
+      assertUnit(c.cend() - c.cbegin() == 4);
+      assertUnit(*c.cbegin() == Spy(26));
+      assertUnit(std::accumulate(c.cbegin(), c.cend(), 0,
+         [](int total, const Spy & s) { return total + s.get(); }) == sum);
+      assertStandardFixture(v);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push back while there is room inline
+   void test_pushback_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      // exercise
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      v.push_back(Spy(67));
+      v.push_back(Spy(89));
+      // verify
+      assertStandardFixture(v);
+   }  // teardown
+
+   // the fifth push back spills to the heap
+   void test_pushback_spill()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      setupStandardFixture(v);
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      v.push_back(s);
+      // verify
+      assertUnit(Spy::numCopyMove() == 4);   // move [26,49,67,89] to the heap
+      assertUnit(Spy::numDestructor() == 4); // destroy the inline slots
+      assertUnit(Spy::numCopy() == 1);       // copy 99
+      assertUnit(v.data != v.inlineData());
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == Spy(26));
+      assertUnit(v.data[4] == Spy(99));
+   }  // teardown
+
+   // pushing one of our own elements as we spill copies it before the move
+   void test_pushback_selfSpill()
+   {  // setup
+      custom::small_vector<std::string, 4> v;
+      v.push_back("twenty six");
+      v.push_back("forty nine");
+      v.push_back("sixty seven");
+      v.push_back("eighty nine");
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.data != v.inlineData());
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == "twenty six");
+      assertUnit(v.data[4] == "twenty six");
+   }  // teardown
+
+   // reserving no more than N does not allocate
+   void test_reserve_inline()
+   {  // setup
+      custom::small_vector<int, 8> v;
+      // exercise
+      v.reserve(8);
+      // verify
+      assertUnit(v.data == v.inlineData());
+      assertUnit(v.numCapacity == 8);
+   }  // teardown
+
+   // insert in the middle while there is still room inline
+   void test_insert_middleInline()
+   {  // setup
+      custom::small_vector<int, 8> v{ 26, 49, 89 };
+      // exercise
+      custom::small_vector<int, 8>::iterator it = v.insert(v.begin() + 2, 1, 67);
+      // verify
+      assertUnit(it == v.begin() + 2);
+      assertUnit(v.data == v.inlineData());
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 49);
+      assertUnit(v.data[2] == 67);
+      assertUnit(v.data[3] == 89);
+   }  // teardown
+
+   // insert in the middle of a full inline buffer: every element moves once
+   void test_insert_middleSpill()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::small_vector<Spy, 4> v;
+      setupStandardFixture(v);
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4>::iterator it = v.insert(v.begin() + 1, 2, s);
+      // verify
+      assertUnit(Spy::numCopyMove() == 4);   // move [26,49,67,89] to the heap
+      assertUnit(Spy::numDestructor() == 4); // destroy the inline slots
+      assertUnit(Spy::numCopy() == 2);       // copy [99,99] in
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 | 99 | 99 | 49 | 67 | 89 |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(it == v.begin() + 1);
+      assertUnit(v.data != v.inlineData());
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 6);
+      assertUnit(v.data[0] == Spy(26));
+      assertUnit(v.data[1] == Spy(99));
+      assertUnit(v.data[2] == Spy(99));
+      assertUnit(v.data[3] == Spy(49));
+      assertUnit(v.data[4] == Spy(67));
+      assertUnit(v.data[5] == Spy(89));
+   }  // teardown
+
+   // insert a range that no longer fits inline
+   void test_insert_rangeSpill()
+   {  // setup
+      custom::small_vector<int, 4> v{ 26, 89 };
+      custom::vector<int> source{ 49, 67, 77 };
+      // exercise
+      v.insert(v.begin() + 1, source.cbegin(), source.cend());
+      // verify
+      assertUnit(v.data != v.inlineData());
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 49);
+      assertUnit(v.data[2] == 67);
+      assertUnit(v.data[3] == 77);
+      assertUnit(v.data[4] == 89);
+   }  // teardown
+
+   // append from a stream, which can only be read once
+   void test_append_input()
+   {  // setup
+      custom::small_vector<int, 2> v{ 26 };
+      std::istringstream in("49 67 89");
+      // exercise
+      v.append(std::istream_iterator<int>(in), std::istream_iterator<int>());
+      // verify
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 49);
+      assertUnit(v.data[2] == 67);
+      assertUnit(v.data[3] == 89);
+   }  // teardown
+
+   // resizing past N with one of our own elements copies it before the move
+   void test_resize_selfSpill()
+   {  // setup
+      custom::small_vector<std::string, 4> v;
+      v.push_back("twenty six");
+      v.push_back("forty nine");
+      v.push_back("sixty seven");
+      // exercise
+      v.resize(6, v[0]);
+      // verify
+      assertUnit(v.data != v.inlineData());
+      assertUnit(v.numElements == 6);
+      assertUnit(v.data[0] == "twenty six");
+      assertUnit(v.data[3] == "twenty six");
+      assertUnit(v.data[5] == "twenty six");
+   }  // teardown
+
+   // default-initialized growth spills to the heap
+   void test_resizeDefaultInit_spill()
+   {  // setup
+      custom::small_vector<int, 4> v{ 26, 49 };
+      // exercise
+      v.resize_default_init(6);
+      // verify
+      assertUnit(v.data != v.inlineData());
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 6);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 49);
+   }  // teardown
+
+   // a producer writes into the spare capacity and then commits it
+   void test_reserveSpare_commit()
+   {  // setup
+      custom::small_vector<int, 4> v{ 26, 49 };
+      // exercise
+      int * p = v.reserve_spare(2);
+      p[0] = 67;
+      p[1] = 89;
+      v.commit(2);
+      // verify
+      assertUnit(v.data == v.inlineData());
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[2] == 67);
+      assertUnit(v.data[3] == 89);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase from the middle of a vector that has spilled to the heap
+   void test_erase_middleHeap()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      setupStandardFixture(v);
+      v.push_back(Spy(99));
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4>::iterator it = v.erase(v.begin() + 1, v.begin() + 3);
+      // verify
+      assertUnit(Spy::numDestructor() == 4); // [49,67] and the moved-from [89,99]
+      assertUnit(Spy::numCopyMove() == 2);   // slide [89,99] down
+      //      0    1    2
+      //    +----+----+----+
+      //    | 26 | 89 | 99 |
+      //    +----+----+----+
+      assertUnit(it == v.begin() + 1);
+      assertUnit(v.data != v.inlineData());
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 3);
+      assertUnit(v.data[0] == Spy(26));
+      assertUnit(v.data[1] == Spy(89));
+      assertUnit(v.data[2] == Spy(99));
+   }  // teardown
+
+   // erase from the middle of the inline buffer
+   void test_erase_middleInline()
+   {  // setup
+      custom::small_vector<int, 4> v{ 26, 49, 67, 89 };
+      // exercise
+      v.erase(v.begin() + 1, v.begin() + 2);
+      // verify
+      assertUnit(v.data == v.inlineData());
+      assertUnit(v.numElements == 3);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 67);
+      assertUnit(v.data[2] == 89);
+   }  // teardown
+
+   // shrinking to N or fewer moves back inside
+   void test_shrink_backInline()
+   {  // setup
+      custom::small_vector<int, 4> v{ 26, 49, 67, 89, 99 };
+      v.pop_back();
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.data == v.inlineData());
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[1] == 49);
+      assertUnit(v.data[2] == 67);
+      assertUnit(v.data[3] == 89);
+   }  // teardown
+
+   // shrinking with more than N stays on the heap
+   void test_shrink_heap()
+   {  // setup
+      custom::small_vector<int, 2> v{ 26, 49, 67 };
+      v.reserve(10);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.data != v.inlineData());
+      assertUnit(v.numCapacity == 3);
+      assertUnit(v.numElements == 3);
+      assertUnit(v.data[0] == 26);
+      assertUnit(v.data[2] == 67);
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *      0    1    2    3
+    *    +----+----+----+----+
+    *    | 26 | 49 | 67 | 89 |
+    *    +----+----+----+----+
+    *************************************************************/
+   void setupStandardFixture(custom::small_vector<Spy, 4>& v)
+   {
+      v.alloc.construct(&v.data[0], Spy(26));
+      v.alloc.construct(&v.data[1], Spy(49));
+      v.alloc.construct(&v.data[2], Spy(67));
+      v.alloc.construct(&v.data[3], Spy(89));
+      v.numElements = 4;
+   }
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE PARAMETERS
+    *      0    1    2    3
+    *    +----+----+----+----+
+    *    | 26 | 49 | 67 | 89 |
+    *    +----+----+----+----+
+    *************************************************************/
+   void assertStandardFixtureParameters(const custom::small_vector<Spy, 4>& v, int line, const char* function)
+   {
+      assertIndirect(v.data == v.inlineData());
+      assertIndirect(v.numCapacity == 4);
+      assertIndirect(v.numElements == 4);
+
+      if (v.numElements >= 4)
+      {
+         assertIndirect(v.data[0] == Spy(26));
+         assertIndirect(v.data[1] == Spy(49));
+         assertIndirect(v.data[2] == Spy(67));
+         assertIndirect(v.data[3] == Spy(89));
+      }
+   }
+
+};
+
+#endif // DEBUG
@@ -0,0 +1,343 @@
+/***********************************************************************
+ * Header:
+ *    TEST SOA VECTOR
+ * Summary:
+ *    Unit tests for soa_vector
+ * Author:
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "soa_vector.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <tuple>
+#include <algorithm>
+
+class TestSoaVector : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_size();
+
+      // Access
+      test_subscript_read();
+      test_subscript_write();
+      test_column_sum();
+      test_column_write();
+
+      // Iterator
+      test_iterator_walk();
+      test_iterator_compare();
+      test_iterator_sort();
+      test_iterator_const();
+
+      // Insert
+      test_pushback_tuple();
+      test_reserve_everyColumn();
+
+      // Remove
+      test_popback_everyColumn();
+      test_clear_everyColumn();
+
+      report("SoaVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // no rows, no columns allocated
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::soa_vector<int, double> v;
+      // verify
+      assertUnit(v.size() == 0);
+      assertUnit(v.empty());
+      assertUnit(std::get<0>(v.columns).capacity() == 0);
+      assertUnit(std::get<1>(v.columns).capacity() == 0);
+   }  // teardown
+
+   // every column gets the same number of rows
+   void test_construct_size()
+   {  // setup
+      // exercise
+      custom::soa_vector<int, double, char> v(4);
+      // verify
+      assertUnit(v.size() == 4);
+      assertUnit(std::get<0>(v.columns).size() == 4);
+      assertUnit(std::get<1>(v.columns).size() == 4);
+      assertUnit(std::get<2>(v.columns).size() == 4);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // a row is a tuple of references into the columns
+   void test_subscript_read()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      setupStandardFixture(v);
+      // exercise
+      int key;
+      double value;
+      std::tie(key, value) = v[2];
+      // verify
+      assertUnit(key == 67);
+      assertUnit(value == 6.7);
+      assertStandardFixture(v);
+   }  // teardown
+
+   // writing through a row changes the column
+   void test_subscript_write()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      setupStandardFixture(v);
+      // exercise
+      std::get<1>(v[1]) = 9.9;
+      // verify
+      assertUnit(std::get<1>(v.columns)[1] == 9.9);
+      assertUnit(std::get<0>(v.columns)[1] == 49);
+   }  // teardown
+
+   // a column is one contiguous array
+   void test_column_sum()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::span<int> keys = v.column<0>();
+      int sum = 0;
+      for (int key : keys)
+         sum += key;
+      // verify
+      assertUnit(keys.size() == 4);
+      assertUnit(keys.data() == &std::get<0>(v.columns)[0]);
+      assertUnit(sum == 26 + 49 + 67 + 89);
+   }  // teardown
+
+   // change one field of every row through its column
+   void test_column_write()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::span<double> values = v.column<1>();
+      for (size_t i = 0; i < values.size(); i++)
+         values[i] *= 10.0;
+      // verify
+      assertUnit(std::get<1>(v[0]) == 26.0);
+      assertUnit(std::get<1>(v[3]) == 89.0);
+      assertUnit(std::get<0>(v[3]) == 89);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk the rows with a range-based for loop
+   void test_iterator_walk()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      setupStandardFixture(v);
+      int sumKeys = 0;
+      // exercise
+      for (auto row : v)
+      {
+         sumKeys += std::get<0>(row);
+         std::get<1>(row) = 0.0;
+      }
+      // verify
+      assertUnit(sumKeys == 26 + 49 + 67 + 89);
+      assertUnit(std::get<1>(v.columns)[0] == 0.0);
+      assertUnit(std::get<1>(v.columns)[3] == 0.0);
+      assertUnit(v.end() - v.begin() == 4);
+   }  // teardown
+
+   // every comparison, and arithmetic from either side
+   void test_iterator_compare()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      setupStandardFixture(v);
+      // exercise
+      auto itFirst = v.begin();
+      auto itThird = 2 + v.begin();
+      // verify
+      assertUnit(itThird == v.begin() + 2);
+      assertUnit(itFirst < itThird);
+      assertUnit(itThird > itFirst);
+      assertUnit(itFirst <= itThird);
+      assertUnit(itFirst <= itFirst);
+      assertUnit(itThird >= itFirst);
+      assertUnit(itThird >= itThird);
+      assertUnit(!(itFirst > itThird));
+      assertUnit(std::get<0>(*itThird) == 67);
+   }  // teardown
+
+   // std::sort moves whole rows, by the tuple or by one field
+   void test_iterator_sort()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      v.push_back(67, 6.7);
+      v.push_back(26, 2.6);
+      v.push_back(89, 8.9);
+      v.push_back(49, 4.9);
+      // exercise
+      std::sort(v.begin(), v.end());
+      // verify
+      assertStandardFixture(v);
+      assertUnit(std::get<1>(v[0]) == 2.6);
+      assertUnit(std::get<1>(v[3]) == 8.9);
+      // exercise
+      std::sort(v.begin(), v.end(),
+                [](const std::tuple<int, double> & lhs, const std::tuple<int, double> & rhs)
+                { return std::get<1>(lhs) > std::get<1>(rhs); });
+      // verify
+      assertUnit(std::get<0>(v[0]) == 89);
+      assertUnit(std::get<0>(v[1]) == 67);
+      assertUnit(std::get<0>(v[2]) == 49);
+      assertUnit(std::get<0>(v[3]) == 26);
+      assertUnit(std::get<1>(v[3]) == 2.6);
+   }  // teardown
+
+   // a const soa_vector is walked with const_iterator
+   void test_iterator_const()
+   {  // setup
+      typedef custom::soa_vector<int, double>::const_iterator const_iterator;
+      custom::soa_vector<int, double> v;
+      setupStandardFixture(v);
+      const custom::soa_vector<int, double> & c = v;
+      int sumKeys = 0;
+      // exercise
+      for (const_iterator it = c.begin(); it != c.end(); ++it)
+         sumKeys += std::get<0>(*it);
+      const_iterator itFound =
+         std::find_if(c.cbegin(), c.cend(),
+                      [](const std::tuple<int, double> & row) { return std::get<0>(row) == 67; });
+      // verify
+      assertUnit(sumKeys == 26 + 49 + 67 + 89);
+      assertUnit(c.cend() - c.cbegin() == 4);
+      assertUnit(itFound - c.begin() == 2);
+      assertUnit(std::get<1>(itFound[1]) == std::get<1>(v[3]));
+      assertUnit(const_iterator(v.begin()) == c.begin());
+      assertStandardFixture(v);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push back a whole record as a tuple
+   void test_pushback_tuple()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      // exercise
+      v.push_back(std::make_tuple(26, 2.6));
+      v.push_back(49, 4.9);
+      // verify
+      assertUnit(v.size() == 2);
+      assertUnit(std::get<0>(v.front()) == 26);
+      assertUnit(std::get<1>(v.back()) == 4.9);
+   }  // teardown
+
+   // reserve reaches every column
+   void test_reserve_everyColumn()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      setupStandardFixture(v);
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(v.capacity() == 10);
+      assertUnit(std::get<0>(v.columns).capacity() == 10);
+      assertUnit(std::get<1>(v.columns).capacity() == 10);
+      assertUnit(v.size() == 4);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop back shortens every column
+   void test_popback_everyColumn()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      setupStandardFixture(v);
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(std::get<0>(v.columns).size() == 3);
+      assertUnit(std::get<1>(v.columns).size() == 3);
+      assertUnit(std::get<1>(v.back()) == 6.7);
+   }  // teardown
+
+   // clear empties every column
+   void test_clear_everyColumn()
+   {  // setup
+      custom::soa_vector<int, double> v;
+      setupStandardFixture(v);
+      // exercise
+      v.clear();
+      // verify
+      assertUnit(v.empty());
+      assertUnit(std::get<1>(v.columns).size() == 0);
+      assertUnit(v.column<1>().empty());
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *      0    1    2    3
+    *    +----+----+----+----+
+    *    | 26 | 49 | 67 | 89 |
+    *    +----+----+----+----+
+    *    | 2.6| 4.9| 6.7| 8.9|
+    *    +----+----+----+----+
+    *************************************************************/
+   void setupStandardFixture(custom::soa_vector<int, double>& v)
+   {
+      v.push_back(26, 2.6);
+      v.push_back(49, 4.9);
+      v.push_back(67, 6.7);
+      v.push_back(89, 8.9);
+   }
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE PARAMETERS
+    *      0    1    2    3
+    *    +----+----+----+----+
+    *    | 26 | 49 | 67 | 89 |
+    *    +----+----+----+----+
+    *    | 2.6| 4.9| 6.7| 8.9|
+    *    +----+----+----+----+
+    *************************************************************/
+   void assertStandardFixtureParameters(const custom::soa_vector<int, double>& v, int line, const char* function)
+   {
+      assertIndirect(v.size() == 4);
+      assertIndirect(std::get<1>(v.columns).size() == 4);
+
+      if (v.size() >= 4)
+      {
+         assertIndirect(std::get<0>(v[0]) == 26);
+         assertIndirect(std::get<0>(v[3]) == 89);
+         assertIndirect(std::get<1>(v[0]) == 2.6);
+         assertIndirect(std::get<1>(v[3]) == 8.9);
+      }
+   }
+};
+
+#endif // DEBUG
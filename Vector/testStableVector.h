@@ -0,0 +1,314 @@
+/***********************************************************************
+ * Header:
+ *    TEST STABLE VECTOR
+ * Summary:
+ *    Unit tests for stable_vector
+ * Author:
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "stable_vector.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <cassert>
+#include <algorithm>
+#include <iterator>
+
+class TestStableVector : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_sizeFill();
+      test_constructCopy_standard();
+      test_constructMove_standard();
+
+      // Access
+      test_subscript_acrossBlocks();
+
+      // Iterator
+      test_iterator_sort();
+      test_constIterator_lowerBound();
+
+      // Insert
+      test_pushback_noRelocate();
+      test_pushback_pointersStable();
+      test_reserve_wholeBlocks();
+      test_resize_shrinkGrow();
+
+      // Remove
+      test_popback_standard();
+      test_shrink_freeBlocks();
+
+      report("StableVector");
+   }
+
+   /***************************************
+    * CONSTRUCTOR
+    ***************************************/
+
+   // default constructor, no blocks
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::stable_vector<int, 4> v;
+      // verify
+      assertUnit(v.numElements == 0);
+      assertUnit(v.blocks.size() == 0);
+      assertUnit(v.capacity() == 0);
+   }  // teardown
+
+   // six copies of 99 take two blocks of four
+   void test_construct_sizeFill()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::stable_vector<Spy, 4> v(6, Spy(99));
+      // verify
+      assertUnit(Spy::numCopy() == 6);       // copy-construct 99 six times
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.numElements == 6);
+      assertUnit(v.blocks.size() == 2);
+      assertUnit(v[0] == Spy(99));
+      assertUnit(v[5] == Spy(99));
+   }  // teardown
+
+   // copy gets its own blocks
+   void test_constructCopy_standard()
+   {  // setup
+      custom::stable_vector<int, 4> vSrc;
+      setupStandardFixture(vSrc);
+      // exercise
+      custom::stable_vector<int, 4> vDest(vSrc);
+      // verify
+      assertUnit(vDest.blocks[0] != vSrc.blocks[0]);
+      assertStandardFixture(vSrc);
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   // move takes the blocks, so the elements do not move
+   void test_constructMove_standard()
+   {  // setup
+      custom::stable_vector<int, 4> vSrc;
+      setupStandardFixture(vSrc);
+      int * pFirst = &vSrc[0];
+      // exercise
+      custom::stable_vector<int, 4> vDest(std::move(vSrc));
+      // verify
+      assertUnit(vSrc.numElements == 0);
+      assertUnit(vSrc.blocks.size() == 0);
+      assertUnit(&vDest[0] == pFirst);
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // index into the second and third blocks
+   void test_subscript_acrossBlocks()
+   {  // setup
+      custom::stable_vector<int, 4> v;
+      setupStandardFixture(v);
+      // exercise
+      v[5] = 11;
+      v[8] = 33;
+      // verify
+      assertUnit(v.blocks[1][1] == 11);
+      assertUnit(v.blocks[2][0] == 33);
+      assertUnit(v[4] == 99);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // std::sort works across the blocks
+   void test_iterator_sort()
+   {  // setup
+      custom::stable_vector<int, 4> v{ 89, 11, 67, 99, 26, 88, 49, 33, 77 };
+      // exercise
+      std::sort(v.begin(), v.end());
+      // verify
+      assertUnit(v[0] == 11);
+      assertUnit(v[3] == 49);
+      assertUnit(v[4] == 67);
+      assertUnit(v[8] == 99);
+      assertUnit(v.end() - v.begin() == 9);
+   }  // teardown
+
+   // a const_iterator does everything a random-access iterator should
+   void test_constIterator_lowerBound()
+   {  // setup
+      const custom::stable_vector<int, 4> v{ 11, 26, 33, 49, 67, 77, 88, 89, 99 };
+      // exercise
+      custom::stable_vector<int, 4>::const_iterator it = std::lower_bound(v.begin(), v.end(), 67);
+      // verify
+      assertUnit(it - v.begin() == 4);
+      assertUnit(*it == 67);
+      assertUnit(std::binary_search(v.cbegin(), v.cend(), 88));
+      assertUnit(!std::binary_search(v.cbegin(), v.cend(), 50));
+      assertUnit(*(it - 2) == 33);
+      assertUnit(*(3 + it) == 89);
+      assertUnit(it > v.begin());
+      assertUnit(it >= v.begin());
+      assertUnit(it <= it);
+      assertUnit(v.begin() <= it);
+      assertUnit(!(v.end() <= it));
+      it -= 4;
+      assertUnit(it == v.begin());
+      assertUnit(*std::prev(v.end()) == 99);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // filling a block and starting the next moves nothing
+   void test_pushback_noRelocate()
+   {  // setup
+      custom::stable_vector<Spy, 4> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      v.push_back(Spy(67));
+      v.push_back(Spy(89));
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      v.push_back(s);
+      // verify
+      assertUnit(Spy::numCopy() == 1);       // copy 99
+      assertUnit(Spy::numCopyMove() == 0);   // [26,49,67,89] stay where they are
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(v.blocks.size() == 2);
+      assertUnit(v.numElements == 5);
+      assertUnit(v[4] == Spy(99));
+   }  // teardown
+
+   // a pointer to the first element survives a lot of growth
+   void test_pushback_pointersStable()
+   {  // setup
+      custom::stable_vector<int, 4> v;
+      v.push_back(26);
+      int * pFirst = &v[0];
+      // exercise
+      for (int i = 1; i < 1000; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(&v[0] == pFirst);
+      assertUnit(*pFirst == 26);
+      assertUnit(v.blocks.size() == 250);
+      assertUnit(v[999] == 999);
+   }  // teardown
+
+   // reserve adds whole blocks
+   void test_reserve_wholeBlocks()
+   {  // setup
+      custom::stable_vector<int, 4> v;
+      setupStandardFixture(v);
+      // exercise
+      v.reserve(14);
+      // verify
+      assertUnit(v.blocks.size() == 4);
+      assertUnit(v.capacity() == 16);
+      assertStandardFixture(v);
+   }  // teardown
+
+   // shrink then grow again with a value
+   void test_resize_shrinkGrow()
+   {  // setup
+      custom::stable_vector<int, 4> v;
+      setupStandardFixture(v);
+      // exercise
+      v.resize(2);
+      v.resize(6, 11);
+      // verify
+      assertUnit(v.numElements == 6);
+      assertUnit(v[0] == 26);
+      assertUnit(v[1] == 49);
+      assertUnit(v[2] == 11);
+      assertUnit(v[5] == 11);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // pop back destroys one element and keeps the block
+   void test_popback_standard()
+   {  // setup
+      custom::stable_vector<int, 4> v;
+      setupStandardFixture(v);
+      // exercise
+      v.pop_back();
+      // verify
+      assertUnit(v.numElements == 8);
+      assertUnit(v.blocks.size() == 3);
+      assertUnit(v.back() == 77);
+   }  // teardown
+
+   // blocks past the end are returned
+   void test_shrink_freeBlocks()
+   {  // setup
+      custom::stable_vector<int, 4> v;
+      setupStandardFixture(v);
+      v.reserve(40);
+      v.resize(5);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.blocks.size() == 2);
+      assertUnit(v.numElements == 5);
+      assertUnit(v[4] == 99);
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *      0    1    2    3     4    5    6    7     8
+    *    +----+----+----+----+----+----+----+----+----+
+    *    | 26 | 49 | 67 | 89 | 99 | 88 | 33 | 77 | 11 |
+    *    +----+----+----+----+----+----+----+----+----+
+    *     block 0             block 1             block 2
+    *************************************************************/
+   void setupStandardFixture(custom::stable_vector<int, 4>& v)
+   {
+      int values[] = { 26, 49, 67, 89, 99, 88, 33, 77, 11 };
+      for (int value : values)
+         v.push_back(value);
+   }
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE PARAMETERS
+    *      0    1    2    3     4    5    6    7     8
+    *    +----+----+----+----+----+----+----+----+----+
+    *    | 26 | 49 | 67 | 89 | 99 | 88 | 33 | 77 | 11 |
+    *    +----+----+----+----+----+----+----+----+----+
+    *************************************************************/
+   void assertStandardFixtureParameters(const custom::stable_vector<int, 4>& v, int line, const char* function)
+   {
+      assertIndirect(v.numElements == 9);
+      assertIndirect(v.blocks.size() >= 3);
+
+      if (v.numElements >= 9)
+      {
+         assertIndirect(v[0] == 26);
+         assertIndirect(v[3] == 89);
+         assertIndirect(v[4] == 99);
+         assertIndirect(v[8] == 11);
+      }
+   }
+};
+
+#endif // DEBUG
@@ -11,8 +11,15 @@
 #define DEBUG   
 #endif
  //#undef DEBUG  // Remove this comment to disable unit tests
+//#define BENCHMARK  // Remove this comment to time the SIMD kernels
 
 #include "testVector.h"     // for the vector unit tests
+#include "testSmallVector.h" // for the small vector unit tests
+#include "testVectorSimd.h" // for the SIMD kernel unit tests
+#include "testMmapVector.h" // for the file-backed vector unit tests
+#include "testSoaVector.h"  // for the structure-of-arrays unit tests
+#include "testStableVector.h" // for the segmented vector unit tests
+#include "benchVectorSimd.h" // for the SIMD kernel benchmark
 #include "testSpy.h"        // for the spy unit tests
 int Spy::counters[] = {};
 
@@ -27,7 +34,16 @@ int main()
    // unit tests
    TestSpy().run();
    TestVector().run();
+   TestSmallVector().run();
+   TestVectorSimd().run();
+   TestMmapVector().run();
+   TestSoaVector().run();
+   TestStableVector().run();
 #endif // DEBUG
+
+#ifdef BENCHMARK
+   BenchVectorSimd().run();
+#endif // BENCHMARK
    
    return 0;
 }
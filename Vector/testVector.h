@@ -13,11 +13,18 @@
 
 #include <vector>
 #include "vector.h"
+#include "mmap_allocator.h"
 #include "unitTest.h"
 #include "spy.h"
 
 #include <cassert>
 #include <memory>
+#include <algorithm>
+#include <iterator>
+#include <atomic>
+#include <stdexcept>
+#include <sstream>
+#include <string>
 
 class TestVector : public UnitTest
 {
@@ -59,6 +66,10 @@ public:
       test_swap_sameSize();
       test_swap_rightBigger();
       test_swap_leftBigger();
+      test_adopt_raw();
+      test_adopt_replace();
+      test_release_standard();
+      test_release_adoptRoundTrip();
 
       // Iterator
       test_iterator_beginEmpty();
@@ -74,6 +85,12 @@ public:
       test_iterator_equals_different();
       test_iterator_notEquals_same();
       test_iterator_notEquals_different();
+      test_iterator_arithmetic();
+      test_iterator_compare();
+      test_iterator_traits();
+      test_iterator_sort();
+      test_constIterator_read();
+      test_constIterator_mixed();
 
       // Access
       test_subscript_read();
@@ -91,12 +108,18 @@ public:
       test_pushback_moveEmpty();
       test_pushback_moveExcessCapacity();
       test_pushback_moveRequireReallocate();
+      test_pushback_selfReallocate();
       test_resize_emptyZero();
       test_resize_emptyFourDefault();
       test_resize_emptyFourValue();
       test_resize_fourZero();
       test_resize_fourSixDefault();
       test_resize_fourSixValue();
+      test_resize_selfReallocate();
+      test_resizeDefaultInit_fourSix();
+      test_resizeDefaultInit_trivial();
+      test_resizeDefaultInit_growsGeometrically();
+      test_reserveSpare_commit();
       test_reserve_emptyZero();
       test_reserve_emptyTen();
       test_reserve_fourZero();
@@ -104,6 +127,16 @@ public:
       test_reserve_fourTen();
       test_reserve_standardZero();
       test_reserve_standardTen();
+      test_reserve_relocatable();
+      test_reserve_mapped();
+      test_insert_valueMiddle();
+      test_insert_valueRequireReallocate();
+      test_insert_valueInt();
+      test_insert_rangeMiddle();
+      test_insert_rangeRequireReallocate();
+      test_insert_rangeInput();
+      test_append_empty();
+      test_append_input();
 
       // Remove
       test_popback_empty();
@@ -112,10 +145,27 @@ public:
       test_clear_empty();
       test_clear_full();
       test_clear_partiallyFilled();
+      test_erase_middle();
+      test_erase_all();
+      test_erase_relocatable();
       test_shrink_empty();
       test_shrink_toEmpty();
       test_shrink_standard();
       test_shrink_twoExtraSlots();
+      test_shrink_relocatable();
+      test_shrink_mapped();
+
+      // Bulk update
+      test_construct_fillParallel();
+      test_constructCopy_parallel();
+      test_assign_parallelGrow();
+      test_fill_standard();
+      test_fill_parallel();
+      test_transform_parallel();
+      test_transform_fromParallel();
+      test_transform_fromSerial();
+      test_threadPool_everyIndex();
+      test_threadPool_exception();
       
       // Status
       test_size_empty();
@@ -971,6 +1021,448 @@ public:
       teardownStandardFixture(v);
    }
    
+   // reserve ten when the elements can be relocated as bytes
+   void test_reserve_relocatable()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      v.data = v.alloc.allocate(4);
+      v.data[0] = 26;
+      v.data[1] = 49;
+      v.data[2] = 67;
+      v.data[3] = 89;
+      v.numElements = 4;
+      v.numCapacity = 4;
+      int * pOld = v.data;
+      // exercise
+      v.reserve(10);
+      // verify
+      //      0    1    2    3    4    5    6    7    8    9
+      //    +----+----+----+----+----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |    |    |    |    |    |    |
+      //    +----+----+----+----+----+----+----+----+----+----+
+      assertUnit(custom::is_trivially_relocatable<int>::value);
+      assertUnit(!custom::is_trivially_relocatable<Spy>::value);
+      assertUnit(v.data != pOld);
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.numElements == 4);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+         assertUnit(v.data[2] == 67);
+         assertUnit(v.data[3] == 89);
+      }
+   }  // teardown
+   
+   // reserve through an allocator that can resize the buffer itself
+   void test_reserve_mapped()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int, custom::mmap_allocator<int, 64>> v;
+      v.data = v.alloc.allocate(4);
+      v.data[0] = 26;
+      v.data[1] = 49;
+      v.data[2] = 67;
+      v.data[3] = 89;
+      v.numElements = 4;
+      v.numCapacity = 4;
+      // exercise
+      v.reserve(100);      // heap to mapped pages
+      v.reserve(100000);   // mapped pages grown in place
+      // verify
+      //      0    1    2    3    4         99999
+      //    +----+----+----+----+----+ ... +----+
+      //    | 26 | 49 | 67 | 89 |    |     |    |
+      //    +----+----+----+----+----+ ... +----+
+      assertUnit((custom::has_reallocate<custom::mmap_allocator<int, 64>>::value));
+      assertUnit(!custom::has_reallocate<std::allocator<int>>::value);
+      assertUnit(v.numCapacity == 100000);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data != nullptr);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+         assertUnit(v.data[2] == 67);
+         assertUnit(v.data[3] == 89);
+         v.data[99999] = 99;
+      }
+   }  // teardown
+   
+   // insert two copies in the middle when there is room
+   void test_insert_valueMiddle()
+   {  // setup
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |    |    |
+      //    +----+----+----+----+----+----+
+      custom::vector<Spy> v;
+      v.data = v.alloc.allocate(6);
+      v.alloc.construct(&v.data[0], Spy(26));
+      v.alloc.construct(&v.data[1], Spy(49));
+      v.alloc.construct(&v.data[2], Spy(67));
+      v.alloc.construct(&v.data[3], Spy(89));
+      v.numElements = 4;
+      v.numCapacity = 6;
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      custom::vector<Spy>::iterator it = v.insert(custom::vector<Spy>::iterator(v.data + 2), 2, s);
+      // verify
+      assertUnit(Spy::numCopyMove() == 2);   // shift [67,89] over two
+      assertUnit(Spy::numDestructor() == 2); // destroy the old [67,89] slots
+      assertUnit(Spy::numCopy() == 2);       // copy [99,99] in
+      assertUnit(Spy::numAlloc() == 2);      // allocate [99,99]
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 49 | 99 | 99 | 67 | 89 |
+      //    +----+----+----+----+----+----+
+      assertUnit(it.p == v.data + 2);
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == Spy(26));
+         assertUnit(v.data[1] == Spy(49));
+         assertUnit(v.data[2] == Spy(99));
+         assertUnit(v.data[3] == Spy(99));
+         assertUnit(v.data[4] == Spy(67));
+         assertUnit(v.data[5] == Spy(89));
+      }
+   }  // teardown
+
+   // insert a copy of one of our own elements, forcing a new buffer
+   void test_insert_valueRequireReallocate()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      // exercise
+      v.insert(custom::vector<Spy>::iterator(v.data + 1), 1, v.data[3]);
+      // verify
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 | 89 | 49 | 67 | 89 |    |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == Spy(26));
+         assertUnit(v.data[1] == Spy(89));
+         assertUnit(v.data[2] == Spy(49));
+         assertUnit(v.data[3] == Spy(67));
+         assertUnit(v.data[4] == Spy(89));
+      }
+   }  // teardown
+
+   // a count and a value of int are not taken for a range
+   void test_insert_valueInt()
+   {  // setup
+      custom::vector<int> v;
+      v.push_back(26);
+      v.push_back(49);
+      // exercise
+      custom::vector<int>::iterator it = v.insert(v.begin() + 1, 3, 5);
+      // verify
+      //      0    1    2    3    4
+      //    +----+----+----+----+----+
+      //    | 26 |  5 |  5 |  5 | 49 |
+      //    +----+----+----+----+----+
+      assertUnit(it.p == v.data + 1);
+      assertUnit(v.numElements == 5);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 5);
+         assertUnit(v.data[2] == 5);
+         assertUnit(v.data[3] == 5);
+         assertUnit(v.data[4] == 49);
+      }
+   }  // teardown
+
+   // insert a range in the middle when there is room
+   void test_insert_rangeMiddle()
+   {  // setup
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |    |    |
+      //    +----+----+----+----+----+----+
+      custom::vector<Spy> v;
+      v.data = v.alloc.allocate(6);
+      v.alloc.construct(&v.data[0], Spy(26));
+      v.alloc.construct(&v.data[1], Spy(49));
+      v.alloc.construct(&v.data[2], Spy(67));
+      v.alloc.construct(&v.data[3], Spy(89));
+      v.numElements = 4;
+      v.numCapacity = 6;
+      std::vector<Spy> source{ Spy(11), Spy(22) };
+      Spy::reset();
+      // exercise
+      v.insert(custom::vector<Spy>::iterator(v.data + 1), source.begin(), source.end());
+      // verify
+      assertUnit(Spy::numCopyMove() == 3);   // shift [49,67,89] over two
+      assertUnit(Spy::numDestructor() == 3); // destroy the old [49,67,89] slots
+      assertUnit(Spy::numCopy() == 2);       // copy [11,22] in
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 11 | 22 | 49 | 67 | 89 |
+      //    +----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == Spy(26));
+         assertUnit(v.data[1] == Spy(11));
+         assertUnit(v.data[2] == Spy(22));
+         assertUnit(v.data[3] == Spy(49));
+         assertUnit(v.data[4] == Spy(67));
+         assertUnit(v.data[5] == Spy(89));
+      }
+   }  // teardown
+
+   // insert a range that needs a bigger buffer: every element moves once
+   void test_insert_rangeRequireReallocate()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      std::vector<Spy> source{ Spy(11), Spy(22), Spy(33), Spy(44), Spy(55) };
+      Spy::reset();
+      // exercise
+      v.insert(custom::vector<Spy>::iterator(v.data + 2), source.begin(), source.end());
+      // verify
+      assertUnit(Spy::numCopyMove() == 4);   // move [26,49,67,89] once
+      assertUnit(Spy::numDestructor() == 4); // destroy the old [26,49,67,89]
+      assertUnit(Spy::numCopy() == 5);       // copy [11,22,33,44,55] in
+      //      0    1    2    3    4    5    6    7    8
+      //    +----+----+----+----+----+----+----+----+----+
+      //    | 26 | 49 | 11 | 22 | 33 | 44 | 55 | 67 | 89 |
+      //    +----+----+----+----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 9);
+      assertUnit(v.numElements == 9);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == Spy(26));
+         assertUnit(v.data[1] == Spy(49));
+         assertUnit(v.data[2] == Spy(11));
+         assertUnit(v.data[6] == Spy(55));
+         assertUnit(v.data[7] == Spy(67));
+         assertUnit(v.data[8] == Spy(89));
+      }
+   }  // teardown
+
+   // insert from a stream, which can only be read once
+   void test_insert_rangeInput()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v{ 26, 49, 67, 89 };
+      std::istringstream in("1 2 3 4");
+      // exercise
+      custom::vector<int>::iterator it = v.insert(v.begin() + 1,
+         std::istream_iterator<int>(in), std::istream_iterator<int>());
+      // verify
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 |  1 |  2 |  3 |  4 | 49 | 67 | 89 |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(v.numElements == 8);
+      assertUnit(it == v.begin() + 1);
+      if (v.data && v.numElements == 8)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 1);
+         assertUnit(v.data[2] == 2);
+         assertUnit(v.data[3] == 3);
+         assertUnit(v.data[4] == 4);
+         assertUnit(v.data[5] == 49);
+         assertUnit(v.data[7] == 89);
+      }
+   }  // teardown
+
+   // append onto an empty vector
+   void test_append_empty()
+   {  // setup
+      custom::vector<Spy> v;
+      std::vector<Spy> source{ Spy(26), Spy(49), Spy(67), Spy(89) };
+      Spy::reset();
+      // exercise
+      v.append(source.begin(), source.end());
+      // verify
+      assertUnit(Spy::numCopy() == 4);       // copy [26,49,67,89]
+      assertUnit(Spy::numCopyMove() == 0);
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertStandardFixture(v);
+   }  // teardown
+   
+   // append from a stream onto the end
+   void test_append_input()
+   {  // setup
+      custom::vector<int> v{ 26, 49 };
+      std::istringstream in("67 89");
+      // exercise
+      v.append(std::istream_iterator<int>(in), std::istream_iterator<int>());
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertUnit(v.numElements == 4);
+      if (v.data && v.numElements == 4)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+         assertUnit(v.data[2] == 67);
+         assertUnit(v.data[3] == 89);
+      }
+   }  // teardown
+
+   // pushing one of our own elements as we grow copies it before the move
+   void test_pushback_selfReallocate()
+   {  // setup
+      custom::vector<std::string> v{ "twenty six", "forty nine", "sixty seven", "eighty nine" };
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 5);
+      assertUnit(v.data[0] == "twenty six");
+      assertUnit(v.data[4] == "twenty six");
+   }  // teardown
+
+   // resizing with one of our own elements as we grow copies it before the move
+   void test_resize_selfReallocate()
+   {  // setup
+      custom::vector<std::string> v{ "twenty six", "forty nine", "sixty seven", "eighty nine" };
+      // exercise
+      v.resize(6, v[0]);
+      // verify
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+      assertUnit(v.data[0] == "twenty six");
+      assertUnit(v.data[4] == "twenty six");
+      assertUnit(v.data[5] == "twenty six");
+   }  // teardown
+
+   // default-initialize two more Spies
+   void test_resizeDefaultInit_fourSix()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.resize_default_init(6);
+      // verify
+      assertUnit(Spy::numDefault() == 2);    // default-construct [00,00]
+      assertUnit(Spy::numCopyMove() == 4);   // move [26,49,67,89]
+      assertUnit(Spy::numDestructor() == 4); // destroy the old [26,49,67,89]
+      assertUnit(Spy::numCopy() == 0);
+      //      0    1    2    3    4    5    6    7
+      //    +----+----+----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 | 00 | 00 |    |    |
+      //    +----+----+----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 8);
+      assertUnit(v.numElements == 6);
+      if (v.data)
+      {
+         assertUnit(v.data[3] == Spy(89));
+         assertUnit(v.data[4] == Spy());
+         assertUnit(v.data[5] == Spy());
+      }
+   }  // teardown
+
+   // trivial types are left uninitialized, ready to be overwritten
+   void test_resizeDefaultInit_trivial()
+   {  // setup
+      custom::vector<int> v{ 26, 49 };
+      // exercise
+      v.resize_default_init(1000);
+      // verify
+      assertUnit(v.numCapacity == 1000);
+      assertUnit(v.numElements == 1000);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+      }
+   }  // teardown
+
+   // growing a few at a time does not reallocate every time
+   void test_resizeDefaultInit_growsGeometrically()
+   {  // setup
+      custom::vector<int> v;
+      int numReallocate = 0;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         size_t capacityOld = v.numCapacity;
+         v.resize_default_init(v.numElements + 3);
+         if (v.numCapacity != capacityOld)
+            numReallocate++;
+      }
+      // verify
+      assertUnit(v.numElements == 3000);
+      assertUnit(v.numCapacity >= 3000);
+      assertUnit(numReallocate <= 11);       // 3, 6, 12, ... 3072
+   }  // teardown
+
+   // a producer writes into the spare capacity and then commits it
+   void test_reserveSpare_commit()
+   {  // setup
+      //      0    1
+      //    +----+----+
+      //    | 26 | 49 |
+      //    +----+----+
+      custom::vector<int> v{ 26, 49 };
+      // exercise
+      int * p = v.reserve_spare(3);
+      p[0] = 67;
+      p[1] = 89;
+      v.commit(2);
+      // verify
+      //      0    1    2    3    4
+      //    +----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |    |
+      //    +----+----+----+----+----+
+      assertUnit(v.numCapacity == 5);
+      assertUnit(v.numElements == 4);
+      if (v.data)
+      {
+         assertUnit(p == v.data + 2);
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+         assertUnit(v.data[2] == 67);
+         assertUnit(v.data[3] == 89);
+      }
+   }  // teardown
+   
    // shrink an empty fixture
    void test_shrink_empty()
    {  // setup
@@ -1083,6 +1575,158 @@ public:
       teardownStandardFixture(v);
    }
    
+   // shrink when the elements can be relocated as bytes
+   void test_shrink_relocatable()
+   {  // setup
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |    |    |
+      //    +----+----+----+----+----+----+
+      custom::vector<int> v;
+      v.data = v.alloc.allocate(6);
+      v.data[0] = 26;
+      v.data[1] = 49;
+      v.data[2] = 67;
+      v.data[3] = 89;
+      v.numElements = 4;
+      v.numCapacity = 6;
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data != nullptr);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+         assertUnit(v.data[2] == 67);
+         assertUnit(v.data[3] == 89);
+      }
+   }  // teardown
+   
+   // shrink a mapped buffer, returning the extra pages
+   void test_shrink_mapped()
+   {  // setup
+      //      0    1    2    3    4         99999
+      //    +----+----+----+----+----+ ... +----+
+      //    | 26 | 49 | 67 | 89 |    |     |    |
+      //    +----+----+----+----+----+ ... +----+
+      custom::vector<int, custom::mmap_allocator<int, 64>> v;
+      v.data = v.alloc.allocate(100000);
+      v.data[0] = 26;
+      v.data[1] = 49;
+      v.data[2] = 67;
+      v.data[3] = 89;
+      v.numElements = 4;
+      v.numCapacity = 100000;
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data != nullptr);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 49);
+         assertUnit(v.data[2] == 67);
+         assertUnit(v.data[3] == 89);
+      }
+   }  // teardown
+   
+   // erase the middle two elements
+   void test_erase_middle()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      custom::vector<Spy>::iterator it = v.erase(custom::vector<Spy>::iterator(v.data + 1),
+                                                 custom::vector<Spy>::iterator(v.data + 3));
+      // verify
+      assertUnit(Spy::numDestructor() == 3); // destroy [49,67] and the old 89 slot
+      assertUnit(Spy::numDelete() == 2);     // delete [49,67]
+      assertUnit(Spy::numCopyMove() == 1);   // move 89 down
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 89 |    |    |
+      //    +----+----+----+----+
+      assertUnit(it.p == v.data + 1);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 2);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == Spy(26));
+         assertUnit(v.data[1] == Spy(89));
+      }
+   }  // teardown
+
+   // erase everything
+   void test_erase_all()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy::reset();
+      // exercise
+      v.erase(v.begin(), v.end());
+      // verify
+      assertUnit(Spy::numDestructor() == 4); // destroy [26,49,67,89]
+      assertUnit(Spy::numDelete() == 4);     // delete [26,49,67,89]
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(v.numCapacity == 4);
+      assertUnit(v.numElements == 0);
+   }  // teardown
+
+   // erase from a vector of bytes: the tail slides down in one memmove
+   void test_erase_relocatable()
+   {  // setup
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 | 11 | 22 |
+      //    +----+----+----+----+----+----+
+      custom::vector<int> v{ 26, 49, 67, 89, 11, 22 };
+      // exercise
+      v.erase(custom::vector<int>::iterator(v.data + 1),
+              custom::vector<int>::iterator(v.data + 3));
+      int values[] = { 33, 44 };
+      v.insert(custom::vector<int>::iterator(v.data + 2), values, values + 2);
+      // verify
+      //      0    1    2    3    4    5
+      //    +----+----+----+----+----+----+
+      //    | 26 | 89 | 33 | 44 | 11 | 22 |
+      //    +----+----+----+----+----+----+
+      assertUnit(v.numCapacity == 6);
+      assertUnit(v.numElements == 6);
+      if (v.data)
+      {
+         assertUnit(v.data[0] == 26);
+         assertUnit(v.data[1] == 89);
+         assertUnit(v.data[2] == 33);
+         assertUnit(v.data[3] == 44);
+         assertUnit(v.data[4] == 11);
+         assertUnit(v.data[5] == 22);
+      }
+   }  // teardown
+
    /***************************************
     * SIZE EMPTY CAPACITY
     ***************************************/
@@ -2853,6 +3497,420 @@ public:
       // teardown
       teardownStandardFixture(v);
    }
+   // jump around with +, -, += and []
+   void test_iterator_arithmetic()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      custom::vector<Spy>::iterator it = v.begin();
+      Spy::reset();
+      // exercise
+      custom::vector<Spy>::iterator itThree = it + 3;
+      custom::vector<Spy>::iterator itOne = 1 + it;
+      it += 2;
+      // verify
+      assertUnit(itThree.p == v.data + 3);
+      assertUnit(itOne.p == v.data + 1);
+      assertUnit(it.p == v.data + 2);
+      assertUnit((itThree - 2).p == v.data + 1);
+      assertUnit(itThree - itOne == 2);
+      assertUnit(v.end() - v.begin() == 4);
+      assertUnit(it[1].get() == 89);
+      assertUnit(it->get() == 67);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // relative order of iterators
+   void test_iterator_compare()
+   {  // setup
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      custom::vector<Spy>::iterator itLHS(v.data + 1);
+      custom::vector<Spy>::iterator itRHS(v.data + 3);
+      // exercise and verify
+      assertUnit(itLHS < itRHS);
+      assertUnit(itLHS <= itRHS);
+      assertUnit(!(itLHS > itRHS));
+      assertUnit(!(itLHS >= itRHS));
+      assertUnit(itRHS > itLHS);
+      assertUnit(itLHS <= itLHS);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // the standard library sees a random-access iterator
+   void test_iterator_traits()
+   {  // setup
+      typedef custom::vector<int>::iterator It;
+      typedef custom::vector<int>::const_iterator CIt;
+      // exercise and verify
+      assertUnit((std::is_same<std::iterator_traits<It>::iterator_category,
+                               std::random_access_iterator_tag>::value));
+      assertUnit((std::is_same<std::iterator_traits<CIt>::iterator_category,
+                               std::random_access_iterator_tag>::value));
+      assertUnit((std::is_same<std::iterator_traits<It>::reference, int &>::value));
+      assertUnit((std::is_same<std::iterator_traits<CIt>::reference, const int &>::value));
+   }  // teardown
+
+   // std::sort, std::lower_bound and std::distance work on our vector
+   void test_iterator_sort()
+   {  // setup
+      custom::vector<int> v{ 89, 26, 67, 49, 11 };
+      // exercise
+      std::sort(v.begin(), v.end());
+      custom::vector<int>::iterator it = std::lower_bound(v.begin(), v.end(), 50);
+      // verify
+      //      0    1    2    3    4
+      //    +----+----+----+----+----+
+      //    | 11 | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+----+
+      assertUnit(v.data[0] == 11);
+      assertUnit(v.data[1] == 26);
+      assertUnit(v.data[2] == 49);
+      assertUnit(v.data[3] == 67);
+      assertUnit(v.data[4] == 89);
+      assertUnit(std::distance(v.begin(), it) == 3);
+      assertUnit(*it == 67);
+   }  // teardown
+
+   // read through a const vector
+   void test_constIterator_read()
+   {  // setup
+      custom::vector<int> v{ 26, 49, 67, 89 };
+      const custom::vector<int> & vConst = v;
+      int sum = 0;
+      // exercise
+      for (custom::vector<int>::const_iterator it = vConst.begin(); it != vConst.end(); ++it)
+         sum += *it;
+      custom::vector<int>::const_iterator itConvert = v.begin();
+      // verify
+      assertUnit(sum == 26 + 49 + 67 + 89);
+      assertUnit(itConvert == v.cbegin());
+      assertUnit(v.cend() - v.cbegin() == 4);
+      assertUnit(vConst.begin()[3] == 89);
+   }  // teardown
+
+   // an iterator and a const_iterator compare and subtract in either order
+   void test_constIterator_mixed()
+   {  // setup
+      custom::vector<int> v{ 26, 49, 67, 89 };
+      custom::vector<int>::iterator it = v.begin() + 1;
+      custom::vector<int>::const_iterator cit = v.cbegin() + 3;
+      // exercise and verify
+      assertUnit(it != cit);
+      assertUnit(cit != it);
+      assertUnit(it == v.cbegin() + 1);
+      assertUnit(v.cbegin() + 1 == it);
+      assertUnit(it < cit);
+      assertUnit(cit > it);
+      assertUnit(it <= cit);
+      assertUnit(cit >= it);
+      assertUnit(cit - it == 2);
+      assertUnit(it - cit == -2);
+   }  // teardown
+
+   /***************************************
+    * OWNERSHIP OF THE BUFFER
+    ***************************************/
+
+   // adopt a buffer a decoder filled
+   void test_adopt_raw()
+   {  // setup
+      std::allocator<int> a;
+      int * p = a.allocate(10);
+      p[0] = 26;
+      p[1] = 49;
+      p[2] = 67;
+      p[3] = 89;
+      custom::vector<int> v;
+      // exercise
+      v.adopt(p, 4, 10);
+      // verify
+      //      0    1    2    3    4    5    6    7    8    9
+      //    +----+----+----+----+----+----+----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |    |    |    |    |    |    |
+      //    +----+----+----+----+----+----+----+----+----+----+
+      assertUnit(v.data == p);
+      assertUnit(v.numElements == 4);
+      assertUnit(v.numCapacity == 10);
+      assertUnit(v.data[3] == 89);
+   }  // teardown
+
+   // adopting frees what was there before
+   void test_adopt_replace()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      std::allocator<Spy> a;
+      Spy * p = a.allocate(2);
+      new ((void *)p) Spy(99);
+      Spy::reset();
+      // exercise
+      v.adopt(p, 1, 2);
+      // verify
+      assertUnit(Spy::numDestructor() == 4); // destroy [26,49,67,89]
+      assertUnit(Spy::numDelete() == 4);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      //      0    1
+      //    +----+----+
+      //    | 99 |    |
+      //    +----+----+
+      assertUnit(v.data == p);
+      assertUnit(v.numElements == 1);
+      assertUnit(v.numCapacity == 2);
+      assertUnit(v.data[0] == Spy(99));
+   }  // teardown
+
+   // release hands the buffer back and leaves the vector empty
+   void test_release_standard()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v{ 26, 49, 67, 89 };
+      v.reserve(8);
+      int * pOld = v.data;
+      // exercise
+      custom::vector<int>::buffer b = v.release();
+      // verify
+      assertUnit(b.data == pOld);
+      assertUnit(b.numElements == 4);
+      assertUnit(b.numCapacity == 8);
+      assertUnit(b.data[0] == 26);
+      assertUnit(b.data[3] == 89);
+      assertUnit(v.data == nullptr);
+      assertUnit(v.numElements == 0);
+      assertUnit(v.numCapacity == 0);
+      std::allocator<int>().deallocate(b.data, b.numCapacity);
+   }  // teardown
+
+   // a buffer can pass from one vector to another with no copies
+   void test_release_adoptRoundTrip()
+   {  // setup
+      custom::vector<Spy> vSrc;
+      setupStandardFixture(vSrc);
+      custom::vector<Spy> vDest;
+      Spy::reset();
+      // exercise
+      custom::vector<Spy>::buffer b = vSrc.release();
+      vDest.adopt(b.data, b.numElements, b.numCapacity, vSrc.get_allocator());
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(vSrc.data == nullptr);
+      assertStandardFixture(vDest);
+   }  // teardown
+
+   /***************************************
+    * BULK UPDATE
+    ***************************************/
+
+   // a fill constructor past the threshold is built by the thread pool
+   void test_construct_fillParallel()
+   {  // setup
+      size_t threshold = custom::parallel_threshold();
+      custom::parallel_threshold() = 0;
+      // exercise
+      custom::vector<int> v(1000, 99);
+      // verify
+      custom::parallel_threshold() = threshold;
+      assertUnit(v.numCapacity == 1000);
+      assertUnit(v.numElements == 1000);
+      assertUnit(std::count(v.data, v.data + 1000, 99) == 1000);
+   }  // teardown
+
+   // a big copy is split across the thread pool
+   void test_constructCopy_parallel()
+   {  // setup
+      custom::vector<int> vSrc(1000);
+      for (int i = 0; i < 1000; i++)
+         vSrc.data[i] = i;
+      size_t threshold = custom::parallel_threshold();
+      custom::parallel_threshold() = 0;
+      // exercise
+      custom::vector<int> vDest(vSrc);
+      // verify
+      custom::parallel_threshold() = threshold;
+      assertUnit(vDest.numCapacity == 1000);
+      assertUnit(vDest.numElements == 1000);
+      assertUnit(vDest.data != vSrc.data);
+      assertUnit(std::equal(vSrc.data, vSrc.data + 1000, vDest.data));
+   }  // teardown
+
+   // assign a big vector onto a small one
+   void test_assign_parallelGrow()
+   {  // setup
+      custom::vector<int> vSrc(1000);
+      for (int i = 0; i < 1000; i++)
+         vSrc.data[i] = i;
+      custom::vector<int> vDest{ 26, 49 };
+      size_t threshold = custom::parallel_threshold();
+      custom::parallel_threshold() = 0;
+      // exercise
+      vDest = vSrc;
+      // verify
+      custom::parallel_threshold() = threshold;
+      assertUnit(vDest.numCapacity == 1000);
+      assertUnit(vDest.numElements == 1000);
+      assertUnit(std::equal(vSrc.data, vSrc.data + 1000, vDest.data));
+   }  // teardown
+
+   // fill assigns every element
+   void test_fill_standard()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<Spy> v;
+      setupStandardFixture(v);
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      v.fill(s);
+      // verify
+      assertUnit(Spy::numAssign() == 4);     // assign 99 four times
+      assertUnit(Spy::numCopy() == 0);
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 99 | 99 | 99 | 99 |
+      //    +----+----+----+----+
+      assertUnit(v.numElements == 4);
+      assertUnit(v.data[0] == Spy(99));
+      assertUnit(v.data[3] == Spy(99));
+   }  // teardown
+
+   // fill a big vector with the thread pool
+   void test_fill_parallel()
+   {  // setup
+      custom::vector<int> v(1000);
+      size_t threshold = custom::parallel_threshold();
+      custom::parallel_threshold() = 0;
+      // exercise
+      v.fill(99);
+      // verify
+      custom::parallel_threshold() = threshold;
+      assertUnit(v.numElements == 1000);
+      assertUnit(std::count(v.data, v.data + 1000, 99) == 1000);
+   }  // teardown
+
+   // double every element in place
+   void test_transform_parallel()
+   {  // setup
+      custom::vector<int> v(1000);
+      for (int i = 0; i < 1000; i++)
+         v.data[i] = i;
+      size_t threshold = custom::parallel_threshold();
+      custom::parallel_threshold() = 0;
+      // exercise
+      v.transform([](int x) { return x * 2; });
+      // verify
+      custom::parallel_threshold() = threshold;
+      assertUnit(v.numElements == 1000);
+      assertUnit(v.data[0] == 0);
+      assertUnit(v.data[499] == 998);
+      assertUnit(v.data[999] == 1998);
+   }  // teardown
+
+   // build a vector of double from a vector of int
+   void test_transform_fromParallel()
+   {  // setup
+      custom::vector<int> vSrc(1000);
+      for (int i = 0; i < 1000; i++)
+         vSrc.data[i] = i;
+      custom::vector<double> vDest{ 2.6, 4.9 };
+      size_t threshold = custom::parallel_threshold();
+      custom::parallel_threshold() = 0;
+      // exercise
+      vDest.transform(vSrc, [](int x) { return x + 0.5; });
+      // verify
+      custom::parallel_threshold() = threshold;
+      assertUnit(vDest.numElements == 1000);
+      assertUnit(vDest.data[0] == 0.5);
+      assertUnit(vDest.data[999] == 999.5);
+   }  // teardown
+
+   // types that are not trivially copyable are built one at a time
+   void test_transform_fromSerial()
+   {  // setup
+      custom::vector<int> vSrc{ 26, 49, 67, 89 };
+      custom::vector<Spy> vDest;
+      vDest.push_back(Spy(11));
+      Spy::reset();
+      // exercise
+      vDest.transform(vSrc, [](int x) { return Spy(x); });
+      // verify
+      assertUnit(Spy::numDestructor() >= 1); // destroy 11
+      assertUnit(Spy::numCopy() == 0);
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertUnit(vDest.numElements == 4);
+      assertUnit(vDest.data[0] == Spy(26));
+      assertUnit(vDest.data[3] == Spy(89));
+   }  // teardown
+
+   // parallel_for visits every index exactly once
+   void test_threadPool_everyIndex()
+   {  // setup
+      custom::thread_pool pool(4);
+      std::atomic<int> visits[1000];
+      for (int i = 0; i < 1000; i++)
+         visits[i] = 0;
+      // exercise
+      pool.parallel_for(1000, [&visits](size_t begin, size_t end)
+      {
+         for (size_t i = begin; i < end; i++)
+            visits[i]++;
+      });
+      // verify
+      assertUnit(pool.size() == 4);
+      bool once = true;
+      for (int i = 0; i < 1000; i++)
+         if (visits[i] != 1)
+            once = false;
+      assertUnit(once);
+   }  // teardown
+
+   // an exception in any chunk comes back to the caller
+   void test_threadPool_exception()
+   {  // setup
+      custom::thread_pool pool(4);
+      bool thrown = false;
+      // exercise
+      try
+      {
+         pool.parallel_for(1000, [](size_t begin, size_t end)
+         {
+            if (begin <= 999 && 999 < end)
+               throw std::runtime_error("last chunk");
+         });
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *      0    1    2    3
@@ -0,0 +1,335 @@
+/***********************************************************************
+ * Header:
+ *    TEST VECTOR SIMD
+ * Summary:
+ *    Unit tests for the vector search and reduction kernels. Each
+ *    test runs at every instruction set this CPU has.
+ * Author:
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "vector_simd.h"
+#include "unitTest.h"
+
+#include <cassert>
+#include <cstdint>
+
+class TestVectorSimd : public UnitTest
+{
+
+public:
+   void run()
+   {
+      reset();
+
+      // Search
+      test_find_everyPosition();
+      test_find_missing();
+      test_find_empty();
+      test_count_int();
+      test_count_uint64();
+      test_contains_float();
+
+      // Min and max
+      test_minElement_first();
+      test_maxElement_tail();
+      test_minMax_float();
+
+      // Reduce
+      test_sum_int();
+      test_sum_uint64();
+      test_sumDot_intWraps();
+      test_dot_float();
+
+      // Compare
+      test_mismatch_everyPosition();
+      test_mismatch_equal();
+
+      // Other types
+      test_find_scalarType();
+
+      custom::simd::setLevel(custom::simd::AVX2);   // back to the best we have
+      report("VectorSimd");
+   }
+
+   /***************************************
+    * SEARCH
+    ***************************************/
+
+   // find a single 99 wherever it is, including the scalar tail
+   void test_find_everyPosition()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         for (int32_t i = 0; i < 37; i++)
+         {
+            custom::vector<int32_t> v(37);
+            for (int32_t j = 0; j < 37; j++)
+               v[j] = j == i ? 99 : j;
+            // exercise
+            custom::vector<int32_t>::const_iterator it = custom::find(v, 99);
+            // verify
+            assertUnit(it - v.cbegin() == i);
+         }
+      }
+   }  // teardown
+
+   // a value not there gives end()
+   void test_find_missing()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v{ 26, 49, 67, 89, 26, 49, 67, 89, 26, 49 };
+         // exercise
+         custom::vector<int32_t>::const_iterator it = custom::find(v, 99);
+         // verify
+         assertUnit(it == v.cend());
+      }
+   }  // teardown
+
+   // nothing to find in an empty vector
+   void test_find_empty()
+   {  // setup
+      custom::vector<float> v;
+      // exercise
+      custom::vector<float>::const_iterator it = custom::find(v, 99.0f);
+      // verify
+      assertUnit(it == v.cend());
+      assertUnit(custom::count(v, 99.0f) == 0);
+      assertUnit(custom::min_element(v) == v.cend());
+      assertUnit(custom::sum(v) == 0.0f);
+   }  // teardown
+
+   // every third element is a 99
+   void test_count_int()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v(100);
+         for (int32_t i = 0; i < 100; i++)
+            v[i] = i % 3 == 0 ? 99 : i;
+         // exercise
+         size_t num = custom::count(v, 99);
+         // verify
+         assertUnit(num == 34);
+      }
+   }  // teardown
+
+   // count 64-bit values past the 32-bit range
+   void test_count_uint64()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         uint64_t big = (uint64_t)1 << 40;
+         custom::vector<uint64_t> v{ big, 99, big, big + 1, big, 26, big };
+         // exercise
+         size_t num = custom::count(v, big);
+         // verify
+         assertUnit(num == 4);
+      }
+   }  // teardown
+
+   // contains on float
+   void test_contains_float()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<float> v{ 2.6f, 4.9f, 6.7f, 8.9f, 2.6f, 4.9f, 6.7f, 8.9f, 9.9f };
+         // exercise and verify
+         assertUnit(custom::contains(v, 9.9f));
+         assertUnit(custom::contains(v, 4.9f));
+         assertUnit(!custom::contains(v, 1.0f));
+      }
+   }  // teardown
+
+   /***************************************
+    * MIN AND MAX
+    ***************************************/
+
+   // the first of two equal minimums is reported
+   void test_minElement_first()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v(40);
+         for (int32_t i = 0; i < 40; i++)
+            v[i] = 100 - i;
+         v[13] = -5;
+         v[29] = -5;
+         // exercise
+         custom::vector<int32_t>::const_iterator it = custom::min_element(v);
+         // verify
+         assertUnit(it - v.cbegin() == 13);
+         assertUnit(*it == -5);
+      }
+   }  // teardown
+
+   // the largest is in the scalar tail
+   void test_maxElement_tail()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v(19);
+         for (int32_t i = 0; i < 19; i++)
+            v[i] = i;
+         v[18] = 99;
+         // exercise
+         custom::vector<int32_t>::const_iterator it = custom::max_element(v);
+         // verify
+         assertUnit(it - v.cbegin() == 18);
+      }
+   }  // teardown
+
+   // min and max on float
+   void test_minMax_float()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<float> v(21);
+         for (int i = 0; i < 21; i++)
+            v[i] = (float)((i * 5) % 21) - 10.0f;
+         // exercise
+         custom::vector<float>::const_iterator itMin = custom::min_element(v);
+         custom::vector<float>::const_iterator itMax = custom::max_element(v);
+         // verify
+         assertUnit(*itMin == -10.0f);
+         assertUnit(itMin - v.cbegin() == 0);
+         assertUnit(*itMax == 10.0f);
+      }
+   }  // teardown
+
+   /***************************************
+    * REDUCE
+    ***************************************/
+
+   // 1 + 2 + ... + 100
+   void test_sum_int()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v(100);
+         for (int32_t i = 0; i < 100; i++)
+            v[i] = i + 1;
+         // exercise
+         int32_t total = custom::sum(v);
+         // verify
+         assertUnit(total == 5050);
+      }
+   }  // teardown
+
+   // 64-bit sums do not overflow at 32 bits
+   void test_sum_uint64()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<uint64_t> v(11, (uint64_t)1 << 33);
+         // exercise
+         uint64_t total = custom::sum(v);
+         // verify
+         assertUnit(total == ((uint64_t)11 << 33));
+      }
+   }  // teardown
+
+   // int32_t sums and dots wrap around on overflow
+   void test_sumDot_intWraps()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v(19, INT32_MAX);
+         // exercise
+         int32_t total = custom::sum(v);
+         int32_t product = custom::dot(v, v);
+         // verify
+         assertUnit(total == (int32_t)((uint32_t)INT32_MAX * 19u));
+         assertUnit(product == 19);
+      }
+   }  // teardown
+
+   // dot of two float vectors of different lengths
+   void test_dot_float()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<float> v1(13, 2.0f);
+         custom::vector<float> v2(15, 0.5f);
+         // exercise
+         float total = custom::dot(v1, v2);
+         // verify
+         assertUnit(total == 13.0f);
+      }
+   }  // teardown
+
+   /***************************************
+    * COMPARE
+    ***************************************/
+
+   // one difference, wherever it is
+   void test_mismatch_everyPosition()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         for (size_t i = 0; i < 23; i++)
+         {
+            custom::vector<uint64_t> v1(23, 99);
+            custom::vector<uint64_t> v2(23, 99);
+            v2[i] = 26;
+            // exercise
+            auto itPair = custom::mismatch(v1, v2);
+            // verify
+            assertUnit((size_t)(itPair.first - v1.cbegin()) == i);
+            assertUnit((size_t)(itPair.second - v2.cbegin()) == i);
+         }
+      }
+   }  // teardown
+
+   // equal prefixes stop at the shorter one
+   void test_mismatch_equal()
+   {
+      for (int level = custom::simd::SCALAR; level <= custom::simd::detect(); level++)
+      {  // setup
+         custom::simd::setLevel((custom::simd::Level)level);
+         custom::vector<int32_t> v1{ 26, 49, 67, 89, 26, 49, 67, 89, 26 };
+         custom::vector<int32_t> v2{ 26, 49, 67, 89, 26, 49, 67, 89, 26, 49 };
+         // exercise
+         auto itPair = custom::mismatch(v1, v2);
+         // verify
+         assertUnit(itPair.first == v1.cend());
+         assertUnit(itPair.second - v2.cbegin() == 9);
+      }
+   }  // teardown
+
+   /***************************************
+    * OTHER TYPES
+    ***************************************/
+
+   // types without SIMD kernels use the scalar loop
+   void test_find_scalarType()
+   {  // setup
+      custom::vector<double> v{ 2.6, 4.9, 6.7, 8.9 };
+      // exercise and verify
+      assertUnit(custom::find(v, 6.7) - v.cbegin() == 2);
+      assertUnit(custom::sum(v) == 2.6 + 4.9 + 6.7 + 8.9);
+      assertUnit(custom::max_element(v) - v.cbegin() == 3);
+   }  // teardown
+};
+
+#endif // DEBUG
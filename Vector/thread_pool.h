@@ -0,0 +1,216 @@
+/***********************************************************************
+ * Header:
+ *    THREAD POOL
+ * Summary:
+ *    A fixed set of worker threads that vector hands big jobs to.
+ *    The calling thread always does a share of the work too.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        thread_pool            : Worker threads and a queue of jobs
+ *        parallel_threshold     : How many bytes before we go parallel
+ * Author
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>             // for size_t
+#include <deque>               // for the job queue
+#include <vector>              // for the workers
+#include <thread>              // for std::thread
+#include <mutex>               // for std::mutex
+#include <condition_variable>  // for std::condition_variable
+#include <functional>          // for std::function
+#include <exception>           // for std::exception_ptr
+
+namespace custom
+{
+
+/*****************************************
+ * PARALLEL THRESHOLD
+ * Jobs touching fewer bytes than this are not
+ * worth waking the workers for. It can be changed.
+ ****************************************/
+inline size_t & parallel_threshold()
+{
+   static size_t threshold = (size_t)8 << 20;
+   return threshold;
+}
+
+/*****************************************
+ * THREAD POOL
+ * parallel_for() splits [0, num) into one chunk per
+ * thread, queues all but the first, and runs the
+ * first itself. While it waits it runs queued chunks
+ * too, so a job started from a worker never deadlocks.
+ ****************************************/
+class thread_pool
+{
+public:
+   explicit thread_pool(size_t numThreads = std::thread::hardware_concurrency());
+   ~thread_pool();
+   thread_pool(const thread_pool &) = delete;
+   thread_pool & operator = (const thread_pool &) = delete;
+
+   // the pool vector uses, made the first time it is needed
+   static thread_pool & instance()
+   {
+      static thread_pool pool;
+      return pool;
+   }
+
+   // call f(begin, end) over [0, num), spread across the threads
+   template <class F>
+   void parallel_for(size_t num, F f);
+
+   // how many threads work on a job, counting the caller
+   size_t size() const { return workers.size() + 1; }
+
+private:
+   void work();
+   bool runOne(std::unique_lock<std::mutex> & lock);
+
+   std::vector<std::thread> workers;
+   std::deque<std::function<void()>> jobs;
+   std::mutex mtx;
+   std::condition_variable cvJob;   // a job was queued, or we are stopping
+   std::condition_variable cvDone;  // a job finished
+   bool stopping;
+};
+
+/***************************************
+ * THREAD POOL :: CONSTRUCTOR
+ * Start numThreads - 1 workers. The thread that
+ * calls parallel_for() is the last one.
+ **************************************/
+inline thread_pool :: thread_pool(size_t numThreads) : stopping(false)
+{
+   for (size_t i = 1; i < numThreads; i++)
+      workers.push_back(std::thread([this] { work(); }));
+}
+
+/***************************************
+ * THREAD POOL :: DESTRUCTOR
+ * Tell the workers to finish and wait for them
+ **************************************/
+inline thread_pool :: ~thread_pool()
+{
+   {
+      std::lock_guard<std::mutex> lock(mtx);
+      stopping = true;
+   }
+   cvJob.notify_all();
+   for (size_t i = 0; i < workers.size(); i++)
+      workers[i].join();
+}
+
+/***************************************
+ * THREAD POOL :: RUN ONE
+ * Take a job off the queue and run it without
+ * holding the lock
+ *     INPUT  : lock a held lock on mtx
+ *     OUTPUT : was there a job to run?
+ **************************************/
+inline bool thread_pool :: runOne(std::unique_lock<std::mutex> & lock)
+{
+   if (jobs.empty())
+      return false;
+   std::function<void()> job = std::move(jobs.front());
+   jobs.pop_front();
+   lock.unlock();
+   job();
+   lock.lock();
+   return true;
+}
+
+/***************************************
+ * THREAD POOL :: WORK
+ * What every worker does until we stop
+ **************************************/
+inline void thread_pool :: work()
+{
+   std::unique_lock<std::mutex> lock(mtx);
+   while (true)
+   {
+      cvJob.wait(lock, [this] { return stopping || !jobs.empty(); });
+      if (jobs.empty())
+         return;
+      runOne(lock);
+   }
+}
+
+/***************************************
+ * THREAD POOL :: PARALLEL FOR
+ * Split [0, num) into even chunks and call
+ * f(begin, end) on each, returning when every
+ * chunk is done. The first exception thrown by
+ * any chunk is rethrown here.
+ *     INPUT  : num the size of the range
+ *              f   the work for one chunk
+ *     OUTPUT :
+ **************************************/
+template <class F>
+void thread_pool :: parallel_for(size_t num, F f)
+{
+   size_t numChunks = size() < num ? size() : num;
+   if (numChunks <= 1)
+   {
+      if (num)
+         f((size_t)0, num);
+      return;
+   }
+
+   // what the chunks share; it lives on our stack until they finish
+   size_t numLeft = numChunks - 1;
+   std::exception_ptr error;
+   auto chunk = [&](size_t iChunk)
+   {
+      size_t begin = num * iChunk / numChunks;
+      size_t end   = num * (iChunk + 1) / numChunks;
+      try
+      {
+         f(begin, end);
+      }
+      catch (...)
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         if (!error)
+            error = std::current_exception();
+      }
+   };
+
+   // queue all but the first chunk
+   {
+      std::lock_guard<std::mutex> lock(mtx);
+      for (size_t iChunk = 1; iChunk < numChunks; iChunk++)
+         jobs.push_back([&, iChunk]
+         {
+            chunk(iChunk);
+            std::lock_guard<std::mutex> lock(mtx);
+            if (--numLeft == 0)
+               cvDone.notify_all();
+         });
+   }
+   cvJob.notify_all();
+
+   // do the first chunk ourselves, then help until everything is done
+   chunk(0);
+   std::unique_lock<std::mutex> lock(mtx);
+   while (numLeft)
+      if (!runOne(lock))
+         cvDone.wait(lock, [&] { return numLeft == 0 || !jobs.empty(); });
+   lock.unlock();
+
+   if (error)
+      std::rethrow_exception(error);
+}
+
+} // namespace custom
@@ -13,6 +13,12 @@
  *    This will contain the class definition of:
  *        vector                 : A class that represents a Vector
  *        vector::iterator       : An iterator through Vector
+ *        vector::const_iterator : A read-only iterator through Vector
+ *        vector_base            : The buffer work vector and small_vector share
+ *        is_trivially_relocatable : Can a T be moved with memmove?
+ *        has_reallocate         : Can the allocator resize in place?
+ *    Big vectors of trivially copyable types are filled, copied and
+ *    transformed a chunk per thread; see thread_pool.h.
  * Author
  *    Jacob Mower
  *    Elroe Woldemichael
@@ -24,6 +30,11 @@
 #include <cassert>  // because I am paranoid
 #include <new>      // std::bad_alloc
 #include <memory>   // for std::allocator
+#include <iterator> // for std::random_access_iterator_tag and std::distance
+#include <cstring>  // for std::memmove
+#include <type_traits> // for std::is_trivially_copyable and std::enable_if
+#include <utility>  // for std::declval
+#include "thread_pool.h" // for thread_pool and parallel_threshold
 
 class TestVector; // forward declaration for unit tests
 class TestStack;
@@ -33,17 +44,432 @@ class TestHash;
 namespace custom
 {
 
+/*****************************************
+ * IS TRIVIALLY RELOCATABLE
+ * Moving one of these to a new address and forgetting
+ * the old one is the same as copying the bytes. Every
+ * trivially copyable type qualifies. Other types can opt
+ * in by specializing this in namespace custom.
+ ****************************************/
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+/*****************************************
+ * HAS REALLOCATE
+ * Does the allocator offer
+ *    reallocate(p, numOld, numNew, numKeep)
+ * to resize a buffer without the vector copying it?
+ * See mmap_allocator for one that does.
+ ****************************************/
+template <typename A, typename = void>
+struct has_reallocate : std::false_type {};
+template <typename A>
+struct has_reallocate <A, decltype((void)std::declval<A &>().reallocate(
+   std::declval<typename A::value_type *>(), size_t(), size_t(), size_t()))>
+   : std::true_type {};
+
+/*****************************************
+ * VECTOR BASE
+ * The buffer, and the work on it that vector and
+ * small_vector share: relocating elements, opening
+ * gaps, growing, inserting and erasing. Derived
+ * decides how to grow through reserve() and what
+ * happens to an old buffer through replaceBuffer(),
+ * which is where small_vector keeps its inline slots.
+ ****************************************/
+template <typename T, typename A, typename Derived>
+class vector_base
+{
+public:
+
+   //
+   // Insert
+   //
+   void push_back(const T& t);
+   void push_back(T&& t);
+   void resize_default_init(size_t newElements);
+   T *  reserve_spare(size_t numSpare);
+   void commit(size_t numNew)
+   {
+      //The caller has filled the next numNew slots from reserve_spare()
+      assert(numElements + numNew <= numCapacity);
+      numElements += numNew;
+   }
+   template <class Iterator>
+   void append(Iterator first, Iterator last)
+   {
+      derived().insert(derived().end(), first, last);
+   }
+
+   //
+   // Remove
+   //
+   void clear()
+   {
+      //Remove all the elements but keep the buffer
+      for (size_t i = 0; i < numElements; ++i)
+         alloc.destroy(data + i);
+      numElements = 0;
+   }
+   void pop_back()
+   {
+      //If it's not empty then remove the last element
+      if (!empty())
+      {
+         alloc.destroy(data + (numElements - 1));
+         numElements -= 1;
+      }
+   }
+
+   //
+   // Status
+   //
+   size_t  size()          const { return numElements;}
+   size_t  capacity()      const { return numCapacity;}
+   bool empty()            const { return numElements == 0;}
+
+protected:
+   vector_base(const A & a, T * data, size_t numCapacity) :
+      alloc(a), data(data), numCapacity(numCapacity), numElements(0) {  }
+
+   Derived & derived() { return static_cast<Derived &>(*this); }
+
+   // move num elements from pSource to raw memory at pDest
+   void relocate(T * pDest, T * pSource, size_t num);
+
+   // room for numNeeded, at least doubling so growing a bit at a time stays cheap
+   size_t growCapacity(size_t numNeeded) const
+   {
+      return numCapacity * 2 < numNeeded ? numNeeded : numCapacity * 2;
+   }
+
+   // move the elements to a new buffer of newCapacity
+   void moveTo(size_t newCapacity);
+
+   // open up num raw slots at index, growing if needed
+   T * makeGap(size_t index, size_t num);
+
+   // put num copies of t at index
+   T * insertFill(size_t index, size_t num, const T & t);
+
+   // put [first, last) at index: counted up front, or read once
+   template <class Iterator>
+   T * insertRange(size_t index, Iterator first, Iterator last, std::forward_iterator_tag);
+   template <class Iterator>
+   T * insertRange(size_t index, Iterator first, Iterator last, std::input_iterator_tag);
+
+   // destroy [indexFirst, indexLast) and close the gap
+   T * eraseRange(size_t indexFirst, size_t indexLast);
+
+   A    alloc;                // use allocator for memory allocation
+   T *  data;                 // user data, a dynamically-allocated array
+   size_t  numCapacity;       // the capacity of the array
+   size_t  numElements;       // the number of items currently used
+};
+
+/***************************************
+ * VECTOR BASE :: PUSH BACK
+ * This method will add the element 't' to the
+ * end of the current buffer.  It will also grow
+ * the buffer as needed to accomodate the new element
+ *     INPUT  : 't' the new element to be added
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Derived>
+void vector_base <T, A, Derived> :: push_back(const T & t)
+{
+   //t might be one of ours and about to move, so keep a copy
+   if (numElements == numCapacity && &t >= data && &t < data + numElements)
+   {
+      T copy(t);
+      push_back(std::move(copy));
+      return;
+   }
+
+   //Double the size if needed and put our element in
+   if (numElements == numCapacity)
+      derived().reserve(numCapacity ? numCapacity * 2 : 1);
+   new ((void*)(data + numElements++)) T(t);
+}
+
+template <typename T, typename A, typename Derived>
+void vector_base <T, A, Derived> :: push_back(T && t)
+{
+   //t might be one of ours and about to move, so take it out first
+   if (numElements == numCapacity && &t >= data && &t < data + numElements)
+   {
+      T temp(std::move(t));
+      push_back(std::move(temp));
+      return;
+   }
+
+   //Double the size if needed and put our element in
+   if (numElements == numCapacity)
+      derived().reserve(numCapacity ? numCapacity * 2 : 1);
+   new ((void*)(data + numElements++)) T(std::move(t));
+}
+
+/***************************************
+ * VECTOR BASE :: RESIZE DEFAULT INIT
+ * Adjust the size to newElements, but new slots
+ * are only default-initialized. Trivial types like
+ * int are left alone entirely, so no memory gets
+ * touched before the caller writes to it. Like
+ * push_back, the buffer grows by at least double
+ * so adding a few at a time stays cheap.
+ *     INPUT  : newElements the new size
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Derived>
+void vector_base <T, A, Derived> :: resize_default_init(size_t newElements)
+{
+   //Desired size is smaller than current so destroy the old slots
+   if (newElements < numElements)
+      for (size_t i = newElements; i < numElements; i++)
+         alloc.destroy(data + i);
+
+   //Make room and default-initialize only if there is work to do
+   else if (newElements > numElements)
+   {
+      if (newElements > numCapacity)
+         derived().reserve(growCapacity(newElements));
+      if (!std::is_trivially_default_constructible<T>::value)
+         for (size_t i = numElements; i < newElements; i++)
+            new ((void*)(data + i)) T;
+   }
+   numElements = newElements;
+}
+
+/***************************************
+ * VECTOR BASE :: RESERVE SPARE
+ * Make sure there are at least numSpare raw slots
+ * past the end and hand back the first of them.
+ * A producer constructs or writes into them and
+ * then calls commit() with how many it filled.
+ *     INPUT  : numSpare how many slots the producer wants
+ *     OUTPUT : the first slot past the end
+ **************************************/
+template <typename T, typename A, typename Derived>
+T * vector_base <T, A, Derived> :: reserve_spare(size_t numSpare)
+{
+   //Grow by at least double so repeated calls stay cheap
+   if (numElements + numSpare > numCapacity)
+      derived().reserve(growCapacity(numElements + numSpare));
+   return data + numElements;
+}
+
+/***************************************
+ * VECTOR BASE :: RELOCATE
+ * Move num elements from pSource into the raw
+ * memory at pDest. The source slots are left
+ * destroyed. Relocatable types go over as a
+ * single block of bytes. The two ranges may
+ * overlap, so this also shifts elements in place.
+ *     INPUT  : pDest   the uninitialized destination
+ *              pSource the elements to move
+ *              num     how many elements to move
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Derived>
+void vector_base <T, A, Derived> :: relocate(T * pDest, T * pSource, size_t num)
+{
+   //Nothing to move
+   if (num == 0 || pDest == pSource)
+      return;
+
+   //The bytes are the object so copy them all at once
+   if (is_trivially_relocatable<T>::value)
+   {
+      std::memmove((void*)pDest, (const void*)pSource, num * sizeof(T));
+      return;
+   }
+
+   //Shifting right must start at the back so nothing is overwritten
+   if (pDest > pSource && pDest < pSource + num)
+   {
+      for (size_t i = num; i > 0; i--)
+      {
+         new ((void*)(pDest + i - 1)) T(std::move(pSource[i - 1]));
+         alloc.destroy(pSource + i - 1);
+      }
+      return;
+   }
+
+   //Otherwise move each one over and destroy the original
+   for (size_t i = 0; i < num; i++)
+   {
+      new ((void*)(pDest + i)) T(std::move(pSource[i]));
+      alloc.destroy(pSource + i);
+   }
+}
+
+/***************************************
+ * VECTOR BASE :: MOVE TO
+ * Allocate a buffer of newCapacity, move the
+ * elements into it, and let Derived give back
+ * the old one.
+ *     INPUT  : newCapacity the size of the new buffer
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A, typename Derived>
+void vector_base <T, A, Derived> :: moveTo(size_t newCapacity)
+{
+   T * dataNew = alloc.allocate(newCapacity);
+   relocate(dataNew, data, numElements);
+   derived().replaceBuffer(dataNew, newCapacity);
+}
+
+/***************************************
+ * VECTOR BASE :: MAKE GAP
+ * Open up num uninitialized slots starting at
+ * index. The tail is shifted once, either in
+ * place or straight into a bigger buffer.
+ *     INPUT  : index where the gap starts
+ *              num   how many slots to open
+ *     OUTPUT : the first slot of the gap
+ **************************************/
+template <typename T, typename A, typename Derived>
+T * vector_base <T, A, Derived> :: makeGap(size_t index, size_t num)
+{
+   assert(index <= numElements);
+
+   //There is room so just slide the tail over
+   if (numElements + num <= numCapacity)
+   {
+      relocate(data + index + num, data + index, numElements - index);
+      return data + index;
+   }
+
+   //Not enough room: grow by at least double
+   size_t newCapacity = growCapacity(numElements + num);
+
+   //Move the head and the tail straight to where they belong
+   T * dataNew = alloc.allocate(newCapacity);
+   relocate(dataNew, data, index);
+   relocate(dataNew + index + num, data + index, numElements - index);
+   derived().replaceBuffer(dataNew, newCapacity);
+   return data + index;
+}
+
+/***************************************
+ * VECTOR BASE :: INSERT FILL
+ * Put num copies of t at index. The tail only
+ * gets shifted once.
+ *     INPUT  : index where the copies go
+ *              num   how many copies
+ *              t     the value to copy
+ *     OUTPUT : the first new element
+ **************************************/
+template <typename T, typename A, typename Derived>
+T * vector_base <T, A, Derived> :: insertFill(size_t index, size_t num, const T & t)
+{
+   if (num == 0)
+      return data + index;
+
+   //t might be one of ours and about to move, so keep a copy
+   if (&t >= data && &t < data + numElements)
+   {
+      T copy(t);
+      return insertFill(index, num, copy);
+   }
+
+   //Fill the gap with copies of t
+   T * pGap = makeGap(index, num);
+   for (size_t i = 0; i < num; i++)
+      alloc.construct(pGap + i, t);
+   numElements += num;
+   return pGap;
+}
+
+/***************************************
+ * VECTOR BASE :: INSERT RANGE
+ * A forward iterator can be walked twice, so
+ * std::distance tells us how big a gap to open.
+ *     INPUT  : index where the elements go
+ *              first the first element to copy
+ *              last  one past the last element to copy
+ *     OUTPUT : the first new element
+ **************************************/
+template <typename T, typename A, typename Derived>
+template <class Iterator>
+T * vector_base <T, A, Derived> :: insertRange(size_t index, Iterator first, Iterator last, std::forward_iterator_tag)
+{
+   size_t num = std::distance(first, last);
+   if (num == 0)
+      return data + index;
+
+   //Copy them into the gap
+   T * pGap = makeGap(index, num);
+   for (size_t i = 0; i < num; i++, ++first)
+      alloc.construct(pGap + i, *first);
+   numElements += num;
+   return pGap;
+}
+
+/***************************************
+ * VECTOR BASE :: INSERT RANGE
+ * An input iterator (a stream, say) can only be
+ * read once, so the elements are collected in a
+ * scratch container and then moved into the gap.
+ *     INPUT  : index where the elements go
+ *              first the first element to copy
+ *              last  one past the last element to copy
+ *     OUTPUT : the first new element
+ **************************************/
+template <typename T, typename A, typename Derived>
+template <class Iterator>
+T * vector_base <T, A, Derived> :: insertRange(size_t index, Iterator first, Iterator last, std::input_iterator_tag)
+{
+   Derived scratch(alloc);
+   vector_base & base = scratch;
+   for (; first != last; ++first)
+      base.push_back(*first);
+   if (base.numElements == 0)
+      return data + index;
+
+   //The scratch buffer's slots are left destroyed
+   T * pGap = makeGap(index, base.numElements);
+   relocate(pGap, base.data, base.numElements);
+   numElements += base.numElements;
+   base.numElements = 0;
+   return pGap;
+}
+
+/***************************************
+ * VECTOR BASE :: ERASE RANGE
+ * Remove the elements [indexFirst, indexLast) and
+ * slide the tail down over them in one pass. The
+ * buffer stays where it is.
+ *     INPUT  : indexFirst the first element to remove
+ *              indexLast  one past the last one to remove
+ *     OUTPUT : the element after the last removed
+ **************************************/
+template <typename T, typename A, typename Derived>
+T * vector_base <T, A, Derived> :: eraseRange(size_t indexFirst, size_t indexLast)
+{
+   assert(indexFirst <= indexLast && indexLast <= numElements);
+
+   //Destroy the doomed elements and close the gap
+   for (size_t i = indexFirst; i < indexLast; i++)
+      alloc.destroy(data + i);
+   relocate(data + indexFirst, data + indexLast, numElements - indexLast);
+   numElements -= indexLast - indexFirst;
+   return data + indexFirst;
+}
+
 /*****************************************
  * VECTOR
  * Just like the std :: vector <T> class
  ****************************************/
 template <typename T, typename A = std::allocator<T>>
-class vector
+class vector : public vector_base<T, A, vector<T, A>>
 {
    friend class ::TestVector; // give unit tests access to the privates
    friend class ::TestStack;
    friend class ::TestPQueue;
    friend class ::TestHash;
+   typedef vector_base<T, A, vector> base;
+   friend base;
 public:
    
    //
@@ -69,10 +495,37 @@ public:
    vector & operator = (const vector & rhs);
    vector & operator = (vector&& rhs);
 
+   //
+   // Ownership of the buffer
+   //
+   struct buffer
+   {
+      T *    data;            // from an allocator equal to ours
+      size_t numElements;     // constructed elements at the front
+      size_t numCapacity;     // slots the buffer was allocated with
+   };
+   void adopt(T * p, size_t numElements, size_t numCapacity);
+   void adopt(T * p, size_t numElements, size_t numCapacity, const A & a)
+   {
+      adopt(p, numElements, numCapacity);
+      alloc = a;
+   }
+   buffer release()
+   {
+      //Hand the buffer over and forget it; the caller destroys and frees it
+      buffer b = { data, numElements, numCapacity };
+      data = nullptr;
+      numElements = 0;
+      numCapacity = 0;
+      return b;
+   }
+   A get_allocator() const { return alloc; }
+
    //
    // Iterator
    //
    class iterator;
+   class const_iterator;
    iterator begin() 
    { 
       return iterator(data);
@@ -81,6 +534,10 @@ public:
    { 
       return iterator(data + numElements);
    }
+   const_iterator begin()  const { return const_iterator(data);               }
+   const_iterator end()    const { return const_iterator(data + numElements); }
+   const_iterator cbegin() const { return const_iterator(data);               }
+   const_iterator cend()   const { return const_iterator(data + numElements); }
 
    //
    // Access
@@ -95,59 +552,77 @@ public:
    //
    // Insert
    //
-   void push_back(const T& t);
-   void push_back(T&& t);
+   using base::push_back;
+   using base::resize_default_init;
    void reserve(size_t newCapacity);
    void resize(size_t newElements);
    void resize(size_t newElements, const T& t);
+   iterator insert(iterator pos, size_t num, const T& t);
+   template <class Iterator,
+             class = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
+   iterator insert(iterator pos, Iterator first, Iterator last);
 
    //
    // Remove
    //
-   void clear()
-   {
-      //Remove all the elements and reset the whole thing
-      for (size_t i = 0; i < numElements; ++i)
-         alloc.destroy(data + i);
-      numElements = 0;
-   }
-   
-   void pop_back()
-   {
-      //If it's not empty then remove the last element
-      if (!empty())
-      {
-         alloc.destroy(data + (numElements - 1));
-         numElements -= 1;
-      }
-   }
+   using base::clear;
+   iterator erase(iterator first, iterator last);
    void shrink_to_fit();
 
+   //
+   // Bulk update
+   //
+   void fill(const T& t);
+   template <class F>
+   void transform(F f);
+   template <class U, class B, class F>
+   void transform(const vector<U, B>& src, F f);
+
    //
    // Status
    //
-   size_t  size()          const { return numElements;}
-   size_t  capacity()      const { return numCapacity;}
-   bool empty()            const { return numElements == 0;}
+   using base::size;
+   using base::capacity;
+   using base::empty;
   
 private:
-   
-   A    alloc;                // use allocator for memory allocation
-   T *  data;                 // user data, a dynamically-allocated array
-   size_t  numCapacity;       // the capacity of the array
-   size_t  numElements;       // the number of items currently used
+   using base::alloc;
+   using base::data;
+   using base::numCapacity;
+   using base::numElements;
+   using base::relocate;
+
+   // free the old buffer, its elements already moved out, and take dataNew
+   void replaceBuffer(T * dataNew, size_t newCapacity)
+   {
+      if (numCapacity)
+         alloc.deallocate(data, numCapacity);
+      data = dataNew;
+      numCapacity = newCapacity;
+   }
+
+   // is a job on num elements big enough to split across threads?
+   static bool isParallel(size_t num)
+   {
+      return std::is_trivially_copyable<T>::value &&
+             num * sizeof(T) >= parallel_threshold();
+   }
+
+   // construct num elements in raw memory, in parallel when it pays
+   void copyConstruct(T * pDest, const T * pSource, size_t num);
+   void fillConstruct(T * pDest, size_t num, const T & t);
+
+   // let the allocator resize the buffer, if it knows how
+   bool reallocate(size_t newCapacity, std::true_type);
+   bool reallocate(size_t, std::false_type) { return false; }
 };
 
 /**************************************************
  * VECTOR ITERATOR
- * An iterator through vector.  You only need to
- * support the following:
- *   1. Constructors (default and copy)
- *   2. Not equals operator
- *   3. Increment (prefix and postfix)
- *   4. Dereference
- * This particular iterator is a bi-directional meaning
- * that ++ and -- both work.  Not all iterators are that way.
+ * An iterator through vector. The elements are
+ * contiguous, so this is a random-access iterator
+ * and the standard algorithms (sort, lower_bound,
+ * distance, ...) can jump around in constant time.
  *************************************************/
 template <typename T, typename A>
 class vector <T, A> ::iterator
@@ -156,7 +631,16 @@ class vector <T, A> ::iterator
    friend class ::TestStack;
    friend class ::TestPQueue;
    friend class ::TestHash;
+   friend class vector <T, A>;
+   friend class vector <T, A> ::const_iterator;
 public:
+   // iterator traits so the standard algorithms know what we are
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef T *                             pointer;
+   typedef T &                             reference;
+
    // constructors, destructors, and assignment operator
    iterator()                           : p(nullptr)        {  }
    iterator(T* p)                       : p(p)              {  }
@@ -168,15 +652,28 @@ public:
       return *this;
    }
 
-   // equals, not equals operator
-   bool operator != (const iterator& rhs) const { return this->p != rhs.p; }
-   bool operator == (const iterator& rhs) const { return this->p == rhs.p; }
+   // equals, not equals and relative order. Mixing in a const_iterator,
+   // on either side, uses const_iterator's operators
+   friend bool operator == (const iterator& lhs, const iterator& rhs) { return lhs.p == rhs.p; }
+   friend bool operator != (const iterator& lhs, const iterator& rhs) { return lhs.p != rhs.p; }
+   friend bool operator <  (const iterator& lhs, const iterator& rhs) { return lhs.p <  rhs.p; }
+   friend bool operator >  (const iterator& lhs, const iterator& rhs) { return lhs.p >  rhs.p; }
+   friend bool operator <= (const iterator& lhs, const iterator& rhs) { return lhs.p <= rhs.p; }
+   friend bool operator >= (const iterator& lhs, const iterator& rhs) { return lhs.p >= rhs.p; }
 
    // dereference operator
-   T& operator * ()
+   T& operator * () const
    {
       return *(p);
    }
+   T* operator -> () const
+   {
+      return p;
+   }
+   T& operator [] (difference_type n) const
+   {
+      return p[n];
+   }
 
    // prefix increment
    iterator& operator ++ ()
@@ -208,10 +705,115 @@ public:
       return it;
    }
 
+   // jump n elements
+   iterator& operator += (difference_type n) { this->p += n; return *this; }
+   iterator& operator -= (difference_type n) { this->p -= n; return *this; }
+   iterator  operator +  (difference_type n) const { return iterator(p + n); }
+   iterator  operator -  (difference_type n) const { return iterator(p - n); }
+   friend iterator operator + (difference_type n, const iterator& it) { return it + n; }
+
+   // distance between two iterators
+   friend difference_type operator - (const iterator& lhs, const iterator& rhs) { return lhs.p - rhs.p; }
+
 private:
    T* p;
 };
 
+/**************************************************
+ * VECTOR CONST ITERATOR
+ * The same as iterator, but the elements can only
+ * be read. Any iterator converts to one of these.
+ *************************************************/
+template <typename T, typename A>
+class vector <T, A> ::const_iterator
+{
+   friend class ::TestVector; // give unit tests access to the privates
+   friend class ::TestStack;
+   friend class ::TestPQueue;
+   friend class ::TestHash;
+   friend class vector <T, A>;
+public:
+   // iterator traits so the standard algorithms know what we are
+   typedef std::random_access_iterator_tag iterator_category;
+   typedef T                               value_type;
+   typedef std::ptrdiff_t                  difference_type;
+   typedef const T *                       pointer;
+   typedef const T &                       reference;
+
+   // constructors, destructors, and assignment operator
+   const_iterator()                          : p(nullptr)   {  }
+   const_iterator(const T* p)                : p(p)         {  }
+   const_iterator(const const_iterator& rhs) : p(rhs.p)     {  }
+   const_iterator(const iterator& rhs)       : p(rhs.p)     {  }
+   const_iterator& operator = (const const_iterator& rhs)
+   {
+      this->p = rhs.p;
+      return *this;
+   }
+
+   // equals, not equals and relative order. Either side may be an
+   // iterator, which converts
+   friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p == rhs.p; }
+   friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p != rhs.p; }
+   friend bool operator <  (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p <  rhs.p; }
+   friend bool operator >  (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p >  rhs.p; }
+   friend bool operator <= (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p <= rhs.p; }
+   friend bool operator >= (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p >= rhs.p; }
+
+   // dereference operator
+   const T& operator * () const
+   {
+      return *(p);
+   }
+   const T* operator -> () const
+   {
+      return p;
+   }
+   const T& operator [] (difference_type n) const
+   {
+      return p[n];
+   }
+
+   // prefix and postfix increment
+   const_iterator& operator ++ ()
+   {
+      this->p += 1;
+      return *this;
+   }
+   const_iterator operator ++ (int postfix)
+   {
+      const_iterator it = *this;
+      this->p += 1;
+      return it;
+   }
+
+   // prefix and postfix decrement
+   const_iterator& operator -- ()
+   {
+      this->p -= 1;
+      return *this;
+   }
+   const_iterator operator -- (int postfix)
+   {
+      const_iterator it = *this;
+      this->p -= 1;
+      return it;
+   }
+
+   // jump n elements
+   const_iterator& operator += (difference_type n) { this->p += n; return *this; }
+   const_iterator& operator -= (difference_type n) { this->p -= n; return *this; }
+   const_iterator  operator +  (difference_type n) const { return const_iterator(p + n); }
+   const_iterator  operator -  (difference_type n) const { return const_iterator(p - n); }
+   friend const_iterator operator + (difference_type n, const const_iterator& it) { return it + n; }
+
+   // distance between two iterators
+   friend difference_type operator - (const const_iterator& lhs, const const_iterator& rhs) { return lhs.p - rhs.p; }
+
+private:
+   const T* p;
+};
+
 
 /*****************************************
  * VECTOR :: NON-DEFAULT constructors
@@ -219,9 +821,8 @@ private:
  * construct each element, and copy the values over
  ****************************************/
 template <typename T, typename A>
-vector <T, A> :: vector(const A & a) : alloc(a), numCapacity(0), numElements(0)
+vector <T, A> :: vector(const A & a) : base(a, nullptr, 0)
 {
-   data = nullptr;
 }
 
 
@@ -231,15 +832,14 @@ vector <T, A> :: vector(const A & a) : alloc(a), numCapacity(0), numElements(0)
  * construct each element, and copy the values over
  ****************************************/
 template <typename T, typename A>
-vector <T, A> :: vector(size_t num, const T & t, const A & a): alloc(a), numCapacity(num), numElements(num)
+vector <T, A> :: vector(size_t num, const T & t, const A & a): base(a, nullptr, num)
 {
    // Allocate memory using the allocator
    data = alloc.allocate(num);
+   numElements = num;
 
    // Use the allocator to construct each element with the value `t`
-   for (size_t i = 0; i < num; ++i)
-       alloc.construct(data + i, t);
-   
+   fillConstruct(data, num, t);
 }
 
 /*****************************************
@@ -247,10 +847,11 @@ vector <T, A> :: vector(size_t num, const T & t, const A & a): alloc(a), numCapa
  * Create a vector with an initialization list.
  ****************************************/
 template <typename T, typename A>
-vector <T, A> :: vector(const std::initializer_list<T> & l, const A & a) : alloc(a), numCapacity(l.size()), numElements(l.size())
+vector <T, A> :: vector(const std::initializer_list<T> & l, const A & a) : base(a, nullptr, l.size())
 {
    // Allocate memory for the elements
    data = alloc.allocate(l.size());
+   numElements = l.size();
 
    // Copy elements from the initializer list to the vector
    auto it = l.begin();
@@ -265,13 +866,10 @@ vector <T, A> :: vector(const std::initializer_list<T> & l, const A & a) : alloc
  * construct each element, and copy the values over
  ****************************************/
 template <typename T, typename A>
-vector <T, A> :: vector(size_t num, const A & a) : alloc(a), numCapacity(num), numElements(num)
+vector <T, A> :: vector(size_t num, const A & a) : base(a, nullptr, 0)
 {
-   // Allocate memory if num > 0, otherwise set data to nullptr
-   if (num > 0)
-      data = new T[num];
-   else
-      data = nullptr;
+   // Default-initialize num elements from the allocator
+   resize_default_init(num);
 }
 
 /*****************************************
@@ -280,22 +878,15 @@ vector <T, A> :: vector(size_t num, const A & a) : alloc(a), numCapacity(num), n
  * call the copy constructor on each element
  ****************************************/
 template <typename T, typename A>
-vector <T, A> :: vector (const vector & rhs) : alloc(rhs.alloc), numCapacity(rhs.numElements), numElements(rhs.numElements)
+vector <T, A> :: vector (const vector & rhs) : base(rhs.alloc, nullptr, 0)
 {
    if (!rhs.empty())
    {
       // Allocate memory and copy elements from rhs
       data = alloc.allocate(rhs.numElements);
-      for (int i = 0; i < numElements; i++)
-         alloc.construct(data + i, rhs.data[i]);
-      
-   }
-   else 
-   {
-      // Set data to nullptr if rhs is empty
-      data = nullptr;
-      numElements = 0;
-      numCapacity = 0;
+      copyConstruct(data, rhs.data, rhs.numElements);
+      numCapacity = rhs.numElements;
+      numElements = rhs.numElements;
    }
 }
    
@@ -304,8 +895,10 @@ vector <T, A> :: vector (const vector & rhs) : alloc(rhs.alloc), numCapacity(rhs
  * Steal the values from the RHS and set it to zero.
  ****************************************/
 template <typename T, typename A>
-vector <T, A> :: vector (vector && rhs) : numCapacity(rhs.numCapacity), numElements(rhs.numElements), data(rhs.data)
+vector <T, A> :: vector (vector && rhs) : base(rhs.alloc, rhs.data, rhs.numCapacity)
 {
+   numElements = rhs.numElements;
+
    // Set rhss data to nullptr is empty
    rhs.data = nullptr;
    rhs.numCapacity = 0;
@@ -369,14 +962,21 @@ void vector <T, A> :: resize(size_t newElements, const T & t)
    if (newElements < numElements)
       for (size_t i = newElements; i < numElements; i++)
          alloc.destroy(data + i);
+
+   //t might be one of ours and about to move, so keep a copy
+   else if (newElements > numCapacity && &t >= data && &t < data + numElements)
+   {
+      T copy(t);
+      resize(newElements, copy);
+      return;
+   }
    
    //New size is made and any extra spots are filled with t
    else if (newElements > numElements)
    {
       if (newElements > numCapacity)
          reserve(newElements);
-      for (size_t i = numElements; i < newElements; i++)
-         new (&data[i]) T(t);
+      fillConstruct(data + numElements, newElements - numElements, t);
    }
    numElements = newElements;
 }
@@ -396,17 +996,33 @@ void vector <T, A> :: reserve(size_t newCapacity)
    if (newCapacity <= numCapacity)
       return;
    
+   //The allocator might be able to grow it where it is
+   if (reallocate(newCapacity, has_reallocate<A>()))
+      return;
+
    //Make new space as needed and move elements
-   T * dataNew = alloc.allocate(newCapacity);
-   for (auto i = 0; i < numElements; i++) 
-      new ((void*)(dataNew + i)) T(std::move(data[i]));
-   
-   //Destroy old elements after move is complete
-   for (size_t i = 0; i < numElements; ++i)
-      alloc.destroy(data + i);
-   alloc.deallocate(data, numCapacity);
-   data = dataNew;
+   this->moveTo(newCapacity);
+}
+
+/***************************************
+ * VECTOR :: REALLOCATE
+ * Hand the buffer to an allocator that can resize
+ * it without us copying every element. Only bytes
+ * can be carried over, so the elements must be
+ * trivially relocatable.
+ *     INPUT  : newCapacity the size of the new buffer
+ *     OUTPUT : true if the allocator did the work
+ **************************************/
+template <typename T, typename A>
+bool vector <T, A> :: reallocate(size_t newCapacity, std::true_type)
+{
+   //Nothing to carry over or we can't copy bytes
+   if (!is_trivially_relocatable<T>::value || numCapacity == 0 || newCapacity == 0)
+      return false;
+
+   data = alloc.reallocate(data, numCapacity, newCapacity, numElements);
    numCapacity = newCapacity;
+   return true;
 }
 
 /***************************************
@@ -424,16 +1040,26 @@ void vector <T, A> :: shrink_to_fit()
       if (numElements == numCapacity)
          return;
 
+      //The allocator might be able to give back the tail in place
+      if (reallocate(numElements, has_reallocate<A>()))
+         return;
+
       //Allocate new spot for smaller vector
       T * dataNew = alloc.allocate(numElements);
 
-      //Create our vector in the new spot
-      for (size_t i = 0; i < numElements; i++)
-         alloc.construct(&dataNew[i], data[i]);
+      //Relocatable elements can just be moved over in bulk
+      if (is_trivially_relocatable<T>::value)
+         relocate(dataNew, data, numElements);
+      else
+      {
+         //Create our vector in the new spot
+         for (size_t i = 0; i < numElements; i++)
+            alloc.construct(&dataNew[i], data[i]);
 
-      //Destroy the vector in the old spot
-      for (size_t i = 0; i < numElements; ++i)
-         alloc.destroy(&data[i]);
+         //Destroy the vector in the old spot
+         for (size_t i = 0; i < numElements; ++i)
+            alloc.destroy(&data[i]);
+      }
       alloc.deallocate(data, numCapacity);
 
       //Update members
@@ -450,6 +1076,55 @@ void vector <T, A> :: shrink_to_fit()
 
 }
 
+/***************************************
+ * VECTOR :: INSERT
+ * Put num copies of t in front of pos. The tail
+ * only gets shifted once.
+ *     INPUT  : pos where the copies go
+ *              num how many copies
+ *              t   the value to copy
+ *     OUTPUT : an iterator to the first new element
+ **************************************/
+template <typename T, typename A>
+typename vector <T, A> :: iterator vector <T, A> :: insert(iterator pos, size_t num, const T & t)
+{
+   return iterator(this->insertFill(pos.p - data, num, t));
+}
+
+/***************************************
+ * VECTOR :: INSERT
+ * Put the elements [first, last) in front of pos.
+ * The buffer is sized and the tail is shifted
+ * exactly once. Integers are not iterators:
+ * insert(pos, 3, 5) on a vector of int is a count
+ * and a value, not a range.
+ *     INPUT  : pos   where the elements go
+ *              first the first element to copy
+ *              last  one past the last element to copy
+ *     OUTPUT : an iterator to the first new element
+ **************************************/
+template <typename T, typename A>
+template <class Iterator, class>
+typename vector <T, A> :: iterator vector <T, A> :: insert(iterator pos, Iterator first, Iterator last)
+{
+   return iterator(this->insertRange(pos.p - data, first, last,
+                   typename std::iterator_traits<Iterator>::iterator_category()));
+}
+
+/***************************************
+ * VECTOR :: ERASE
+ * Remove the elements [first, last) and slide
+ * the tail down over them in one pass.
+ *     INPUT  : first the first element to remove
+ *              last  one past the last one to remove
+ *     OUTPUT : an iterator to the element after the last removed
+ **************************************/
+template <typename T, typename A>
+typename vector <T, A> :: iterator vector <T, A> :: erase(iterator first, iterator last)
+{
+   return iterator(this->eraseRange(first.p - data, last.p - data));
+}
+
 /*****************************************
  * VECTOR :: SUBSCRIPT
  * Read-Write access
@@ -511,38 +1186,6 @@ const T & vector <T, A> :: back() const
    return data[numElements - 1];
 }
 
-/***************************************
- * VECTOR :: PUSH BACK
- * This method will add the element 't' to the
- * end of the current buffer.  It will also grow
- * the buffer as needed to accomodate the new element
- *     INPUT  : 't' the new element to be added
- *     OUTPUT : *this
- **************************************/
-template <typename T, typename A>
-void vector <T, A> :: push_back (const T & t)
-{
-   //Our vector was empty so make a single spot
-   if (capacity() == 0)
-      reserve(1);
-   //Double the size if needed and put our element in
-   if (size() == capacity())
-      reserve(capacity() * 2);
-   new ((void*)(&data[numElements++])) T(t);
-}
-
-template <typename T, typename A>
-void vector <T, A> ::push_back(T && t)
-{
-   //Our vector was empty so make a single spot
-   if (capacity() == 0)
-      reserve(1);
-   //Double the size if needed and put our element in
-   if (size() == capacity())
-      reserve(capacity() * 2);
-   new ((void*)(&data[numElements++])) T(std::move(t));
-}
-
 /***************************************
  * VECTOR :: ASSIGNMENT
  * This operator will copy the contents of the
@@ -553,6 +1196,22 @@ void vector <T, A> ::push_back(T && t)
 template <typename T, typename A>
 vector <T, A> & vector <T, A> :: operator = (const vector & rhs)
 {
+   //Big trivially copyable vectors are just bytes, copied a chunk per thread
+   if (isParallel(rhs.size()) && this != &rhs)
+   {
+      if (rhs.size() > capacity())
+      {
+         T * dataNew = alloc.allocate(rhs.size());
+         if (numCapacity)
+            alloc.deallocate(data, numCapacity);
+         data = dataNew;
+         numCapacity = rhs.size();
+      }
+      copyConstruct(data, rhs.data, rhs.size());
+      numElements = rhs.size();
+      return *this;
+   }
+
    //Vectors are the same size, just move data
    if (rhs.size() == size())
       for (size_t i = 0; i < size(); i++)
@@ -613,6 +1272,164 @@ vector <T, A>& vector <T, A> :: operator = (vector&& rhs)//change the
    return *this;
 }
 
+/***************************************
+ * VECTOR :: ADOPT
+ * Take ownership of a buffer that someone else
+ * filled, without copying it. The buffer must come
+ * from an allocator that compares equal to ours, and
+ * its first numElements slots must hold constructed
+ * elements. Whatever we held before is freed.
+ *     INPUT  : p           the buffer, or nullptr if numCapacity is 0
+ *              numElements how many elements are in it
+ *              numCapacity how many it was allocated for
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A>
+void vector <T, A> :: adopt(T * p, size_t numElements, size_t numCapacity)
+{
+   assert(numElements <= numCapacity);
+   assert(p != nullptr || numCapacity == 0);
+
+   //Let go of what we have, unless it is the same buffer
+   if (p != data)
+   {
+      clear();
+      if (this->numCapacity)
+         alloc.deallocate(data, this->numCapacity);
+   }
+
+   data = p;
+   this->numElements = numElements;
+   this->numCapacity = numCapacity;
+}
+
+/***************************************
+ * VECTOR :: FILL
+ * Set every element to t. Big trivially
+ * copyable vectors do this a chunk per thread.
+ *     INPUT  : t the new value of every element
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A>
+void vector <T, A> :: fill(const T & t)
+{
+   //Assigning a trivially copyable type is the same as constructing it
+   if (isParallel(numElements))
+      fillConstruct(data, numElements, t);
+   else
+      for (size_t i = 0; i < numElements; i++)
+         data[i] = t;
+}
+
+/***************************************
+ * VECTOR :: TRANSFORM
+ * Replace every element x with f(x). When the
+ * vector is big enough f is called from several
+ * threads at once, so it must be safe for that.
+ *     INPUT  : f the function to apply
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A>
+template <class F>
+void vector <T, A> :: transform(F f)
+{
+   T * p = data;
+   auto apply = [p, &f](size_t begin, size_t end)
+   {
+      for (size_t i = begin; i < end; i++)
+         p[i] = f(p[i]);
+   };
+   if (isParallel(numElements))
+      thread_pool::instance().parallel_for(numElements, apply);
+   else
+      apply(0, numElements);
+}
+
+/***************************************
+ * VECTOR :: TRANSFORM FROM
+ * Make this vector hold f(x) for every x in
+ * src. As above, f may run on several threads.
+ * src must not be this vector; use transform(f).
+ *     INPUT  : src the vector to read from
+ *              f   the function to apply
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A>
+template <class U, class B, class F>
+void vector <T, A> :: transform(const vector <U, B> & src, F f)
+{
+   //The slots can be written directly, a chunk per thread
+   if (isParallel(src.size()))
+   {
+      resize_default_init(src.size());
+      T * p = data;
+      thread_pool::instance().parallel_for(src.size(), [p, &src, &f](size_t begin, size_t end)
+      {
+         for (size_t i = begin; i < end; i++)
+            p[i] = f(src[i]);
+      });
+      return;
+   }
+
+   //Otherwise build each element in turn
+   clear();
+   reserve(src.size());
+   for (size_t i = 0; i < src.size(); i++)
+   {
+      alloc.construct(data + i, f(src[i]));
+      numElements++;
+   }
+}
+
+/***************************************
+ * VECTOR :: COPY CONSTRUCT
+ * Copy-construct num elements into raw memory.
+ * Trivially copyable elements are just bytes, so
+ * a big copy is split across the thread pool. Each
+ * thread touches its pages first, which spreads
+ * them over the memory close to the workers.
+ *     INPUT  : pDest   raw memory for num elements
+ *              pSource the elements to copy
+ *              num     how many
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A>
+void vector <T, A> :: copyConstruct(T * pDest, const T * pSource, size_t num)
+{
+   if (isParallel(num))
+      thread_pool::instance().parallel_for(num, [pDest, pSource](size_t begin, size_t end)
+      {
+         std::memcpy((void *)(pDest + begin), (const void *)(pSource + begin),
+                     (end - begin) * sizeof(T));
+      });
+   else
+      for (size_t i = 0; i < num; i++)
+         alloc.construct(pDest + i, pSource[i]);
+}
+
+/***************************************
+ * VECTOR :: FILL CONSTRUCT
+ * Construct num copies of t in raw memory,
+ * split across the thread pool when it is big
+ *     INPUT  : pDest raw memory for num elements
+ *              num   how many
+ *              t     the value to copy
+ *     OUTPUT :
+ **************************************/
+template <typename T, typename A>
+void vector <T, A> :: fillConstruct(T * pDest, size_t num, const T & t)
+{
+   if (isParallel(num))
+      thread_pool::instance().parallel_for(num, [pDest, &t](size_t begin, size_t end)
+      {
+         for (size_t i = begin; i < end; i++)
+            new ((void *)(pDest + i)) T(t);
+      });
+   else
+      for (size_t i = 0; i < num; i++)
+         alloc.construct(pDest + i, t);
+}
+
 
 
 
@@ -0,0 +1,910 @@
+/***********************************************************************
+ * Header:
+ *    VECTOR SIMD
+ * Summary:
+ *    Search and reduction kernels over custom::vector. Vectors of
+ *    int32_t, float and uint64_t use AVX2 or SSE4.2 when the CPU has
+ *    them, picked once at runtime; everything else uses a scalar loop.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the definition of:
+ *        find, count, contains  : Look for a value
+ *        min_element            : Where is the smallest value?
+ *        max_element            : Where is the largest value?
+ *        sum, dot               : Add up one or two vectors
+ *        mismatch               : Where do two vectors first differ?
+ *        simd::level            : Which instruction set are we using?
+ * Author
+ *    Jacob Mower
+ *    Elroe Woldemichael
+ *    Thatcher Albiston
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t and uint64_t
+#include <bitset>   // for counting the bits in a mask
+#include <utility>  // for std::pair
+#include "vector.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CUSTOM_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CUSTOM_TARGET(isa)
+#else
+#define CUSTOM_TARGET(isa) __attribute__((target(isa)))
+#endif // _MSC_VER
+#endif // x86
+
+namespace custom
+{
+namespace simd
+{
+
+/*****************************************
+ * LEVEL
+ * The instruction sets we have kernels for
+ ****************************************/
+enum Level { SCALAR = 0, SSE42 = 1, AVX2 = 2 };
+
+/*****************************************
+ * DETECT
+ * Ask the CPU what it can do
+ ****************************************/
+inline Level detect()
+{
+#ifdef CUSTOM_SIMD_X86
+#ifdef _MSC_VER
+   int info[4];
+   __cpuid(info, 0);
+   int numLeaves = info[0];
+   __cpuid(info, 1);
+   bool sse42   = (info[2] & (1 << 20)) != 0;
+   bool osxsave = (info[2] & (1 << 27)) != 0;
+   bool avx     = (info[2] & (1 << 28)) != 0;
+   if (numLeaves >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+   {
+      __cpuidex(info, 7, 0);
+      if (info[1] & (1 << 5))
+         return AVX2;
+   }
+   if (sse42)
+      return SSE42;
+#else
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2"))
+      return AVX2;
+   if (__builtin_cpu_supports("sse4.2"))
+      return SSE42;
+#endif // _MSC_VER
+#endif // CUSTOM_SIMD_X86
+   return SCALAR;
+}
+
+/*****************************************
+ * LEVEL
+ * The instruction set the kernels dispatch to.
+ * It is found once, and can be turned down (never
+ * up) with setLevel() for testing and benchmarks.
+ ****************************************/
+inline Level & currentLevel()
+{
+   static Level current = detect();
+   return current;
+}
+inline Level level()
+{
+   return currentLevel();
+}
+inline void setLevel(Level newLevel)
+{
+   Level best = detect();
+   currentLevel() = newLevel < best ? newLevel : best;
+}
+
+/*****************************************
+ * BITS
+ * Find and count the set bits of a compare mask
+ ****************************************/
+inline unsigned firstBit(unsigned mask)
+{
+#ifdef _MSC_VER
+   unsigned long index;
+   _BitScanForward(&index, mask);
+   return (unsigned)index;
+#else
+   return (unsigned)__builtin_ctz(mask);
+#endif // _MSC_VER
+}
+inline size_t countBits(unsigned mask)
+{
+   return std::bitset<32>(mask).count();
+}
+
+/*****************************************
+ * SCALAR KERNELS
+ * The plain loops. Every type can use these
+ * and they finish off the tail of the SIMD ones.
+ ****************************************/
+template <typename T>
+size_t findScalar(const T * p, size_t num, const T & value, size_t i = 0)
+{
+   for (; i < num; i++)
+      if (p[i] == value)
+         return i;
+   return num;
+}
+
+template <typename T>
+size_t countScalar(const T * p, size_t num, const T & value, size_t i = 0)
+{
+   size_t numFound = 0;
+   for (; i < num; i++)
+      if (p[i] == value)
+         numFound++;
+   return numFound;
+}
+
+template <typename T>
+size_t minScalar(const T * p, size_t num)
+{
+   size_t iMin = 0;
+   for (size_t i = 1; i < num; i++)
+      if (p[i] < p[iMin])
+         iMin = i;
+   return iMin;
+}
+
+template <typename T>
+size_t maxScalar(const T * p, size_t num)
+{
+   size_t iMax = 0;
+   for (size_t i = 1; i < num; i++)
+      if (p[iMax] < p[i])
+         iMax = i;
+   return iMax;
+}
+
+template <typename T>
+T sumScalar(const T * p, size_t num, size_t i = 0)
+{
+   T total = T();
+   for (; i < num; i++)
+      total += p[i];
+   return total;
+}
+
+template <typename T>
+T dotScalar(const T * p1, const T * p2, size_t num, size_t i = 0)
+{
+   T total = T();
+   for (; i < num; i++)
+      total += p1[i] * p2[i];
+   return total;
+}
+
+// int32_t adds and multiplies as uint32_t so that overflow wraps
+// rather than being undefined
+inline int32_t sumScalar(const int32_t * p, size_t num, size_t i = 0)
+{
+   uint32_t total = 0;
+   for (; i < num; i++)
+      total += (uint32_t)p[i];
+   return (int32_t)total;
+}
+inline int32_t dotScalar(const int32_t * p1, const int32_t * p2, size_t num, size_t i = 0)
+{
+   uint32_t total = 0;
+   for (; i < num; i++)
+      total += (uint32_t)p1[i] * (uint32_t)p2[i];
+   return (int32_t)total;
+}
+
+template <typename T>
+size_t mismatchScalar(const T * p1, const T * p2, size_t num, size_t i = 0)
+{
+   for (; i < num; i++)
+      if (!(p1[i] == p2[i]))
+         return i;
+   return num;
+}
+
+#ifdef CUSTOM_SIMD_X86
+
+/*****************************************
+ * AVX2 KERNELS
+ * Eight int32_t or float, or four uint64_t, at a time
+ ****************************************/
+CUSTOM_TARGET("avx2") inline unsigned maskAVX2(__m256i eq)
+{
+   return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(eq));
+}
+CUSTOM_TARGET("avx2") inline unsigned maskAVX2(__m256 eq)
+{
+   return (unsigned)_mm256_movemask_ps(eq);
+}
+CUSTOM_TARGET("avx2") inline unsigned mask64AVX2(__m256i eq)
+{
+   return (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(eq));
+}
+CUSTOM_TARGET("avx2") inline __m256i loadAVX2(const int32_t * p)
+{
+   return _mm256_loadu_si256((const __m256i *)p);
+}
+CUSTOM_TARGET("avx2") inline __m256i loadAVX2(const uint64_t * p)
+{
+   return _mm256_loadu_si256((const __m256i *)p);
+}
+CUSTOM_TARGET("avx2") inline __m256 loadAVX2(const float * p)
+{
+   return _mm256_loadu_ps(p);
+}
+CUSTOM_TARGET("avx2") inline __m256i equalAVX2(__m256i a, __m256i b)
+{
+   return _mm256_cmpeq_epi32(a, b);
+}
+CUSTOM_TARGET("avx2") inline __m256 equalAVX2(__m256 a, __m256 b)
+{
+   return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+}
+
+// find
+CUSTOM_TARGET("avx2") inline size_t findAVX2(const int32_t * p, size_t num, int32_t value)
+{
+   __m256i key = _mm256_set1_epi32(value);
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      if (unsigned mask = maskAVX2(equalAVX2(loadAVX2(p + i), key)))
+         return i + firstBit(mask);
+   return findScalar(p, num, value, i);
+}
+CUSTOM_TARGET("avx2") inline size_t findAVX2(const float * p, size_t num, float value)
+{
+   __m256 key = _mm256_set1_ps(value);
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      if (unsigned mask = maskAVX2(equalAVX2(loadAVX2(p + i), key)))
+         return i + firstBit(mask);
+   return findScalar(p, num, value, i);
+}
+CUSTOM_TARGET("avx2") inline size_t findAVX2(const uint64_t * p, size_t num, uint64_t value)
+{
+   __m256i key = _mm256_set1_epi64x((long long)value);
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      if (unsigned mask = mask64AVX2(_mm256_cmpeq_epi64(loadAVX2(p + i), key)))
+         return i + firstBit(mask);
+   return findScalar(p, num, value, i);
+}
+
+// count
+CUSTOM_TARGET("avx2") inline size_t countAVX2(const int32_t * p, size_t num, int32_t value)
+{
+   __m256i key = _mm256_set1_epi32(value);
+   size_t numFound = 0;
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      numFound += countBits(maskAVX2(equalAVX2(loadAVX2(p + i), key)));
+   return numFound + countScalar(p, num, value, i);
+}
+CUSTOM_TARGET("avx2") inline size_t countAVX2(const float * p, size_t num, float value)
+{
+   __m256 key = _mm256_set1_ps(value);
+   size_t numFound = 0;
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      numFound += countBits(maskAVX2(equalAVX2(loadAVX2(p + i), key)));
+   return numFound + countScalar(p, num, value, i);
+}
+CUSTOM_TARGET("avx2") inline size_t countAVX2(const uint64_t * p, size_t num, uint64_t value)
+{
+   __m256i key = _mm256_set1_epi64x((long long)value);
+   size_t numFound = 0;
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      numFound += countBits(mask64AVX2(_mm256_cmpeq_epi64(loadAVX2(p + i), key)));
+   return numFound + countScalar(p, num, value, i);
+}
+
+// min and max: find the value, then where it first shows up
+CUSTOM_TARGET("avx2") inline size_t minAVX2(const int32_t * p, size_t num)
+{
+   if (num < 8)
+      return minScalar(p, num);
+   __m256i best = loadAVX2(p);
+   size_t i = 8;
+   for (; i + 8 <= num; i += 8)
+      best = _mm256_min_epi32(best, loadAVX2(p + i));
+   alignas(32) int32_t lanes[8];
+   _mm256_store_si256((__m256i *)lanes, best);
+   int32_t value = lanes[minScalar(lanes, 8)];
+   for (; i < num; i++)
+      if (p[i] < value)
+         value = p[i];
+   return findAVX2(p, num, value);
+}
+CUSTOM_TARGET("avx2") inline size_t maxAVX2(const int32_t * p, size_t num)
+{
+   if (num < 8)
+      return maxScalar(p, num);
+   __m256i best = loadAVX2(p);
+   size_t i = 8;
+   for (; i + 8 <= num; i += 8)
+      best = _mm256_max_epi32(best, loadAVX2(p + i));
+   alignas(32) int32_t lanes[8];
+   _mm256_store_si256((__m256i *)lanes, best);
+   int32_t value = lanes[maxScalar(lanes, 8)];
+   for (; i < num; i++)
+      if (value < p[i])
+         value = p[i];
+   return findAVX2(p, num, value);
+}
+CUSTOM_TARGET("avx2") inline size_t minAVX2(const float * p, size_t num)
+{
+   if (num < 8)
+      return minScalar(p, num);
+   __m256 best = loadAVX2(p);
+   size_t i = 8;
+   for (; i + 8 <= num; i += 8)
+      best = _mm256_min_ps(best, loadAVX2(p + i));
+   alignas(32) float lanes[8];
+   _mm256_store_ps(lanes, best);
+   float value = lanes[minScalar(lanes, 8)];
+   for (; i < num; i++)
+      if (p[i] < value)
+         value = p[i];
+   return findAVX2(p, num, value);
+}
+CUSTOM_TARGET("avx2") inline size_t maxAVX2(const float * p, size_t num)
+{
+   if (num < 8)
+      return maxScalar(p, num);
+   __m256 best = loadAVX2(p);
+   size_t i = 8;
+   for (; i + 8 <= num; i += 8)
+      best = _mm256_max_ps(best, loadAVX2(p + i));
+   alignas(32) float lanes[8];
+   _mm256_store_ps(lanes, best);
+   float value = lanes[maxScalar(lanes, 8)];
+   for (; i < num; i++)
+      if (value < p[i])
+         value = p[i];
+   return findAVX2(p, num, value);
+}
+
+// sum
+CUSTOM_TARGET("avx2") inline int32_t sumAVX2(const int32_t * p, size_t num)
+{
+   __m256i total = _mm256_setzero_si256();
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      total = _mm256_add_epi32(total, loadAVX2(p + i));
+   alignas(32) int32_t lanes[8];
+   _mm256_store_si256((__m256i *)lanes, total);
+   return (int32_t)((uint32_t)sumScalar(lanes, 8) + (uint32_t)sumScalar(p, num, i));
+}
+CUSTOM_TARGET("avx2") inline float sumAVX2(const float * p, size_t num)
+{
+   __m256 total = _mm256_setzero_ps();
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      total = _mm256_add_ps(total, loadAVX2(p + i));
+   alignas(32) float lanes[8];
+   _mm256_store_ps(lanes, total);
+   return sumScalar(lanes, 8) + sumScalar(p, num, i);
+}
+CUSTOM_TARGET("avx2") inline uint64_t sumAVX2(const uint64_t * p, size_t num)
+{
+   __m256i total = _mm256_setzero_si256();
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      total = _mm256_add_epi64(total, loadAVX2(p + i));
+   alignas(32) uint64_t lanes[4];
+   _mm256_store_si256((__m256i *)lanes, total);
+   return sumScalar(lanes, 4) + sumScalar(p, num, i);
+}
+
+// dot
+CUSTOM_TARGET("avx2") inline int32_t dotAVX2(const int32_t * p1, const int32_t * p2, size_t num)
+{
+   __m256i total = _mm256_setzero_si256();
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      total = _mm256_add_epi32(total, _mm256_mullo_epi32(loadAVX2(p1 + i), loadAVX2(p2 + i)));
+   alignas(32) int32_t lanes[8];
+   _mm256_store_si256((__m256i *)lanes, total);
+   return (int32_t)((uint32_t)sumScalar(lanes, 8) + (uint32_t)dotScalar(p1, p2, num, i));
+}
+CUSTOM_TARGET("avx2") inline float dotAVX2(const float * p1, const float * p2, size_t num)
+{
+   __m256 total = _mm256_setzero_ps();
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+      total = _mm256_add_ps(total, _mm256_mul_ps(loadAVX2(p1 + i), loadAVX2(p2 + i)));
+   alignas(32) float lanes[8];
+   _mm256_store_ps(lanes, total);
+   return sumScalar(lanes, 8) + dotScalar(p1, p2, num, i);
+}
+
+// mismatch
+CUSTOM_TARGET("avx2") inline size_t mismatchAVX2(const int32_t * p1, const int32_t * p2, size_t num)
+{
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+   {
+      unsigned mask = maskAVX2(equalAVX2(loadAVX2(p1 + i), loadAVX2(p2 + i)));
+      if (mask != 0xFF)
+         return i + firstBit(~mask & 0xFF);
+   }
+   return mismatchScalar(p1, p2, num, i);
+}
+CUSTOM_TARGET("avx2") inline size_t mismatchAVX2(const float * p1, const float * p2, size_t num)
+{
+   size_t i = 0;
+   for (; i + 8 <= num; i += 8)
+   {
+      unsigned mask = maskAVX2(equalAVX2(loadAVX2(p1 + i), loadAVX2(p2 + i)));
+      if (mask != 0xFF)
+         return i + firstBit(~mask & 0xFF);
+   }
+   return mismatchScalar(p1, p2, num, i);
+}
+CUSTOM_TARGET("avx2") inline size_t mismatchAVX2(const uint64_t * p1, const uint64_t * p2, size_t num)
+{
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+   {
+      unsigned mask = mask64AVX2(_mm256_cmpeq_epi64(loadAVX2(p1 + i), loadAVX2(p2 + i)));
+      if (mask != 0xF)
+         return i + firstBit(~mask & 0xF);
+   }
+   return mismatchScalar(p1, p2, num, i);
+}
+
+/*****************************************
+ * SSE4.2 KERNELS
+ * Four int32_t or float, or two uint64_t, at a time
+ ****************************************/
+CUSTOM_TARGET("sse4.2") inline unsigned maskSSE(__m128i eq)
+{
+   return (unsigned)_mm_movemask_ps(_mm_castsi128_ps(eq));
+}
+CUSTOM_TARGET("sse4.2") inline unsigned maskSSE(__m128 eq)
+{
+   return (unsigned)_mm_movemask_ps(eq);
+}
+CUSTOM_TARGET("sse4.2") inline unsigned mask64SSE(__m128i eq)
+{
+   return (unsigned)_mm_movemask_pd(_mm_castsi128_pd(eq));
+}
+CUSTOM_TARGET("sse4.2") inline __m128i loadSSE(const int32_t * p)
+{
+   return _mm_loadu_si128((const __m128i *)p);
+}
+CUSTOM_TARGET("sse4.2") inline __m128i loadSSE(const uint64_t * p)
+{
+   return _mm_loadu_si128((const __m128i *)p);
+}
+CUSTOM_TARGET("sse4.2") inline __m128 loadSSE(const float * p)
+{
+   return _mm_loadu_ps(p);
+}
+CUSTOM_TARGET("sse4.2") inline __m128i equalSSE(__m128i a, __m128i b)
+{
+   return _mm_cmpeq_epi32(a, b);
+}
+CUSTOM_TARGET("sse4.2") inline __m128 equalSSE(__m128 a, __m128 b)
+{
+   return _mm_cmpeq_ps(a, b);
+}
+
+// find
+CUSTOM_TARGET("sse4.2") inline size_t findSSE(const int32_t * p, size_t num, int32_t value)
+{
+   __m128i key = _mm_set1_epi32(value);
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      if (unsigned mask = maskSSE(equalSSE(loadSSE(p + i), key)))
+         return i + firstBit(mask);
+   return findScalar(p, num, value, i);
+}
+CUSTOM_TARGET("sse4.2") inline size_t findSSE(const float * p, size_t num, float value)
+{
+   __m128 key = _mm_set1_ps(value);
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      if (unsigned mask = maskSSE(equalSSE(loadSSE(p + i), key)))
+         return i + firstBit(mask);
+   return findScalar(p, num, value, i);
+}
+CUSTOM_TARGET("sse4.2") inline size_t findSSE(const uint64_t * p, size_t num, uint64_t value)
+{
+   __m128i key = _mm_set1_epi64x((long long)value);
+   size_t i = 0;
+   for (; i + 2 <= num; i += 2)
+      if (unsigned mask = mask64SSE(_mm_cmpeq_epi64(loadSSE(p + i), key)))
+         return i + firstBit(mask);
+   return findScalar(p, num, value, i);
+}
+
+// count
+CUSTOM_TARGET("sse4.2") inline size_t countSSE(const int32_t * p, size_t num, int32_t value)
+{
+   __m128i key = _mm_set1_epi32(value);
+   size_t numFound = 0;
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      numFound += countBits(maskSSE(equalSSE(loadSSE(p + i), key)));
+   return numFound + countScalar(p, num, value, i);
+}
+CUSTOM_TARGET("sse4.2") inline size_t countSSE(const float * p, size_t num, float value)
+{
+   __m128 key = _mm_set1_ps(value);
+   size_t numFound = 0;
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      numFound += countBits(maskSSE(equalSSE(loadSSE(p + i), key)));
+   return numFound + countScalar(p, num, value, i);
+}
+CUSTOM_TARGET("sse4.2") inline size_t countSSE(const uint64_t * p, size_t num, uint64_t value)
+{
+   __m128i key = _mm_set1_epi64x((long long)value);
+   size_t numFound = 0;
+   size_t i = 0;
+   for (; i + 2 <= num; i += 2)
+      numFound += countBits(mask64SSE(_mm_cmpeq_epi64(loadSSE(p + i), key)));
+   return numFound + countScalar(p, num, value, i);
+}
+
+// min and max: find the value, then where it first shows up
+CUSTOM_TARGET("sse4.2") inline size_t minSSE(const int32_t * p, size_t num)
+{
+   if (num < 4)
+      return minScalar(p, num);
+   __m128i best = loadSSE(p);
+   size_t i = 4;
+   for (; i + 4 <= num; i += 4)
+      best = _mm_min_epi32(best, loadSSE(p + i));
+   alignas(16) int32_t lanes[4];
+   _mm_store_si128((__m128i *)lanes, best);
+   int32_t value = lanes[minScalar(lanes, 4)];
+   for (; i < num; i++)
+      if (p[i] < value)
+         value = p[i];
+   return findSSE(p, num, value);
+}
+CUSTOM_TARGET("sse4.2") inline size_t maxSSE(const int32_t * p, size_t num)
+{
+   if (num < 4)
+      return maxScalar(p, num);
+   __m128i best = loadSSE(p);
+   size_t i = 4;
+   for (; i + 4 <= num; i += 4)
+      best = _mm_max_epi32(best, loadSSE(p + i));
+   alignas(16) int32_t lanes[4];
+   _mm_store_si128((__m128i *)lanes, best);
+   int32_t value = lanes[maxScalar(lanes, 4)];
+   for (; i < num; i++)
+      if (value < p[i])
+         value = p[i];
+   return findSSE(p, num, value);
+}
+CUSTOM_TARGET("sse4.2") inline size_t minSSE(const float * p, size_t num)
+{
+   if (num < 4)
+      return minScalar(p, num);
+   __m128 best = loadSSE(p);
+   size_t i = 4;
+   for (; i + 4 <= num; i += 4)
+      best = _mm_min_ps(best, loadSSE(p + i));
+   alignas(16) float lanes[4];
+   _mm_store_ps(lanes, best);
+   float value = lanes[minScalar(lanes, 4)];
+   for (; i < num; i++)
+      if (p[i] < value)
+         value = p[i];
+   return findSSE(p, num, value);
+}
+CUSTOM_TARGET("sse4.2") inline size_t maxSSE(const float * p, size_t num)
+{
+   if (num < 4)
+      return maxScalar(p, num);
+   __m128 best = loadSSE(p);
+   size_t i = 4;
+   for (; i + 4 <= num; i += 4)
+      best = _mm_max_ps(best, loadSSE(p + i));
+   alignas(16) float lanes[4];
+   _mm_store_ps(lanes, best);
+   float value = lanes[maxScalar(lanes, 4)];
+   for (; i < num; i++)
+      if (value < p[i])
+         value = p[i];
+   return findSSE(p, num, value);
+}
+
+// sum
+CUSTOM_TARGET("sse4.2") inline int32_t sumSSE(const int32_t * p, size_t num)
+{
+   __m128i total = _mm_setzero_si128();
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      total = _mm_add_epi32(total, loadSSE(p + i));
+   alignas(16) int32_t lanes[4];
+   _mm_store_si128((__m128i *)lanes, total);
+   return (int32_t)((uint32_t)sumScalar(lanes, 4) + (uint32_t)sumScalar(p, num, i));
+}
+CUSTOM_TARGET("sse4.2") inline float sumSSE(const float * p, size_t num)
+{
+   __m128 total = _mm_setzero_ps();
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      total = _mm_add_ps(total, loadSSE(p + i));
+   alignas(16) float lanes[4];
+   _mm_store_ps(lanes, total);
+   return sumScalar(lanes, 4) + sumScalar(p, num, i);
+}
+CUSTOM_TARGET("sse4.2") inline uint64_t sumSSE(const uint64_t * p, size_t num)
+{
+   __m128i total = _mm_setzero_si128();
+   size_t i = 0;
+   for (; i + 2 <= num; i += 2)
+      total = _mm_add_epi64(total, loadSSE(p + i));
+   alignas(16) uint64_t lanes[2];
+   _mm_store_si128((__m128i *)lanes, total);
+   return sumScalar(lanes, 2) + sumScalar(p, num, i);
+}
+
+// dot
+CUSTOM_TARGET("sse4.2") inline int32_t dotSSE(const int32_t * p1, const int32_t * p2, size_t num)
+{
+   __m128i total = _mm_setzero_si128();
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      total = _mm_add_epi32(total, _mm_mullo_epi32(loadSSE(p1 + i), loadSSE(p2 + i)));
+   alignas(16) int32_t lanes[4];
+   _mm_store_si128((__m128i *)lanes, total);
+   return (int32_t)((uint32_t)sumScalar(lanes, 4) + (uint32_t)dotScalar(p1, p2, num, i));
+}
+CUSTOM_TARGET("sse4.2") inline float dotSSE(const float * p1, const float * p2, size_t num)
+{
+   __m128 total = _mm_setzero_ps();
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+      total = _mm_add_ps(total, _mm_mul_ps(loadSSE(p1 + i), loadSSE(p2 + i)));
+   alignas(16) float lanes[4];
+   _mm_store_ps(lanes, total);
+   return sumScalar(lanes, 4) + dotScalar(p1, p2, num, i);
+}
+
+// mismatch
+CUSTOM_TARGET("sse4.2") inline size_t mismatchSSE(const int32_t * p1, const int32_t * p2, size_t num)
+{
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+   {
+      unsigned mask = maskSSE(equalSSE(loadSSE(p1 + i), loadSSE(p2 + i)));
+      if (mask != 0xF)
+         return i + firstBit(~mask & 0xF);
+   }
+   return mismatchScalar(p1, p2, num, i);
+}
+CUSTOM_TARGET("sse4.2") inline size_t mismatchSSE(const float * p1, const float * p2, size_t num)
+{
+   size_t i = 0;
+   for (; i + 4 <= num; i += 4)
+   {
+      unsigned mask = maskSSE(equalSSE(loadSSE(p1 + i), loadSSE(p2 + i)));
+      if (mask != 0xF)
+         return i + firstBit(~mask & 0xF);
+   }
+   return mismatchScalar(p1, p2, num, i);
+}
+CUSTOM_TARGET("sse4.2") inline size_t mismatchSSE(const uint64_t * p1, const uint64_t * p2, size_t num)
+{
+   size_t i = 0;
+   for (; i + 2 <= num; i += 2)
+   {
+      unsigned mask = mask64SSE(_mm_cmpeq_epi64(loadSSE(p1 + i), loadSSE(p2 + i)));
+      if (mask != 0x3)
+         return i + firstBit(~mask & 0x3);
+   }
+   return mismatchScalar(p1, p2, num, i);
+}
+
+#endif // CUSTOM_SIMD_X86
+
+/*****************************************
+ * DISPATCH
+ * Every type gets the scalar kernels. The types
+ * we have SIMD kernels for get an overload that
+ * picks the best one for this CPU.
+ ****************************************/
+template <typename T>
+size_t find(const T * p, size_t num, const T & value)     { return findScalar(p, num, value); }
+template <typename T>
+size_t count(const T * p, size_t num, const T & value)    { return countScalar(p, num, value); }
+template <typename T>
+size_t min(const T * p, size_t num)                       { return minScalar(p, num); }
+template <typename T>
+size_t max(const T * p, size_t num)                       { return maxScalar(p, num); }
+template <typename T>
+T sum(const T * p, size_t num)                            { return sumScalar(p, num); }
+template <typename T>
+T dot(const T * p1, const T * p2, size_t num)             { return dotScalar(p1, p2, num); }
+template <typename T>
+size_t mismatch(const T * p1, const T * p2, size_t num)   { return mismatchScalar(p1, p2, num); }
+
+#ifdef CUSTOM_SIMD_X86
+#define CUSTOM_SIMD_DISPATCH(scalar, sse, avx2) \
+   switch (level())                            \
+   {                                           \
+      case AVX2:  return avx2;                 \
+      case SSE42: return sse;                  \
+      default:    return scalar;               \
+   }
+#else
+#define CUSTOM_SIMD_DISPATCH(scalar, sse, avx2) \
+   return scalar;
+#endif // CUSTOM_SIMD_X86
+
+inline size_t find(const int32_t * p, size_t num, const int32_t & value)
+{
+   CUSTOM_SIMD_DISPATCH(findScalar(p, num, value), findSSE(p, num, value), findAVX2(p, num, value))
+}
+inline size_t find(const float * p, size_t num, const float & value)
+{
+   CUSTOM_SIMD_DISPATCH(findScalar(p, num, value), findSSE(p, num, value), findAVX2(p, num, value))
+}
+inline size_t find(const uint64_t * p, size_t num, const uint64_t & value)
+{
+   CUSTOM_SIMD_DISPATCH(findScalar(p, num, value), findSSE(p, num, value), findAVX2(p, num, value))
+}
+inline size_t count(const int32_t * p, size_t num, const int32_t & value)
+{
+   CUSTOM_SIMD_DISPATCH(countScalar(p, num, value), countSSE(p, num, value), countAVX2(p, num, value))
+}
+inline size_t count(const float * p, size_t num, const float & value)
+{
+   CUSTOM_SIMD_DISPATCH(countScalar(p, num, value), countSSE(p, num, value), countAVX2(p, num, value))
+}
+inline size_t count(const uint64_t * p, size_t num, const uint64_t & value)
+{
+   CUSTOM_SIMD_DISPATCH(countScalar(p, num, value), countSSE(p, num, value), countAVX2(p, num, value))
+}
+inline size_t min(const int32_t * p, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(minScalar(p, num), minSSE(p, num), minAVX2(p, num))
+}
+inline size_t min(const float * p, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(minScalar(p, num), minSSE(p, num), minAVX2(p, num))
+}
+inline size_t max(const int32_t * p, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(maxScalar(p, num), maxSSE(p, num), maxAVX2(p, num))
+}
+inline size_t max(const float * p, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(maxScalar(p, num), maxSSE(p, num), maxAVX2(p, num))
+}
+inline int32_t sum(const int32_t * p, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(sumScalar(p, num), sumSSE(p, num), sumAVX2(p, num))
+}
+inline float sum(const float * p, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(sumScalar(p, num), sumSSE(p, num), sumAVX2(p, num))
+}
+inline uint64_t sum(const uint64_t * p, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(sumScalar(p, num), sumSSE(p, num), sumAVX2(p, num))
+}
+inline int32_t dot(const int32_t * p1, const int32_t * p2, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(dotScalar(p1, p2, num), dotSSE(p1, p2, num), dotAVX2(p1, p2, num))
+}
+inline float dot(const float * p1, const float * p2, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(dotScalar(p1, p2, num), dotSSE(p1, p2, num), dotAVX2(p1, p2, num))
+}
+inline size_t mismatch(const int32_t * p1, const int32_t * p2, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(mismatchScalar(p1, p2, num), mismatchSSE(p1, p2, num), mismatchAVX2(p1, p2, num))
+}
+inline size_t mismatch(const float * p1, const float * p2, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(mismatchScalar(p1, p2, num), mismatchSSE(p1, p2, num), mismatchAVX2(p1, p2, num))
+}
+inline size_t mismatch(const uint64_t * p1, const uint64_t * p2, size_t num)
+{
+   CUSTOM_SIMD_DISPATCH(mismatchScalar(p1, p2, num), mismatchSSE(p1, p2, num), mismatchAVX2(p1, p2, num))
+}
+
+#undef CUSTOM_SIMD_DISPATCH
+
+} // namespace simd
+
+/*****************************************
+ * FIND
+ * Where is the first element equal to value?
+ ****************************************/
+template <typename T, typename A>
+typename vector <T, A> ::const_iterator find(const vector <T, A> & v, const T & value)
+{
+   return v.empty() ? v.end() : v.begin() + simd::find(&*v.begin(), v.size(), value);
+}
+
+/*****************************************
+ * COUNT and CONTAINS
+ * How many elements equal value? Any at all?
+ ****************************************/
+template <typename T, typename A>
+size_t count(const vector <T, A> & v, const T & value)
+{
+   return v.empty() ? 0 : simd::count(&*v.begin(), v.size(), value);
+}
+template <typename T, typename A>
+bool contains(const vector <T, A> & v, const T & value)
+{
+   return find(v, value) != v.end();
+}
+
+/*****************************************
+ * MIN ELEMENT and MAX ELEMENT
+ * The first smallest or largest element, or
+ * end() if the vector is empty. NaN is not
+ * supported for float.
+ ****************************************/
+template <typename T, typename A>
+typename vector <T, A> ::const_iterator min_element(const vector <T, A> & v)
+{
+   return v.empty() ? v.end() : v.begin() + simd::min(&*v.begin(), v.size());
+}
+template <typename T, typename A>
+typename vector <T, A> ::const_iterator max_element(const vector <T, A> & v)
+{
+   return v.empty() ? v.end() : v.begin() + simd::max(&*v.begin(), v.size());
+}
+
+/*****************************************
+ * SUM and DOT
+ * Add up the elements, or the products of pairs of
+ * elements over the shorter vector. Integers wrap
+ * on overflow; float sums are added in a different
+ * order than a plain loop so rounding can differ.
+ ****************************************/
+template <typename T, typename A>
+T sum(const vector <T, A> & v)
+{
+   return v.empty() ? T() : simd::sum(&*v.begin(), v.size());
+}
+template <typename T, typename A>
+T dot(const vector <T, A> & v1, const vector <T, A> & v2)
+{
+   size_t num = v1.size() < v2.size() ? v1.size() : v2.size();
+   return num == 0 ? T() : simd::dot(&*v1.begin(), &*v2.begin(), num);
+}
+
+/*****************************************
+ * MISMATCH
+ * The first place the two vectors differ, over
+ * the length of the shorter one
+ ****************************************/
+template <typename T, typename A>
+std::pair<typename vector <T, A> ::const_iterator, typename vector <T, A> ::const_iterator>
+mismatch(const vector <T, A> & v1, const vector <T, A> & v2)
+{
+   size_t num = v1.size() < v2.size() ? v1.size() : v2.size();
+   size_t index = num == 0 ? 0 : simd::mismatch(&*v1.begin(), &*v2.begin(), num);
+   return std::make_pair(v1.begin() + index, v2.begin() + index);
+}
+
+} // namespace custom